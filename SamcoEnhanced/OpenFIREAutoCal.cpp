@@ -0,0 +1,103 @@
+ /*!
+ * @file OpenFIREAutoCal.cpp
+ * @brief Background refinement of the LED anchors, to follow a bumped cabinet or sagging lightbar.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREAutoCal is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREAutoCal.h"
+
+AutoCal::AutoCal(int width, int h)
+{
+    centerX = width / 2;
+    height = h;
+}
+
+void AutoCal::Rebase(float tl, float tr)
+{
+    curTL = baseTL = savedTL = tl;
+    curTR = baseTR = tr;
+    windowSum = 0.0f;
+    windowCount = 0;
+    ratio = 0.0f;
+    based = true;
+}
+
+bool AutoCal::Feed(float tl, float tr, float w, float h, bool usable, float &newTL, float &newTR)
+{
+    if(!based || tl != curTL || tr != curTR) {
+        Rebase(tl, tr);
+    }
+    if(!usable || h <= 0.0f) {
+        return false;
+    }
+    float r = w / h;
+    if(r < AUTOCAL_RATIO_MIN || r > AUTOCAL_RATIO_MAX) {
+        return false;
+    }
+    windowSum += r;
+    if(++windowCount < AUTOCAL_WINDOW) {
+        return false;
+    }
+
+    // window's full: fold it into the running estimate
+    float windowRatio = windowSum / AUTOCAL_WINDOW;
+    windowSum = 0.0f;
+    windowCount = 0;
+    if(ratio == 0.0f) {
+        ratio = windowRatio;
+    } else {
+        ratio += (windowRatio - ratio) * 0.25f;
+    }
+
+    // same as calibration: anchors half the LED square's width either side of the middle, assuming height is 100%
+    float targetTL = centerX - (ratio * height) / 2;
+    float delta = targetTL - curTL;
+    if(delta > -AUTOCAL_DEADBAND && delta < AUTOCAL_DEADBAND) {
+        return false;
+    }
+    if(delta > AUTOCAL_STEP) {
+        delta = AUTOCAL_STEP;
+    } else if(delta < -AUTOCAL_STEP) {
+        delta = -AUTOCAL_STEP;
+    }
+    float nextTL = curTL + delta;
+    if(nextTL > baseTL + AUTOCAL_LIMIT) {
+        nextTL = baseTL + AUTOCAL_LIMIT;
+    } else if(nextTL < baseTL - AUTOCAL_LIMIT) {
+        nextTL = baseTL - AUTOCAL_LIMIT;
+    }
+    if(nextTL == curTL) {
+        return false;
+    }
+
+    // TR mirrors TL about the middle, keeping whatever asymmetry calibration had
+    curTR -= nextTL - curTL;
+    curTL = nextTL;
+    newTL = curTL, newTR = curTR;
+    return true;
+}
+
+bool AutoCal::Drifted()
+{
+    float moved = curTL - savedTL;
+    return based && (moved >= AUTOCAL_PERSIST || moved <= -AUTOCAL_PERSIST);
+}
+
+void AutoCal::Persisted()
+{
+    savedTL = curTL;
+}
@@ -0,0 +1,90 @@
+ /*!
+ * @file OpenFIREAutoCal.h
+ * @brief Background refinement of the LED anchors, to follow a bumped cabinet or sagging lightbar.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREAutoCal is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREAUTOCAL_H_
+#define _OPENFIREAUTOCAL_H_
+
+#include <stdint.h>
+
+// Frames averaged per window; about 5 seconds of centered aim at the camera's rate.
+#define AUTOCAL_WINDOW 1024
+// Width/height ratios outside this range are tracking glitches, not geometry.
+#define AUTOCAL_RATIO_MIN 0.5f
+#define AUTOCAL_RATIO_MAX 3.0f
+// Anchor changes smaller than this are left alone, in res_x units (~1.5px); keeps window-to-window noise out.
+#define AUTOCAL_DEADBAND 6.0f
+// Most the anchors move per window, in res_x units (~2px).
+#define AUTOCAL_STEP 8.0f
+// Most the anchors can wander from where calibration put them, in res_x units (~40px);
+// anything past that wants a proper recalibration.
+#define AUTOCAL_LIMIT 160.0f
+// How close the LED square's middle needs to be to the camera center for a frame to count,
+// in camera units << 2 (an eighth of the view either way); off-center views skew the ratio.
+#define AUTOCAL_CENTER_RADIUS 512
+// How far the anchors need to have moved since last saved before they're worth saving again, in res_x units (~4px).
+#define AUTOCAL_PERSIST 16.0f
+
+/// @brief Follows slow changes in the square LED layout's proportions
+/// @details Calibration works the LED anchors (TLled/TRled) out from the width/height ratio of the
+/// LED square, seen once while aimed at the middle of the screen. This keeps watching that ratio
+/// from frames with all four LEDs in view and the aim near the middle, averages it over long windows,
+/// and walks the anchors toward what it says in small, bounded steps.
+/// The camera center offset can't be followed the same way - it needs a known aim point to measure
+/// against, which only calibration has - so that's left as calibrated.
+/// Doesn't touch any hardware or the profile itself, so it can be replayed on a host.
+class AutoCal {
+public:
+    /// @param width,height The output space the anchors live in (res_x, res_y)
+    AutoCal(int width, int height);
+
+    /// @brief Feeds one frame
+    /// @param tl,tr The profile's current anchors; if these change from outside (recalibration,
+    /// profile switch), estimation starts over from them.
+    /// @param w,h Width & height of the LED square as tracked this frame
+    /// @param usable Whether this frame is fit to learn from (all LEDs seen, aim near the middle)
+    /// @return true if the anchors should move, with the new ones in newTL & newTR
+    bool Feed(float tl, float tr, float w, float h, bool usable, float &newTL, float &newTR);
+
+    /// @brief Whether the anchors have moved far enough since last saved to be worth saving
+    bool Drifted();
+
+    /// @brief Marks the current anchors as saved
+    void Persisted();
+
+    // Latest long-run width/height ratio estimate, 0 until the first window fills
+    float ratio = 0.0f;
+
+private:
+    float centerX = 0.0f;
+    float height = 0.0f;
+
+    // anchors as last seen/set, where calibration left them, and as last saved
+    float curTL = 0.0f, curTR = 0.0f;
+    float baseTL = 0.0f, baseTR = 0.0f;
+    float savedTL = 0.0f;
+    bool based = false;
+
+    float windowSum = 0.0f;
+    uint16_t windowCount = 0;
+
+    void Rebase(float tl, float tr);
+};
+
+#endif // _OPENFIREAUTOCAL_H_
@@ -0,0 +1,111 @@
+ /*!
+ * @file OpenFIRECalAssist.cpp
+ * @brief Calibration helpers: paced cursor glides between targets, and steady-aim sampling.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRECalAssist is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIRECalAssist.h"
+
+void CalGlide::Start(uint16_t from_x, uint16_t from_y, uint16_t to_x, uint16_t to_y, uint32_t now)
+{
+    fromX = from_x, fromY = from_y;
+    toX = to_x, toY = to_y;
+    uint16_t distX = toX > fromX ? toX - fromX : fromX - toX;
+    uint16_t distY = toY > fromY ? toY - fromY : fromY - toY;
+    duration = (uint32_t)(distX > distY ? distX : distY) * CALGLIDE_US_PER_UNIT;
+    if(duration < CALGLIDE_MIN) {
+        duration = CALGLIDE_MIN;
+    }
+    startStamp = now;
+    // first position goes out straight away
+    slotStamp = now - CALGLIDE_SLOT;
+    sent = false;
+    active = true;
+}
+
+bool CalGlide::Tick(uint32_t now, bool ready, uint16_t &x, uint16_t &y)
+{
+    if(!active || now - slotStamp < CALGLIDE_SLOT || !ready) {
+        return false;
+    }
+    slotStamp = now;
+
+    uint32_t elapsed = now - startStamp;
+    bool last = elapsed >= duration;
+    uint16_t nextX = toX, nextY = toY;
+    if(!last) {
+        // smoothstep, 16.16: s = t^2 * (3 - 2t)
+        int64_t t = ((uint64_t)elapsed << 16) / duration;
+        int64_t s = (t * t * ((3 << 16) - 2 * t)) >> 32;
+        nextX = fromX + (((int32_t)toX - fromX) * s >> 16);
+        nextY = fromY + (((int32_t)toY - fromY) * s >> 16);
+    }
+    if(last) {
+        active = false;
+    }
+    if(sent && nextX == sentX && nextY == sentY) {
+        return false;
+    }
+    sentX = nextX, sentY = nextY;
+    sent = true;
+    x = nextX, y = nextY;
+    return true;
+}
+
+void CalSteady::Arm(uint32_t now)
+{
+    count = 0;
+    index = 0;
+    armStamp = now;
+    armed = true;
+}
+
+bool CalSteady::Feed(int pos_x, int pos_y, uint32_t now)
+{
+    if(!armed) {
+        return false;
+    }
+    windowX[index] = pos_x;
+    windowY[index] = pos_y;
+    index = (index + 1) % CALSTEADY_FRAMES;
+    if(count < CALSTEADY_FRAMES) {
+        count++;
+        if(count < CALSTEADY_FRAMES) {
+            return false;
+        }
+    }
+
+    int minX = windowX[0], maxX = windowX[0], minY = windowY[0], maxY = windowY[0];
+    int32_t sumX = 0, sumY = 0;
+    for(uint8_t i = 0; i < CALSTEADY_FRAMES; i++) {
+        if(windowX[i] < minX) { minX = windowX[i]; }
+        if(windowX[i] > maxX) { maxX = windowX[i]; }
+        if(windowY[i] < minY) { minY = windowY[i]; }
+        if(windowY[i] > maxY) { maxY = windowY[i]; }
+        sumX += windowX[i];
+        sumY += windowY[i];
+    }
+
+    timedOut = now - armStamp >= CALSTEADY_TIMEOUT;
+    if(!timedOut && (maxX - minX > CALSTEADY_SPREAD || maxY - minY > CALSTEADY_SPREAD)) {
+        return false;
+    }
+    x = sumX / CALSTEADY_FRAMES;
+    y = sumY / CALSTEADY_FRAMES;
+    armed = false;
+    return true;
+}
@@ -0,0 +1,105 @@
+ /*!
+ * @file OpenFIRECalAssist.h
+ * @brief Calibration helpers: paced cursor glides between targets, and steady-aim sampling.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRECalAssist is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIRECALASSIST_H_
+#define _OPENFIRECALASSIST_H_
+
+#include <stdint.h>
+
+// Glide report slot length, in microseconds; matches the 1ms HID polling interval.
+#define CALGLIDE_SLOT 1000
+// Glide time per unit of cursor travel (absolute mouse range), in microseconds.
+// A half-screen move (16384) takes about a quarter second.
+#define CALGLIDE_US_PER_UNIT 16
+// Shortest a glide can take, in microseconds, so tiny hops are still visible.
+#define CALGLIDE_MIN 60000
+
+// Camera frames averaged into a steady aim sample.
+#define CALSTEADY_FRAMES 8
+// Most the aim can wander across those frames and still count as steady, in res_x/res_y units (~3px).
+#define CALSTEADY_SPREAD 12
+// Longest to wait for a steady aim before taking whatever the last frames were, in microseconds.
+#define CALSTEADY_TIMEOUT 1500000
+
+/// @brief Moves the calibration cursor from one target to the next
+/// @details Tick() lets out at most one position per report slot, eased in & out along the way,
+/// so the host sees one smooth move per USB frame instead of hundreds of blocking reports.
+/// Doesn't touch any hardware or clocks itself, so it can be driven with simulated ticks.
+class CalGlide {
+public:
+    /// @brief Starts a glide (positions in the absolute mouse range)
+    /// @param now micros()
+    void Start(uint16_t fromX, uint16_t fromY, uint16_t toX, uint16_t toY, uint32_t now);
+
+    /// @brief Checks whether a new cursor position should go out now
+    /// @param now micros()
+    /// @param ready Whether the endpoint can take a report right now
+    /// @return true if a report should be sent, with its position in x & y
+    bool Tick(uint32_t now, bool ready, uint16_t &x, uint16_t &y);
+
+    /// @brief Whether the glide is still going, i.e. the final position hasn't gone out yet
+    bool Active() { return active; }
+
+private:
+    uint16_t fromX = 0, fromY = 0;
+    uint16_t toX = 0, toY = 0;
+    uint32_t startStamp = 0;
+    uint32_t duration = 0;
+    uint32_t slotStamp = 0;
+    uint16_t sentX = 0, sentY = 0;
+    bool sent = false;
+    bool active = false;
+};
+
+/// @brief Takes an aim sample once the aim's held still
+/// @details Once armed (i.e. on trigger pull), each camera frame is fed in until the last few
+/// have stayed within a small spread, then they're averaged into one sample. This keeps the
+/// jolt of the trigger pull itself, and frame-to-frame jitter, out of the calibration.
+class CalSteady {
+public:
+    /// @brief Starts looking for a steady aim
+    /// @param now micros()
+    void Arm(uint32_t now);
+
+    /// @brief Whether it's still looking for a steady aim
+    bool Armed() { return armed; }
+
+    /// @brief Feeds in a new camera frame's position
+    /// @param now micros()
+    /// @return true once a sample's been taken (in x & y), which also disarms it
+    bool Feed(int pos_x, int pos_y, uint32_t now);
+
+    // last sample taken
+    int x = 0;
+    int y = 0;
+
+    // whether the last sample was taken on timeout, rather than a steady aim
+    bool timedOut = false;
+
+private:
+    int windowX[CALSTEADY_FRAMES];
+    int windowY[CALSTEADY_FRAMES];
+    uint8_t count = 0;
+    uint8_t index = 0;
+    uint32_t armStamp = 0;
+    bool armed = false;
+};
+
+#endif // _OPENFIRECALASSIST_H_
@@ -0,0 +1,52 @@
+ /*!
+ * @file OpenFIREDispatch.cpp
+ * @brief Decides what the second core has to do each time it wakes, instead of it polling everything flat out.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREDispatch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREDispatch.h"
+
+uint8_t Dispatcher::Next(uint32_t now, uint32_t edges, bool settled)
+{
+    uint8_t work = 0;
+    // a button mid-change needs sampling back to back, same as before, until its FIFO agrees
+    if(edges || !settled) {
+        work |= Work_Buttons;
+    }
+    if(now - tickStamp >= DISPATCH_TICK) {
+        if(now - tickStamp < DISPATCH_TICK * 2) {
+            tickStamp += DISPATCH_TICK;
+        } else {
+            // fell more than a tick behind, so don't try to catch up with a burst
+            tickStamp = now;
+        }
+        // debounce counters run out by time, and held buttons still need their feedback timed
+        work |= Work_Tick | Work_Buttons;
+    }
+    return work;
+}
+
+uint32_t Dispatcher::Remaining(uint32_t now) const
+{
+    uint32_t elapsed = now - tickStamp;
+    return elapsed >= DISPATCH_TICK ? 0 : DISPATCH_TICK - elapsed;
+}
+
+void Dispatcher::Reset(uint32_t now)
+{
+    tickStamp = now;
+}
@@ -0,0 +1,58 @@
+ /*!
+ * @file OpenFIREDispatch.h
+ * @brief Decides what the second core has to do each time it wakes, instead of it polling everything flat out.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREDispatch is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREDISPATCH_H_
+#define _OPENFIREDISPATCH_H_
+
+#include <stdint.h>
+
+// Tick length, in microseconds; the buttons' debounce counters, feedback timers & the USB frame all go by 1ms.
+#define DISPATCH_TICK 1000
+
+/// @brief Second core's event dispatcher
+/// @details The second core sleeps until something wakes it (a button pin's interrupt, or the tick's deadline),
+/// then asks Next() what's due. Button pins changing or still settling get polled right away; everything that
+/// goes by time (feedback, serial, analog stick, held buttons) runs once per tick.
+/// Doesn't touch any hardware or clocks itself, so it can be driven with simulated events.
+class Dispatcher {
+public:
+    enum Work_e {
+        Work_Buttons = 1 << 0,      // Poll the buttons & act on any change
+        Work_Tick = 1 << 1          // Timed work: feedback, serial, analog stick
+    };
+
+    /// @brief Works out what's due
+    /// @param now micros()
+    /// @param edges Button pin changes since the last call
+    /// @param settled Whether the buttons are settled (see LightgunButtons::Settled())
+    /// @return Work_e flags; 0 if there's nothing to do until an edge or the next tick
+    uint8_t Next(uint32_t now, uint32_t edges, bool settled);
+
+    /// @brief Microseconds until the next tick's due, to sleep at most that long
+    uint32_t Remaining(uint32_t now) const;
+
+    /// @brief Starts the ticks over, e.g. when coming back into run mode
+    void Reset(uint32_t now);
+
+private:
+    uint32_t tickStamp = 0;
+};
+
+#endif // _OPENFIREDISPATCH_H_
@@ -0,0 +1,44 @@
+ /*!
+ * @file OpenFIREEvents.cpp
+ * @brief Lightweight event counters for handing things like shots between subsystems.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREEvents is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREEvents.h"
+
+volatile uint32_t Events::counts[Event_Count] = {0};
+
+Events::Subscriber::Subscriber()
+{
+    Clear();
+}
+
+uint32_t Events::Subscriber::Take(Events_e event)
+{
+    // unsigned subtraction keeps this right when the counter wraps
+    uint32_t now = counts[event];
+    uint32_t pending = now - seen[event];
+    seen[event] = now;
+    return pending;
+}
+
+void Events::Subscriber::Clear()
+{
+    for(uint8_t i = 0; i < Event_Count; i++) {
+        seen[i] = counts[i];
+    }
+}
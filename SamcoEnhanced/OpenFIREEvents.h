@@ -0,0 +1,63 @@
+ /*!
+ * @file OpenFIREEvents.h
+ * @brief Lightweight event counters for handing things like shots between subsystems.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREEvents is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREEVENTS_H_
+#define _OPENFIREEVENTS_H_
+
+#include <stdint.h>
+
+/// @brief Event bus
+/// @details Publishing just bumps a counter, so it's safe to do from timing-critical paths (e.g. the solenoid)
+/// and from either core. Each listener keeps its own Subscriber, so any number of them can see the same event
+/// without stealing it from one another, and nothing is lost if a listener only checks in every few ms.
+/// Each event should only be published from one core at a time, as the counters aren't atomic.
+class Events {
+public:
+    enum Events_e {
+        Event_Shot = 0,         // Solenoid engaged (or rumble fallback fired) by the gun's own feedback
+        Event_SerialShot,       // Solenoid engaged by a Mamehook command
+        Event_ButtonEdge,       // A button pin changed (from its interrupt, on the second core)
+        Event_Count
+    };
+
+    /// @brief Signals that an event has happened
+    static void Publish(Events_e event) { counts[event] = counts[event] + 1; }
+
+    /// @brief Per-listener view of the event counters
+    class Subscriber {
+    public:
+        /// @brief Starts from the current counts, so events from before subscribing aren't seen
+        Subscriber();
+
+        /// @brief Gets how many times an event happened since this was last checked
+        uint32_t Take(Events_e event);
+
+        /// @brief Drops anything pending, e.g. when the listener's been off for a while
+        void Clear();
+
+    private:
+        uint32_t seen[Event_Count];
+    };
+
+private:
+    static volatile uint32_t counts[Event_Count];
+};
+
+#endif // _OPENFIREEVENTS_H_
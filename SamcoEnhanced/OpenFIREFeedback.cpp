@@ -19,6 +19,7 @@
  */ 
 
 #include <Arduino.h>
+#include "OpenFIREEvents.h"
 #include "OpenFIREFeedback.h"
 #include "SamcoPreferences.h"
 
@@ -75,6 +76,7 @@ void FFB::FFBOnScreen()
     // only activate rumbleFF as a fallback if Solenoid is explicitly disabled
     } else if(SamcoPreferences::toggles.rumbleActive &&
               SamcoPreferences::toggles.rumbleFF && !rumbleHappened && !triggerHeld) {
+        Events::Publish(Events::Event_Shot);
         RumbleActivation();
     }
     if(SamcoPreferences::toggles.rumbleActive &&  // Is rumble activated,
@@ -132,6 +134,7 @@ void FFB::SolenoidActivation(int solenoidFinalInterval)
     if(solenoidFirstShot) {                                       // If this is the first time we're shooting, it's probably safe to shoot regardless of temps.
         previousMillisSol = millis();                             // Calibrate the timer for future calcs.
         digitalWrite(SamcoPreferences::pins.oSolenoid, HIGH);     // Since we're shooting the first time, just turn it on aaaaand fire.
+        Events::Publish(Events::Event_Shot);
     } else {
         if(SamcoPreferences::pins.aTMP36 >= 0) { // If a temp sensor is installed and enabled,
             TemperatureUpdate();
@@ -141,18 +144,18 @@ void FFB::SolenoidActivation(int solenoidFinalInterval)
                     if(digitalRead(SamcoPreferences::pins.oSolenoid)) {    // Is the valve being pulled now?
                         if(currentMillis - previousMillisSol >= solenoidFinalInterval) {
                             previousMillisSol = currentMillis;
-                            digitalWrite(SamcoPreferences::pins.oSolenoid, !digitalRead(SamcoPreferences::pins.oSolenoid)); // Flip, flop.
+                            SolenoidToggle();                               // Flip, flop.
                         }
                     } else { // The solenoid's probably off, not on right now. So that means we should wait a bit longer to fire again.
                         if(currentMillis - previousMillisSol >= solenoidWarningInterval) { // We're keeping it low for a bit longer, to keep temps stable. Try to give it a bit of time to cool down before we go again.
                             previousMillisSol = currentMillis;
-                            digitalWrite(SamcoPreferences::pins.oSolenoid, !digitalRead(SamcoPreferences::pins.oSolenoid));
+                            SolenoidToggle();
                         }
                     }
                 } else {
                     if(currentMillis - previousMillisSol >= solenoidFinalInterval) {
                         previousMillisSol = currentMillis;
-                        digitalWrite(SamcoPreferences::pins.oSolenoid, !digitalRead(SamcoPreferences::pins.oSolenoid)); // run the solenoid into the state we've just inverted it to.
+                        SolenoidToggle();                                   // run the solenoid into the state we've just inverted it to.
                     }
                 }
             } else {
@@ -165,12 +168,21 @@ void FFB::SolenoidActivation(int solenoidFinalInterval)
             currentMillis = millis();
             if(currentMillis - previousMillisSol >= solenoidFinalInterval) { // If we've waited long enough for this interval,
                 previousMillisSol = currentMillis;                    // Since we've waited long enough, calibrate the timer
-                digitalWrite(SamcoPreferences::pins.oSolenoid, !digitalRead(SamcoPreferences::pins.oSolenoid)); // run the solenoid into the state we've just inverted it to.
+                SolenoidToggle();                                     // run the solenoid into the state we've just inverted it to.
             }
         }
     }
 }
 
+void FFB::SolenoidToggle()
+{
+    bool engage = !digitalRead(SamcoPreferences::pins.oSolenoid);
+    digitalWrite(SamcoPreferences::pins.oSolenoid, engage);
+    if(engage) {
+        Events::Publish(Events::Event_Shot);
+    }
+}
+
 void FFB::TemperatureUpdate()
 {
     currentMillis = millis();
@@ -61,6 +61,9 @@ public:
     uint8_t temperatureCurrent;
 
 private:
+    /// @brief Flips the solenoid, signalling a shot whenever it engages
+    void SolenoidToggle();
+
     // For solenoid:
     bool solenoidFirstShot = false;            // default to off, but set this on the first time we shoot.
 
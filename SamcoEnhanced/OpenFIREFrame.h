@@ -0,0 +1,60 @@
+ /*!
+ * @file OpenFIREFrame.h
+ * @brief One camera frame's trip through the positioning pipeline, as a single plain record.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREFrame is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREFRAME_H_
+#define _OPENFIREFRAME_H_
+
+#include <stdint.h>
+#include <type_traits>
+
+/// @brief Everything the pipeline works out from one camera frame
+/// @details Each stage fills in its own part, in order: read (timestamp, raw points & seen mask),
+/// solve (corners & warp), filter (run mode averaging), then output (calibration, offsets & HID range).
+/// Plain data only, so it can be copied whole into a queue, a log or a telemetry record,
+/// and handed from one core to the other.
+typedef struct FrameSample_s {
+    uint32_t timestamp;         ///< micros() at the start of the camera read
+    int16_t rawX[4];            ///< Camera points, or both cameras' fused (camera res; can run past it with a second camera)
+    int16_t rawY[4];
+    uint8_t seen;               ///< Camera seen bit mask (bits 0-3)
+    uint8_t layout;             ///< 0 = square, 1 = diamond
+    uint8_t offScreen;          ///< Whether the HID position's pinned to an edge
+    uint8_t reserved;
+    int16_t cornerX[4];         ///< Solved LED positions from the square/diamond tracker (camera res << 2)
+    int16_t cornerY[4];
+    int32_t warpX;              ///< Perspective output (res_x/res_y space; aimed well off screen, can run far past it)
+    int32_t warpY;
+    int32_t filteredX;          ///< After the grid fit if any, then run mode averaging (res_x/res_y space)
+    int32_t filteredY;
+    int32_t outX;               ///< After offsets & mouse resolution, unclamped (0-32767 is on screen)
+    int32_t outY;
+    uint16_t hidX;              ///< What goes out to the host (0-32767)
+    uint16_t hidY;
+    uint16_t timeCam;           ///< Time spent reading the camera, in microseconds
+    uint16_t timeSolve;         ///< Time spent in the square/diamond tracker, in microseconds
+    uint16_t timeWarp;          ///< Time spent in the perspective warp, in microseconds
+    uint16_t timeFilter;        ///< Time spent in the grid fit, averaging & output mapping, in microseconds
+} FrameSample_t;
+
+static_assert(std::is_trivially_copyable<FrameSample_t>::value && std::is_standard_layout<FrameSample_t>::value,
+              "FrameSample_t has to stay plain data, to be passed around by value");
+static_assert(sizeof(FrameSample_t) == 76, "FrameSample_t layout changed");
+
+#endif // _OPENFIREFRAME_H_
@@ -0,0 +1,139 @@
+ /*!
+ * @file OpenFIRELights.cpp
+ * @brief Timed LED effects, rendered without blocking the main loop.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRELights is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIRELights.h"
+#include "SamcoColours.h"
+
+void Lights::Set(uint32_t newColor, uint8_t what)
+{
+    baseColor = newColor;
+    effect = Effect_Solid;
+    if(what == Set_Whole) {
+        gauge = LIGHTS_GAUGE_OFF;
+    }
+}
+
+bool Lights::Take()
+{
+    uint32_t count = postCount;
+    if(count == takenCount) {
+        return false;
+    }
+    // read after the count: if another post lands in between, this gets that one, and the next Take() just sets it again
+    uint32_t word = posted;
+    takenCount = count;
+    Set(word & 0xFFFFFF, word >> 24);
+    return true;
+}
+
+void Lights::Blink(uint32_t newColor, uint8_t newCount, uint16_t newOnTime, uint16_t newOffTime, unsigned long now)
+{
+    if(!newCount || !(newOnTime + newOffTime)) {
+        return;
+    }
+    effect = Effect_Blink;
+    effectColor = newColor;
+    count = newCount;
+    onTime = newOnTime;
+    offTime = newOffTime;
+    effectStart = now;
+}
+
+void Lights::Pulse(uint32_t newColor, uint16_t period, unsigned long now)
+{
+    if(period < 2) {
+        return;
+    }
+    effect = Effect_Pulse;
+    effectColor = newColor;
+    onTime = period;
+    effectStart = now;
+}
+
+void Lights::Flash(uint32_t newColor, uint16_t length, unsigned long now)
+{
+    flashColor = newColor;
+    flashLength = length;
+    flashStart = now;
+}
+
+void Lights::Gauge(uint8_t lit)
+{
+    gauge = lit;
+}
+
+bool Lights::Render(unsigned long now)
+{
+    uint32_t out = baseColor;
+    unsigned long elapsed = now - effectStart;
+
+    switch(effect) {
+    case Effect_Blink:
+    {
+        unsigned long cycle = onTime + offTime;
+        if(elapsed >= cycle * count) {
+            // done, back to the solid color
+            effect = Effect_Solid;
+        } else if(elapsed % cycle < onTime) {
+            out = effectColor;
+        } else {
+            out = 0;
+        }
+        break;
+    }
+    case Effect_Pulse:
+    {
+        // triangle wave, dark -> full -> dark over each period
+        unsigned long phase = elapsed % onTime;
+        unsigned long half = onTime / 2;
+        uint8_t level = phase < half ? phase * 255 / half : (onTime - phase) * 255 / (onTime - half);
+        out = COLOR_BRI_ADJ_RGB(level, effectColor);
+        break;
+    }
+    default:
+        break;
+    }
+
+    if(flashLength) {
+        unsigned long flashElapsed = now - flashStart;
+        if(flashElapsed < flashLength) {
+            uint8_t level = 255 - flashElapsed * 255 / flashLength;
+            uint32_t flash = COLOR_BRI_ADJ_RGB(level, flashColor);
+            // brightest of each channel, so a flash shows up over both dark & lit LEDs
+            uint32_t mixed = 0;
+            for(uint8_t shift = 0; shift < 32; shift += 8) {
+                uint32_t a = (out >> shift) & 0xFF;
+                uint32_t b = (flash >> shift) & 0xFF;
+                mixed |= (a > b ? a : b) << shift;
+            }
+            out = mixed;
+        } else {
+            flashLength = 0;
+        }
+    }
+
+    if(rendered && out == color && gauge == gaugeLit) {
+        return false;
+    }
+    color = out;
+    gaugeLit = gauge;
+    rendered = true;
+    return true;
+}
@@ -0,0 +1,112 @@
+ /*!
+ * @file OpenFIRELights.h
+ * @brief Timed LED effects, rendered without blocking the main loop.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRELights is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIRELIGHTS_H_
+#define _OPENFIRELIGHTS_H_
+
+#include <stdint.h>
+
+// Gauge value for "not showing a gauge", the strip is filled with the current color instead.
+#define LIGHTS_GAUGE_OFF 0xFF
+
+/// @brief LED effect state & renderer
+/// @details This only works out what color the LEDs should be at a given time - it doesn't touch any hardware,
+/// so the sketch decides how and when to push a frame out (and effect timing can be checked anywhere by calling Render()).
+/// Everything but Post() belongs to the main core, which is the only one that renders & shows frames.
+class Lights {
+public:
+    enum Effect_e {
+        Effect_Solid = 0,
+        Effect_Blink,
+        Effect_Pulse
+    };
+
+    enum Set_e {
+        Set_Color = 0,              // Just the color
+        Set_Whole                   // The color, and back to lighting the whole strip
+    };
+
+    /// @brief Sets a solid color, cancelling any blink/pulse
+    /// @details This is also the color blinks return to when they finish.
+    /// @param what Set_e
+    void Set(uint32_t color, uint8_t what = Set_Color);
+
+    /// @brief Hands a Set() over from the second core, for the main core's next Take()
+    /// @details The second core only ever writes the packed word & then the count, and nothing else writes either,
+    /// so there's no lock; only the latest post is kept, which is all a solid color needs.
+    void Post(uint32_t color, uint8_t what = Set_Color) {
+        posted = ((uint32_t)what << 24) | (color & 0xFFFFFF);
+        postCount = postCount + 1;
+    }
+
+    /// @brief Applies the latest Post(), if there's been one since the last Take()
+    /// @return true if there was one
+    bool Take();
+
+    /// @brief Blinks a color on & off a number of times, then returns to the solid color
+    void Blink(uint32_t color, uint8_t count, uint16_t onTime, uint16_t offTime, unsigned long now);
+
+    /// @brief Fades a color in & out continuously, until the next Set()
+    void Pulse(uint32_t color, uint16_t period, unsigned long now);
+
+    /// @brief Flashes a color over whatever else is showing, fading out over length ms
+    void Flash(uint32_t color, uint16_t length, unsigned long now);
+
+    /// @brief Sets how many strip pixels should be lit, or LIGHTS_GAUGE_OFF to light all of them
+    void Gauge(uint8_t lit);
+
+    /// @brief Forces the next Render() to produce a frame, e.g. after the LEDs were re-initialized
+    void Refresh() { rendered = false; }
+
+    /// @brief Works out the frame for this point in time
+    /// @return true if it differs from the last frame rendered, i.e. it needs to be shown
+    bool Render(unsigned long now);
+
+    // Rendered color for every LED (and the lit part of the strip), valid after Render()
+    uint32_t color = 0;
+
+    // Rendered strip gauge, valid after Render()
+    uint8_t gaugeLit = LIGHTS_GAUGE_OFF;
+
+private:
+    Effect_e effect = Effect_Solid;
+    uint32_t baseColor = 0;
+    uint32_t effectColor = 0;
+    unsigned long effectStart = 0;
+    uint16_t onTime = 0;
+    uint16_t offTime = 0;
+    uint8_t count = 0;
+
+    uint32_t flashColor = 0;
+    unsigned long flashStart = 0;
+    uint16_t flashLength = 0;
+
+    uint8_t gauge = LIGHTS_GAUGE_OFF;
+
+    // whether color/gaugeLit hold a frame that's actually been rendered yet
+    bool rendered = false;
+
+    // handed over by Post(): Set_e << 24 | color, and how many posts there's been
+    volatile uint32_t posted = 0;
+    volatile uint32_t postCount = 0;
+    uint32_t takenCount = 0;
+};
+
+#endif // _OPENFIRELIGHTS_H_
@@ -0,0 +1,119 @@
+ /*!
+ * @file OpenFIREPacer.cpp
+ * @brief Paces pointer reports to the USB polling rate, rather than the camera's.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPacer is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREPacer.h"
+
+void Pacer::Sample(uint16_t x, uint16_t y, uint32_t stamp)
+{
+    sampleX[0] = sampleX[1], sampleY[0] = sampleY[1], sampleStamp[0] = sampleStamp[1];
+    sampleX[1] = x, sampleY[1] = y, sampleStamp[1] = stamp;
+    if(samples < 2) {
+        samples++;
+    }
+}
+
+bool Pacer::Tick(uint32_t now, bool ready, uint16_t &x, uint16_t &y)
+{
+    if(!slotStarted) {
+        slotStamp = now;
+        windowStamp = now;
+        slotStarted = true;
+    } else if(now - slotStamp < PACER_SLOT) {
+        return false;
+    } else if(now - slotStamp < PACER_SLOT * 2) {
+        slotStamp += PACER_SLOT;
+    } else {
+        // fell more than a slot behind, so don't try to catch up with a burst
+        slotStamp = now;
+    }
+
+    if(now - windowStamp >= 1000000) {
+        stats.reports = windowReports;
+        stats.dropped = windowDropped;
+        stats.ageAvg = windowReports ? windowAgeSum / windowReports : 0;
+        stats.ageMax = windowAgeMax;
+        windowStamp = now;
+        windowReports = 0, windowDropped = 0, windowAgeSum = 0, windowAgeMax = 0;
+    }
+
+    if(!samples) {
+        return false;
+    }
+
+    uint16_t nextX = sampleX[1];
+    uint16_t nextY = sampleY[1];
+    if(predict && samples > 1) {
+        nextX = Predict(sampleX, now);
+        nextY = Predict(sampleY, now);
+    }
+
+    if(sent && nextX == sentX && nextY == sentY) {
+        return false;
+    }
+    if(!ready) {
+        // try again next slot, with whatever's newest by then
+        windowDropped++;
+        return false;
+    }
+
+    sentX = nextX, sentY = nextY;
+    sent = true;
+    x = nextX, y = nextY;
+
+    uint32_t age = now - sampleStamp[1];
+    if(age > 0xFFFF) {
+        age = 0xFFFF;
+    }
+    windowReports++;
+    windowAgeSum += age;
+    if(age > windowAgeMax) {
+        windowAgeMax = age;
+    }
+    return true;
+}
+
+uint16_t Pacer::Predict(const uint16_t *pos, uint32_t now)
+{
+    uint32_t span = sampleStamp[1] - sampleStamp[0];
+    if(!span || span > PACER_PREDICT_MAX) {
+        return pos[1];
+    }
+    // never run further ahead than one camera frame past the newest sample
+    uint32_t ahead = now - sampleStamp[1];
+    if(ahead > span) {
+        ahead = span;
+    }
+    int32_t predicted = pos[1] + ((int32_t)pos[1] - pos[0]) * (int32_t)ahead / (int32_t)span;
+    if(predicted < 0) {
+        return 0;
+    } else if(predicted > PACER_POS_MAX) {
+        return PACER_POS_MAX;
+    }
+    return predicted;
+}
+
+void Pacer::Reset()
+{
+    samples = 0;
+    sent = false;
+    slotStarted = false;
+    windowReports = 0, windowDropped = 0, windowAgeSum = 0, windowAgeMax = 0;
+    stats = {};
+}
@@ -0,0 +1,93 @@
+ /*!
+ * @file OpenFIREPacer.h
+ * @brief Paces pointer reports to the USB polling rate, rather than the camera's.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPacer is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREPACER_H_
+#define _OPENFIREPACER_H_
+
+#include <stdint.h>
+
+// Report slot length, in microseconds; matches the 1ms HID polling interval.
+#define PACER_SLOT 1000
+// Longest gap between camera samples that's still predicted across, in microseconds.
+// Anything longer (e.g. the camera lost sight of the LEDs for a bit) just repeats the last sample.
+#define PACER_PREDICT_MAX 20000
+// Pointer positions are in the absolute mouse range.
+#define PACER_POS_MAX 32767
+
+/// @brief Pointer report pacing, over the last full second
+typedef struct PacerStats_s {
+    uint16_t reports;           ///< Reports sent
+    uint16_t dropped;           ///< Slots skipped because the endpoint was still busy with the last report
+    uint16_t ageAvg;            ///< Average age of the camera sample behind each report, in microseconds
+    uint16_t ageMax;            ///< Oldest camera sample behind a report, in microseconds
+} PacerStats_t;
+
+/// @brief Decides when pointer reports go out, and what goes in them
+/// @details Camera samples come in at the camera's rate, and Tick() is called as often as the main loop can;
+/// at most one report is let out per slot, and only when the position has actually changed.
+/// With prediction on, the position between camera frames is extrapolated from the last two samples,
+/// so the cursor keeps moving at the polling rate instead of stepping at the camera's.
+/// Doesn't touch any hardware or clocks itself, so it can be driven with simulated ticks.
+class Pacer {
+public:
+    /// @brief Hands over a new camera sample
+    /// @param stamp micros() when the sample was taken
+    void Sample(uint16_t x, uint16_t y, uint32_t stamp);
+
+    /// @brief Checks whether a report should go out now
+    /// @param now micros()
+    /// @param ready Whether the endpoint can take a report right now
+    /// @return true if a report should be sent, with its position in x & y
+    bool Tick(uint32_t now, bool ready, uint16_t &x, uint16_t &y);
+
+    /// @brief Forgets all samples & stats, e.g. when coming back into run mode
+    void Reset();
+
+    // Whether to extrapolate between camera samples
+    bool predict = false;
+
+    // Stats for the last full second
+    PacerStats_t stats = {};
+
+private:
+    uint16_t sampleX[2] = {0};
+    uint16_t sampleY[2] = {0};
+    uint32_t sampleStamp[2] = {0};
+    // samples held (up to 2)
+    uint8_t samples = 0;
+
+    uint16_t sentX = 0;
+    uint16_t sentY = 0;
+    bool sent = false;
+
+    uint32_t slotStamp = 0;
+    bool slotStarted = false;
+
+    // current window's counters, moved into stats every second
+    uint32_t windowStamp = 0;
+    uint16_t windowReports = 0;
+    uint16_t windowDropped = 0;
+    uint32_t windowAgeSum = 0;
+    uint16_t windowAgeMax = 0;
+
+    uint16_t Predict(const uint16_t *pos, uint32_t now);
+};
+
+#endif // _OPENFIREPACER_H_
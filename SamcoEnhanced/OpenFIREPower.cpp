@@ -0,0 +1,76 @@
+ /*!
+ * @file OpenFIREPower.cpp
+ * @brief Slows the camera & sleeps the cores while a battery-powered gun isn't being used.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPower is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREPower.h"
+
+void PowerSaver::Reset(uint32_t now)
+{
+    poked = false;
+    level = Level_Active;
+    activeStamp = now;
+}
+
+bool PowerSaver::Update(uint32_t now)
+{
+    uint8_t was = level;
+    // a poke that lands between the check & the clear is still taken, since this one just was
+    if(poked) {
+        poked = false;
+        activeStamp = now;
+        level = Level_Active;
+    } else if(now - activeStamp >= POWER_DOZE_DELAY) {
+        level = Level_Doze;
+    } else if(now - activeStamp >= POWER_IDLE_DELAY) {
+        level = Level_Idle;
+    }
+    return level != was;
+}
+
+unsigned int PowerSaver::Rate(unsigned int full) const
+{
+    switch(level) {
+    case Level_Idle:
+        return POWER_IDLE_RATE;
+    case Level_Doze:
+        return POWER_DOZE_RATE;
+    default:
+        return full;
+    }
+}
+
+bool PowerSaver::BatteryDue(uint32_t now)
+{
+    if(batteryRead && now - batteryStamp < POWER_BATTERY_INTERVAL) {
+        return false;
+    }
+    batteryStamp = now;
+    batteryRead = true;
+    return true;
+}
+
+void PowerSaver::BatterySample(uint16_t millivolts)
+{
+    // the pin's noisy under solenoid & rumble load, so ease towards each reading rather than jump to it
+    if(!battery) {
+        battery = millivolts;
+    } else {
+        battery = (battery * 7 + millivolts + 4) / 8;
+    }
+}
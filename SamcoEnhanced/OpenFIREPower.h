@@ -0,0 +1,92 @@
+ /*!
+ * @file OpenFIREPower.h
+ * @brief Slows the camera & sleeps the cores while a battery-powered gun isn't being used.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPower is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREPOWER_H_
+#define _OPENFIREPOWER_H_
+
+#include <stdint.h>
+
+// Time without any LEDs seen or buttons touched before the camera's slowed down, in milliseconds.
+#define POWER_IDLE_DELAY 2000
+// ...and before it's slowed down further, in milliseconds.
+#define POWER_DOZE_DELAY 30000
+// Camera rates while idle & dozing, in Hz; the first frame that sees an LED brings back the full rate.
+#define POWER_IDLE_RATE 30
+#define POWER_DOZE_RATE 10
+// Button polling interval while asleep, in microseconds; matches the buttons' debounce interval.
+#define POWER_POLL_INTERVAL 1000
+// Time between battery readings, in milliseconds.
+#define POWER_BATTERY_INTERVAL 1000
+
+/// @brief Decides how fast the camera's read, and whether the cores can sleep between frames
+/// @details Activity is anything the player does: an LED in view, or a button changed or held.
+/// After a while without any, the camera's read less and less often; the moment there's any again,
+/// it's back to the full rate. Poke() can come from either core, and battery readings from whichever core
+/// polls the analog pins; everything else is for the main core.
+/// Doesn't touch any hardware or clocks itself, so it can be driven with simulated traces.
+class PowerSaver {
+public:
+    enum Level_e {
+        Level_Active = 0,
+        Level_Idle,
+        Level_Doze
+    };
+
+    /// @brief Back to full rate, e.g. when coming back into run mode
+    void Reset(uint32_t now);
+
+    /// @brief Marks activity; safe to call from the other core
+    void Poke() { poked = true; }
+
+    /// @brief Catches up with pokes & the time since the last one
+    /// @param now millis()
+    /// @return true if the level changed, and so the camera's rate with it
+    bool Update(uint32_t now);
+
+    /// @brief Camera rate for the current level
+    /// @param full The camera's rate while active
+    unsigned int Rate(unsigned int full) const;
+
+    /// @brief Current level, as Level_e
+    uint8_t Level() const { return level; }
+
+    /// @brief Whether there's been no activity for a while, so the cores can sleep between polls
+    bool Asleep() const { return level != Level_Active; }
+
+    /// @brief Checks whether a battery reading is due
+    /// @param now millis()
+    bool BatteryDue(uint32_t now);
+
+    /// @brief Hands over a battery reading, in millivolts at the pin
+    void BatterySample(uint16_t millivolts);
+
+    // Battery voltage at the pin, smoothed over the last several readings, in millivolts; 0 until read
+    uint16_t battery = 0;
+
+private:
+    volatile bool poked = false;
+    volatile uint8_t level = Level_Active;
+    uint32_t activeStamp = 0;
+
+    uint32_t batteryStamp = 0;
+    bool batteryRead = false;
+};
+
+#endif // _OPENFIREPOWER_H_
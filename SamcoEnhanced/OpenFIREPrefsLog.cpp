@@ -0,0 +1,365 @@
+ /*!
+ * @file OpenFIREPrefsLog.cpp
+ * @brief Log-structured preferences store, spread over two flash sectors.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPrefsLog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "OpenFIREPrefsLog.h"
+#include <stddef.h>
+#include <string.h>
+
+static_assert(PREFS_SECTOR_SIZE % PREFS_PAGE_SIZE == 0, "Sectors have to be a whole number of pages!");
+static_assert(PREFS_LOG_SECTORS >= 2, "The log needs a second sector to compact into!");
+
+// CRC-16/CCITT (poly 0x1021)
+static uint16_t PrefsCrc16(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while(length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for(uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool PrefsBlank(const uint8_t *data, uint32_t length)
+{
+    while(length--) {
+        if(*data++ != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PrefsLog::PageWriter::PageWriter(PrefsFlash &flashStore, uint32_t start) : flash(flashStore), offset(start)
+{
+    memset(page, 0xFF, sizeof(page));
+}
+
+void PrefsLog::PageWriter::Put(const void *data, uint16_t length)
+{
+    const uint8_t *p = (const uint8_t*)data;
+    while(length) {
+        uint16_t at = offset % PREFS_PAGE_SIZE;
+        uint16_t count = PREFS_PAGE_SIZE - at;
+        if(count > length) {
+            count = length;
+        }
+        memcpy(page + at, p, count);
+        p += count;
+        length -= count;
+        offset += count;
+        if(offset % PREFS_PAGE_SIZE == 0) {
+            ok = flash.Program(offset - PREFS_PAGE_SIZE, page) && ok;
+            memset(page, 0xFF, sizeof(page));
+        }
+    }
+}
+
+bool PrefsLog::PageWriter::Finish()
+{
+    // bytes before the start of the first page were left at 0xFF, which programs over whatever's there unchanged
+    if(offset % PREFS_PAGE_SIZE) {
+        ok = flash.Program(offset - offset % PREFS_PAGE_SIZE, page) && ok;
+    }
+    return ok;
+}
+
+uint16_t PrefsLog::Crc(const RecordHeader_t &header, const uint8_t *payload)
+{
+    uint16_t crc = PrefsCrc16(0xFFFF, (const uint8_t*)&header, offsetof(RecordHeader_t, crc));
+    return PrefsCrc16(crc, payload, header.length);
+}
+
+bool PrefsLog::SectorValid(uint8_t sector, uint32_t &gen)
+{
+    SectorHeader_t header;
+    memcpy(&header, flash.Data() + sector * PREFS_SECTOR_SIZE, sizeof(header));
+    gen = header.generation;
+    return header.magic == Magic && header.check == ~header.generation;
+}
+
+void PrefsLog::Begin()
+{
+    memset(newest, 0, sizeof(newest));
+    active = -1;
+    generation = 0;
+    sequence = 0;
+    writeOffset = 0;
+    dirty = false;
+
+    uint32_t gen;
+    for(uint8_t s = 0; s < PREFS_LOG_SECTORS; ++s) {
+        if(SectorValid(s, gen) && (active < 0 || gen > generation)) {
+            active = s;
+            generation = gen;
+        }
+    }
+    // an older sector's still scanned, in case a record in the newer one's gone bad since
+    for(uint8_t s = 0; s < PREFS_LOG_SECTORS; ++s) {
+        if(SectorValid(s, gen)) {
+            Scan(s);
+        }
+    }
+}
+
+void PrefsLog::Scan(uint8_t sector)
+{
+    const uint8_t *base = flash.Data() + sector * PREFS_SECTOR_SIZE;
+    uint32_t offset = sizeof(SectorHeader_t);
+    bool torn = false;
+    // records of the commit being read, which only count once its last one's been found
+    Newest_t batch[PREFS_LOG_TYPES] = {};
+    bool open = false;
+
+    while(offset + sizeof(RecordHeader_t) <= PREFS_SECTOR_SIZE) {
+        if(PrefsBlank(base + offset, sizeof(RecordHeader_t))) {
+            break;
+        }
+        RecordHeader_t header;
+        memcpy(&header, base + offset, sizeof(header));
+        if(!header.type || header.type >= PREFS_LOG_TYPES || offset + RecordSize(header.length) > PREFS_SECTOR_SIZE ||
+           Crc(header, base + offset + sizeof(header)) != header.crc) {
+            // nothing's ever written after a bad record, so this is where the last commit was cut short
+            torn = true;
+            break;
+        }
+        batch[header.type].offset = sector * PREFS_SECTOR_SIZE + offset;
+        batch[header.type].sequence = header.sequence;
+        open = true;
+        if(header.flags & Flag_Last) {
+            for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+                if(batch[t].offset && (!newest[t].offset || batch[t].sequence > newest[t].sequence)) {
+                    newest[t] = batch[t];
+                }
+            }
+            memset(batch, 0, sizeof(batch));
+            open = false;
+        }
+        if(header.sequence > sequence) {
+            sequence = header.sequence;
+        }
+        offset += RecordSize(header.length);
+    }
+
+    // the last commit never finished
+    if(open) {
+        torn = true;
+    }
+
+    // a write cut short before its header went down can still have left bits further on
+    if(!torn && !PrefsBlank(base + offset, PREFS_SECTOR_SIZE - offset)) {
+        torn = true;
+    }
+
+    if(sector == active) {
+        writeOffset = offset;
+        dirty = torn;
+    }
+}
+
+int PrefsLog::Read(uint8_t type, uint8_t version, void *data, uint16_t length) const
+{
+    if(!type || type >= PREFS_LOG_TYPES || !newest[type].offset) {
+        return Result_NoData;
+    }
+    const uint8_t *record = flash.Data() + newest[type].offset;
+    RecordHeader_t header;
+    memcpy(&header, record, sizeof(header));
+    if(header.version != version || header.length != length) {
+        return Result_Mismatch;
+    }
+    memcpy(data, record + sizeof(header), length);
+    return Result_Ok;
+}
+
+void PrefsLog::Stage(uint8_t type, uint8_t version, const void *data, uint16_t length)
+{
+    if(!type || type >= PREFS_LOG_TYPES) {
+        return;
+    }
+    staged[type].data = data;
+    staged[type].length = length;
+    staged[type].version = version;
+    staged[type].pending = true;
+}
+
+bool PrefsLog::Changed(uint8_t type)
+{
+    if(!newest[type].offset) {
+        return true;
+    }
+    const uint8_t *record = flash.Data() + newest[type].offset;
+    RecordHeader_t header;
+    memcpy(&header, record, sizeof(header));
+    return header.version != staged[type].version || header.length != staged[type].length ||
+           memcmp(record + sizeof(header), staged[type].data, staged[type].length) != 0;
+}
+
+void PrefsLog::WriteRecord(PageWriter &writer, uint8_t type, uint8_t version, const void *data, uint16_t length, bool last)
+{
+    RecordHeader_t header;
+    header.type = type;
+    header.version = version;
+    header.length = length;
+    header.sequence = ++sequence;
+    header.flags = last ? Flag_Last : 0;
+    header.crc = Crc(header, (const uint8_t*)data);
+    writer.Put(&header, sizeof(header));
+    writer.Put(data, length);
+}
+
+int PrefsLog::Commit()
+{
+    uint32_t needed = 0;
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            if(Changed(t)) {
+                needed += RecordSize(staged[t].length);
+            } else {
+                staged[t].pending = false;
+            }
+        }
+    }
+    if(!needed) {
+        return Result_Ok;
+    }
+
+    int status;
+    if(active < 0 || dirty || writeOffset + needed > PREFS_SECTOR_SIZE) {
+        status = Compact();
+    } else {
+        status = Append();
+    }
+
+    // pick up the new records from flash, which also checks they went down right
+    Begin();
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            if(status == Result_Ok && Changed(t)) {
+                status = Result_Flash;
+            }
+            staged[t].pending = false;
+        }
+    }
+    return status;
+}
+
+int PrefsLog::Append()
+{
+    uint8_t last = 0;
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            last = t;
+        }
+    }
+
+    PageWriter writer(flash, active * PREFS_SECTOR_SIZE + writeOffset);
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            WriteRecord(writer, t, staged[t].version, staged[t].data, staged[t].length, t == last);
+        }
+    }
+    return writer.Finish() ? Result_Ok : Result_Flash;
+}
+
+int PrefsLog::Compact()
+{
+    const uint8_t target = active < 0 ? 0 : (active + 1) % PREFS_LOG_SECTORS;
+
+    // a record only left in the sector about to be erased (its copy in the active one having gone bad) can't be kept
+    bool keep[PREFS_LOG_TYPES];
+    uint8_t last = 0;
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        keep[t] = !staged[t].pending && newest[t].offset && newest[t].offset / PREFS_SECTOR_SIZE != target;
+        if(staged[t].pending || keep[t]) {
+            last = t;
+        }
+    }
+
+    // make sure the latest of everything fits before anything's erased
+    uint32_t needed = sizeof(SectorHeader_t);
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            needed += RecordSize(staged[t].length);
+        } else if(keep[t]) {
+            RecordHeader_t header;
+            memcpy(&header, flash.Data() + newest[t].offset, sizeof(header));
+            needed += RecordSize(header.length);
+        }
+    }
+    if(needed > PREFS_SECTOR_SIZE) {
+        return Result_Full;
+    }
+
+    const uint32_t base = target * PREFS_SECTOR_SIZE;
+    if(!flash.Erase(base)) {
+        return Result_Flash;
+    }
+
+    PageWriter writer(flash, base + sizeof(SectorHeader_t));
+    for(uint8_t t = 1; t < PREFS_LOG_TYPES; ++t) {
+        if(staged[t].pending) {
+            WriteRecord(writer, t, staged[t].version, staged[t].data, staged[t].length, t == last);
+        } else if(keep[t]) {
+            const uint8_t *record = flash.Data() + newest[t].offset;
+            RecordHeader_t header;
+            memcpy(&header, record, sizeof(header));
+            WriteRecord(writer, t, header.version, record + sizeof(header), header.length, t == last);
+        }
+    }
+    if(!writer.Finish()) {
+        return Result_Flash;
+    }
+
+    // the new sector only counts once its header's down, so until then the old one's still used as a whole
+    SectorHeader_t header;
+    header.magic = Magic;
+    header.generation = generation + 1;
+    header.check = ~header.generation;
+    uint8_t page[PREFS_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &header, sizeof(header));
+    return flash.Program(base, page) ? Result_Ok : Result_Flash;
+}
+
+bool PrefsLog::Placed(uintptr_t log, uintptr_t spaceStart, uintptr_t spaceEnd, uintptr_t sketchEnd,
+                      uintptr_t otherStart, uintptr_t otherEnd)
+{
+    const uintptr_t end = log + PREFS_LOG_SECTORS * PREFS_SECTOR_SIZE;
+    if(log % PREFS_SECTOR_SIZE || log < spaceStart || end > spaceEnd || end < log) {
+        return false;
+    }
+    if(log < sketchEnd) {
+        return false;
+    }
+    return otherStart == otherEnd || end <= otherStart || log >= otherEnd;
+}
+
+bool PrefsLog::Erase()
+{
+    bool ok = true;
+    for(uint8_t s = 0; s < PREFS_LOG_SECTORS; ++s) {
+        if(!PrefsBlank(flash.Data() + s * PREFS_SECTOR_SIZE, PREFS_SECTOR_SIZE)) {
+            ok = flash.Erase(s * PREFS_SECTOR_SIZE) && ok;
+        }
+    }
+    Begin();
+    return ok;
+}
@@ -0,0 +1,224 @@
+ /*!
+ * @file OpenFIREPrefsLog.h
+ * @brief Log-structured preferences store, spread over two flash sectors.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIREPrefsLog is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIREPREFSLOG_H_
+#define _OPENFIREPREFSLOG_H_
+
+#include <stdint.h>
+
+// Flash geometry, as the RP2040's QSPI flash has it: erased a sector at a time, programmed a page at a time.
+#define PREFS_SECTOR_SIZE 4096
+#define PREFS_PAGE_SIZE 256
+// Sectors the log's spread over; when the one being written fills up, the latest of each record moves to the other.
+#define PREFS_LOG_SECTORS 2
+// Record types go from 1 up to (but not including) this
+#define PREFS_LOG_TYPES 8
+// Longest a save will wait for the buttons to be released before it's written regardless, in milliseconds.
+#define PREFS_MAX_DEFER 2000
+
+/// @brief Where the log's kept
+/// @details Erase() sets a whole sector to 0xFF; Program() can only clear bits, so programming 0xFF over
+/// anything already written leaves it as it was. Offsets are from the start of the log's first sector.
+class PrefsFlash {
+public:
+    /// @brief The log's sectors, to be read straight out of memory
+    virtual const uint8_t *Data() = 0;
+
+    /// @brief Erases one sector
+    /// @param offset Sector-aligned
+    virtual bool Erase(uint32_t offset) = 0;
+
+    /// @brief Programs one page
+    /// @param offset Page-aligned
+    virtual bool Program(uint32_t offset, const uint8_t *page) = 0;
+};
+
+/// @brief Stores each group of preferences as its own record, appended after the last
+/// @details Each record carries its type, layout version, length, a sequence number & a CRC over all of it.
+/// On boot every intact record is scanned, and the one with the highest sequence number of each type wins;
+/// a save cut short just leaves records that fail their CRC or aren't followed by the save's last one,
+/// so the ones before are used instead, and the groups of one save are always kept together.
+/// Only the sector being written is ever erased, and only once it's full: the latest of each record is copied
+/// to the other sector, and the copy's marked as the one to use (with a higher generation) once it's complete,
+/// so the sectors wear evenly and there's always a full set to come back to.
+/// Doesn't touch any hardware itself, so it can be run against a simulated flash.
+class PrefsLog {
+public:
+    enum Result_e {
+        Result_Ok = 0,
+        Result_NoData,          // No record of that type
+        Result_Mismatch,        // Newest record's from a different layout version/length
+        Result_Full,            // Even a fresh sector can't hold the latest of every record
+        Result_Flash            // Erasing/programming failed, or didn't read back
+    };
+
+    enum RecordFlags_e {
+        Flag_Last = 1 << 0          // Last record of a Commit(); until it's down, none of that commit's records count
+    };
+
+    /// @brief Record header, followed by the payload
+    typedef struct RecordHeader_s {
+        uint8_t type;               // from 1 to PREFS_LOG_TYPES - 1
+        uint8_t version;            // layout version of that group's struct, bump on any change
+        uint16_t length;            // payload length in bytes
+        uint32_t sequence;          // counts up with every record written, across both sectors
+        uint8_t flags;              // RecordFlags_e
+        uint16_t crc;               // CRC-16/CCITT of the above & the payload
+    } __attribute__ ((packed)) RecordHeader_t;
+
+    /// @brief Start of each sector, written once everything after it has been
+    typedef struct SectorHeader_s {
+        uint32_t magic;
+        uint32_t generation;        // counts up with every compaction; the highest valid one's written to
+        uint32_t check;             // ~generation, so a half-written header doesn't count
+    } __attribute__ ((packed)) SectorHeader_t;
+
+    explicit PrefsLog(PrefsFlash &flashStore) : flash(flashStore) {}
+
+    /// @brief Scans both sectors for the newest record of each type, and where to write next
+    void Begin();
+
+    /// @brief Whether neither sector's been set up, i.e. nothing's ever been saved
+    bool Empty() const { return active < 0; }
+
+    /// @brief Copies out the newest record of a type
+    /// @return Result_e; data's untouched unless Result_Ok
+    int Read(uint8_t type, uint8_t version, void *data, uint16_t length) const;
+
+    /// @brief Queues a record to go out with the next Commit()
+    /// @details Only the pointer's kept, so what's written is whatever it points at by then.
+    void Stage(uint8_t type, uint8_t version, const void *data, uint16_t length);
+
+    /// @brief Writes every staged record that differs from what's stored
+    /// @details Nothing's erased or programmed if none do. Records are appended to the current sector if they fit,
+    /// otherwise everything's compacted into the other one.
+    /// @return Result_e
+    int Commit();
+
+    /// @brief Erases every sector that isn't already blank
+    bool Erase();
+
+    /// @brief Sector being written to, -1 if none
+    int8_t Active() const { return active; }
+
+    /// @brief Bytes left in the sector being written to
+    uint16_t Free() const { return active < 0 ? 0 : PREFS_SECTOR_SIZE - writeOffset; }
+
+    /// @brief Highest sequence number written so far
+    uint32_t Sequence() const { return sequence; }
+
+    /// @brief Generation of the sector being written to
+    uint32_t Generation() const { return generation; }
+
+    /// @brief Checks the log's sectors sit wholly inside the space set aside for them, and clear of everything else
+    /// @details Ends are one past the last byte; an empty other range (start == end) is skipped.
+    /// @param log Start of the log's first sector
+    /// @param sketchEnd End of the program image
+    /// @param otherStart,otherEnd Another owner's flash in or next to the same space, e.g. Bluetooth pairings
+    static bool Placed(uintptr_t log, uintptr_t spaceStart, uintptr_t spaceEnd, uintptr_t sketchEnd,
+                       uintptr_t otherStart, uintptr_t otherEnd);
+
+    static constexpr uint32_t Magic = 0x474C464F; // "OFLG"
+
+private:
+    typedef struct Staged_s {
+        const void *data;
+        uint16_t length;
+        uint8_t version;
+        bool pending;
+    } Staged_t;
+
+    typedef struct Newest_s {
+        uint32_t offset;            // from the start of the log, 0 if there's none
+        uint32_t sequence;
+    } Newest_t;
+
+    /// @brief Collects records into a page at a time, programming each as it fills
+    class PageWriter {
+    public:
+        PageWriter(PrefsFlash &flashStore, uint32_t start);
+        void Put(const void *data, uint16_t length);
+        bool Finish();
+    private:
+        PrefsFlash &flash;
+        uint32_t offset;
+        bool ok = true;
+        uint8_t page[PREFS_PAGE_SIZE];
+    };
+
+    static uint16_t Crc(const RecordHeader_t &header, const uint8_t *payload);
+    static uint32_t RecordSize(uint16_t length) { return sizeof(RecordHeader_t) + length; }
+
+    bool SectorValid(uint8_t sector, uint32_t &gen);
+    void Scan(uint8_t sector);
+    bool Changed(uint8_t type);
+    void WriteRecord(PageWriter &writer, uint8_t type, uint8_t version, const void *data, uint16_t length, bool last);
+    int Append();
+    int Compact();
+
+    PrefsFlash &flash;
+    Newest_t newest[PREFS_LOG_TYPES] = {};
+    Staged_t staged[PREFS_LOG_TYPES] = {};
+    int8_t active = -1;
+    uint32_t generation = 0;
+    uint32_t sequence = 0;
+    uint16_t writeOffset = 0;       // within the active sector
+    bool dirty = false;             // active sector has a cut-short write past writeOffset, so it can't be appended to
+};
+
+/// @brief Decides when a staged save's committed
+/// @details Writing to flash stalls both cores, so a save waits until no button's held
+/// (a solenoid/rumble pulse would be stuck on for that long), or until it's waited PREFS_MAX_DEFER regardless.
+/// Due() should only be asked where a stall's harmless anyway, e.g. right after a camera frame.
+class PrefsDefer {
+public:
+    /// @brief A save's been staged; the wait counts from the first request that's still pending
+    /// @param now millis()
+    void Request(uint32_t now) {
+        if(!pending) {
+            stamp = now;
+        }
+        pending = true;
+    }
+
+    /// @brief Drops a pending save, e.g. when the preferences are cleared
+    void Cancel() { pending = false; }
+
+    /// @brief Whether a save's waiting to be committed
+    bool Pending() const { return pending; }
+
+    /// @brief Checks whether to commit now
+    /// @param now millis()
+    /// @param held Whether any button's held
+    /// @return true if the pending save should be committed now; it's no longer pending after
+    bool Due(uint32_t now, bool held) {
+        if(!pending || (held && now - stamp < PREFS_MAX_DEFER)) {
+            return false;
+        }
+        pending = false;
+        return true;
+    }
+
+private:
+    bool pending = false;
+    uint32_t stamp = 0;
+};
+
+#endif // _OPENFIREPREFSLOG_H_
@@ -0,0 +1,80 @@
+ /*!
+ * @file OpenFIRETelemetry.cpp
+ * @brief Binary telemetry stream for the OpenFIRE App's test view.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRETelemetry is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include "OpenFIRETelemetry.h"
+
+// the record length is sent as a single byte
+static_assert(sizeof(TelemetryRecord_t) < 256, "Telemetry record too large for its length field!");
+
+bool Telemetry::Send(TelemetryRecord_t &record)
+{
+    record.sync[0] = TELEMETRY_SYNC0;
+    record.sync[1] = TELEMETRY_SYNC1;
+    record.version = TELEMETRY_VERSION;
+    record.length = sizeof(TelemetryRecord_t);
+    record.seq = seq++;
+
+    uint8_t *data = (uint8_t*)&record;
+    uint8_t sum = 0;
+    for(unsigned int i = 0; i < sizeof(TelemetryRecord_t) - 1; i++) {
+        sum += data[i];
+    }
+    record.checksum = sum;
+
+    // Don't stall the camera loop waiting on the host; skip this one and let seq show the gap.
+    if(Serial.availableForWrite() < (int)sizeof(TelemetryRecord_t)) {
+        dropped++;
+        return false;
+    }
+    Serial.write(data, sizeof(TelemetryRecord_t));
+    return true;
+}
+
+bool Telemetry::Send(const FrameSample_t &frame, uint16_t buttons, uint8_t runMode)
+{
+    TelemetryRecord_t record;
+    record.timestamp = frame.timestamp;
+    for(int i = 0; i < 4; i++) {
+        record.rawX[i] = frame.rawX[i];
+        record.rawY[i] = frame.rawY[i];
+        record.cornerX[i] = frame.cornerX[i];
+        record.cornerY[i] = frame.cornerY[i];
+    }
+    record.seen = frame.seen;
+    record.layout = frame.layout;
+    record.warpX = frame.warpX;
+    record.warpY = frame.warpY;
+    record.filteredX = frame.filteredX;
+    record.filteredY = frame.filteredY;
+    record.buttons = buttons;
+    record.timeCam = frame.timeCam;
+    record.timeSolve = frame.timeSolve;
+    record.timeWarp = frame.timeWarp;
+    record.timeFilter = frame.timeFilter;
+    record.runMode = runMode;
+    return Send(record);
+}
+
+void Telemetry::Reset()
+{
+    seq = 0;
+    dropped = 0;
+}
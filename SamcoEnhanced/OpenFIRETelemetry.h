@@ -0,0 +1,91 @@
+ /*!
+ * @file OpenFIRETelemetry.h
+ * @brief Binary telemetry stream for the OpenFIRE App's test view.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  OpenFIRETelemetry is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENFIRETELEMETRY_H_
+#define _OPENFIRETELEMETRY_H_
+
+#include <stdint.h>
+#include "OpenFIREFrame.h"
+
+// Sync bytes at the start of every record, so the host can re-align after a dropped byte.
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+// Bump whenever the record layout below changes.
+#define TELEMETRY_VERSION 1
+
+/// @brief One camera frame's worth of pipeline state, sent as-is over CDC.
+/// @details All fields are little endian (native on RP2040). The host should:
+///   1. scan for TELEMETRY_SYNC0/1,
+///   2. check version & length match what it expects,
+///   3. verify the checksum (8-bit sum of every byte before it),
+///   4. use seq to count records dropped by the firmware (busy CDC) or in transit.
+typedef struct TelemetryRecord_s {
+    uint8_t sync[2];            ///< TELEMETRY_SYNC0, TELEMETRY_SYNC1
+    uint8_t version;            ///< TELEMETRY_VERSION
+    uint8_t length;             ///< sizeof(TelemetryRecord_t)
+    uint32_t seq;               ///< Sequence number, increments for every frame whether it was sent or not
+    uint32_t timestamp;         ///< micros() at the start of the camera read
+    uint16_t rawX[4];           ///< Raw camera points (0-1023)
+    uint16_t rawY[4];           ///< Raw camera points (0-767)
+    uint8_t seen;               ///< Camera seen bit mask (bits 0-3)
+    uint8_t layout;             ///< 0 = square, 1 = diamond
+    int16_t cornerX[4];         ///< Solved LED positions from the square/diamond tracker (camera res << 2)
+    int16_t cornerY[4];
+    int16_t warpX;              ///< Perspective output (res_x/res_y space)
+    int16_t warpY;
+    int16_t filteredX;          ///< After the grid fit if any, then run mode averaging (before offsets, res_x/res_y space)
+    int16_t filteredY;
+    uint16_t buttons;           ///< Debounced button mask
+    uint16_t timeCam;           ///< Time spent reading the camera, in microseconds
+    uint16_t timeSolve;         ///< Time spent in the square/diamond tracker, in microseconds
+    uint16_t timeWarp;          ///< Time spent in the perspective warp, in microseconds
+    uint16_t timeFilter;        ///< Time spent in offsets/averaging, in microseconds
+    uint8_t runMode;            ///< Current profile run mode
+    uint8_t checksum;           ///< 8-bit sum of all previous bytes
+} __attribute__ ((packed)) TelemetryRecord_t;
+
+class Telemetry {
+public:
+    /// @brief Stamps the header & checksum and writes the record to Serial
+    /// @details If the CDC buffer can't fit the whole record, it's skipped rather than
+    /// blocking the camera loop - the host sees this as a gap in seq.
+    /// @return true if the record was queued
+    bool Send(TelemetryRecord_t &record);
+
+    /// @brief Fills in a record from a frame's pipeline state, and sends it
+    /// @param buttons Debounced button mask
+    /// @param runMode Current profile run mode
+    /// @return true if the record was queued
+    bool Send(const FrameSample_t &frame, uint16_t buttons, uint8_t runMode);
+
+    /// @brief Resets sequence & drop counters, for when the stream is (re)started
+    void Reset();
+
+    // Whether binary records are sent in place of the text test output
+    bool active = false;
+
+    // Number of frames produced since the last Reset()
+    uint32_t seq = 0;
+
+    // Number of records that couldn't be written because the CDC buffer was full
+    uint32_t dropped = 0;
+};
+
+#endif // _OPENFIRETELEMETRY_H_
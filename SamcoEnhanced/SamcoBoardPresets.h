@@ -0,0 +1,222 @@
+/*!
+ * @file SamcoBoardPresets.h
+ * @brief Default pin layouts for each supported board.
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ */
+
+#ifndef _SAMCOBOARDPRESETS_H_
+#define _SAMCOBOARDPRESETS_H_
+
+#include <Arduino.h>
+#include <OpenFIREBoard.h>
+#include "SamcoPreferences.h"
+
+/// @brief Default pin layout for a board, keyed by its OPENFIRE_BOARD identifier
+typedef struct BoardPreset_s {
+    const char *board;
+    SamcoPreferences::PinsMap_t pins;
+} BoardPreset_t;
+
+// Every board's preset is built regardless of the target, so they're all checked below on every build.
+// Anything not set here stays unmapped (-1).
+// (A0-A3 are GPIO26-29 on every RP2040 variant, so they're safe to use for other boards' presets.)
+inline constexpr BoardPreset_t BoardPresets[] = {
+    // For the Adafruit ItsyBitsy RP2040 - optimized for SAMCO boards
+    {"adafruitItsyRP2040", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.oRumble = 24;
+        p.oSolenoid = 25;
+        p.bTrigger = 6;
+        p.bGunA = 27;
+        p.bGunB = 26;
+        p.bGunC = 11;
+        p.bStart = 28;
+        p.bSelect = 29;
+        p.bGunUp = 9;
+        p.bGunDown = 7;
+        p.bGunLeft = 8;
+        p.bGunRight = 10;
+        p.bPedal = 4;
+        p.pCamSCL = 3;
+        p.pCamSDA = 2;
+        // second camera (DUAL_CAMERA), on TX/RX
+        p.pCam2SCL = 1;
+        p.pCam2SDA = 0;
+        return p;
+    }()},
+
+    // For the Adafruit KB2040 - optimized for GUN4IR boards
+    {"adafruitKB2040", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.oRumble = 5;
+        p.oSolenoid = 7;
+        p.bTrigger = A2;
+        p.bGunA = A3;
+        p.bGunB = 4;
+        p.bGunC = 6;
+        p.bStart = 9;
+        p.bSelect = 8;
+        p.bGunUp = 18;
+        p.bGunDown = 20;
+        p.bGunLeft = 19;
+        p.bGunRight = 10;
+        p.bHome = A1;
+        p.pCamSCL = 3;
+        p.pCamSDA = 2;
+        // second camera (DUAL_CAMERA), on the STEMMA QT port
+        p.pCam2SCL = 13;
+        p.pCam2SDA = 12;
+        return p;
+    }()},
+
+    // For the Arduino Nano RP2040 Connect - because it was requested
+    {"arduinoNanoRP2040", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.oRumble = 17;
+        p.oSolenoid = 16;
+        p.bTrigger = 15;
+        p.bGunA = 0;
+        p.bGunB = 1;
+        p.bGunC = 18;
+        p.bStart = 19;
+        p.bSelect = 20;
+        p.pCamSCL = 13;
+        p.pCamSDA = 12;
+        // second camera (DUAL_CAMERA)
+        p.pCam2SCL = A1;
+        p.pCam2SDA = A0;
+        return p;
+    }()},
+
+    // For the Waveshare RP2040 Zero - smallest/cheapest board
+    {"waveshareZero", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.oRumble = 17;
+        p.oSolenoid = 16;
+        p.bTrigger = 0;
+        p.bGunA = 1;
+        p.bGunB = 2;
+        p.bGunC = 3;
+        p.bStart = 4;
+        p.bSelect = 5;
+        p.pCamSCL = 15;
+        p.pCamSDA = 14;
+        // second camera (DUAL_CAMERA)
+        p.pCam2SCL = 9;
+        p.pCam2SDA = 8;
+        return p;
+    }()},
+
+    // For the Raspberry Pi Pico - first party baybeeee
+    {"rpipico", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.oRumble = 17;
+        p.oSolenoid = 16;
+        p.bTrigger = 15;
+        p.bGunA = 0;
+        p.bGunB = 1;
+        p.bGunC = 2;
+        p.bStart = 3;
+        p.bSelect = 4;
+        p.bGunUp = 6;
+        p.bGunDown = 7;
+        p.bGunLeft = 8;
+        p.bGunRight = 9;
+        p.bPedal = 14;
+        p.bPump = 13;
+        p.bHome = 5;
+        p.pCamSCL = 21;
+        p.pCamSDA = 20;
+        // second camera (DUAL_CAMERA)
+        p.pCam2SCL = A1;
+        p.pCam2SDA = A0;
+        return p;
+    }()},
+
+    // Last entry is the fallback for anything else (VCC-GND YD, generic)
+    {"generic", [] {
+        SamcoPreferences::PinsMap_t p{};
+        p.pCamSCL = 21;
+        p.pCamSDA = 20;
+        // second camera (DUAL_CAMERA)
+        p.pCam2SCL = A1;
+        p.pCam2SDA = A0;
+        return p;
+    }()}
+};
+
+constexpr bool BoardNameEquals(const char *a, const char *b)
+{
+    while(*a && *a == *b) { ++a, ++b; }
+    return *a == *b;
+}
+
+/// @brief Finds the preset for a board identifier
+/// @details Pico W shares the Pico's layout; unknown boards get the generic entry.
+constexpr SamcoPreferences::PinsMap_t BoardPresetFor(const char *board)
+{
+    if(BoardNameEquals(board, "rpipicow")) {
+        board = "rpipico";
+    }
+    for(const BoardPreset_t &preset : BoardPresets) {
+        if(BoardNameEquals(preset.board, board)) {
+            return preset.pins;
+        }
+    }
+    return BoardPresets[sizeof(BoardPresets) / sizeof(BoardPresets[0]) - 1].pins;
+}
+
+/// @brief Checks that no two functions in a pin map share a pin
+constexpr bool BoardPresetPinsUnique(const SamcoPreferences::PinsMap_t &p)
+{
+    const int8_t list[] = {
+        p.bTrigger, p.bGunA, p.bGunB, p.bStart, p.bSelect, p.bGunUp, p.bGunDown, p.bGunLeft, p.bGunRight,
+        p.bGunC, p.bPedal, p.bPedal2, p.bHome, p.bPump, p.oRumble, p.oSolenoid, p.sRumble, p.sSolenoid,
+        p.sAutofire, p.oPixel, p.oLedR, p.oLedB, p.oLedG, p.pCamSDA, p.pCamSCL, p.pPeriphSDA, p.pPeriphSCL,
+        p.aBattRead, p.aStickX, p.aStickY, p.aTMP36, p.pCam2SDA, p.pCam2SCL
+    };
+    static_assert(sizeof(list) == sizeof(SamcoPreferences::PinsMap_t), "Pin conflict check is missing a PinsMap_t field!");
+    for(unsigned int i = 0; i < sizeof(list); ++i) {
+        for(unsigned int j = i + 1; j < sizeof(list); ++j) {
+            if(list[i] >= 0 && list[i] == list[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Checks that a pin map's second camera pins are an I2C pair it can have to itself
+/// @details Both cameras answer on the same address, so the second needs the channel that neither the first camera
+/// nor the peripherals are on. On the RP2040, GPIO n is on channel (n >> 1) & 1, with SDA on even pins & SCL on odd.
+constexpr bool BoardPresetCam2Usable(const SamcoPreferences::PinsMap_t &p)
+{
+    return p.pCam2SDA >= 0 && p.pCam2SCL >= 0 && p.pCamSCL >= 0 &&
+           !bitRead(p.pCam2SDA, 0) && bitRead(p.pCam2SCL, 0) &&
+           bitRead(p.pCam2SDA, 1) == bitRead(p.pCam2SCL, 1) &&
+           bitRead(p.pCam2SCL, 1) != bitRead(p.pCamSCL, 1) &&
+           (p.pPeriphSCL < 0 || bitRead(p.pCam2SCL, 1) != bitRead(p.pPeriphSCL, 1));
+}
+
+constexpr bool BoardPresetsValid()
+{
+    for(const BoardPreset_t &preset : BoardPresets) {
+        if(!BoardPresetPinsUnique(preset.pins) || !BoardPresetCam2Usable(preset.pins)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(BoardPresetsValid(), "A board preset maps the same pin to more than one function, or has nowhere for a second camera!");
+
+// Preset for the board being built for
+inline constexpr SamcoPreferences::PinsMap_t BoardPreset = BoardPresetFor(OPENFIRE_BOARD);
+
+#endif // _SAMCOBOARDPRESETS_H_
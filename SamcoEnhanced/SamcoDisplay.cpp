@@ -33,6 +33,9 @@
 
 Adafruit_SSD1306 *display;
 
+// bus the display was started on, since we push partial updates to it directly
+TwoWire *displayWire;
+
 ExtDisplay::ExtDisplay() {}
 
 bool ExtDisplay::Begin()
@@ -47,6 +50,7 @@ bool ExtDisplay::Begin()
                 Wire1.setSDA(SamcoPreferences::pins.pPeriphSDA);
                 Wire1.setSCL(SamcoPreferences::pins.pPeriphSCL);
                 display = new Adafruit_SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire1, -1);
+                displayWire = &Wire1;
                 displayValid = true;
             } else {
                 displayValid = false;
@@ -59,6 +63,7 @@ bool ExtDisplay::Begin()
                 Wire.setSDA(SamcoPreferences::pins.pPeriphSDA);
                 Wire.setSCL(SamcoPreferences::pins.pPeriphSCL);
                 display = new Adafruit_SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+                displayWire = &Wire;
                 displayValid = true;
             } else {
                 displayValid = false;
@@ -73,8 +78,10 @@ bool ExtDisplay::Begin()
         return false;
     }
 
-    if(display->begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+    if(display->begin(SSD1306_SWITCHCAPVCC, DISPLAY_ADDRESS)) {
         display->clearDisplay();
+        // panel RAM is in an unknown state at power on, so the first flush has to cover everything
+        MarkDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
         ScreenModeChange(Screen_None);
         return true;
     } else {
@@ -83,24 +90,145 @@ bool ExtDisplay::Begin()
     }
 }
 
+void ExtDisplay::MarkDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    // clip to the panel
+    if(x < 0) { w += x; x = 0; }
+    if(y < 0) { h += y; y = 0; }
+    if(x + w > SCREEN_WIDTH) { w = SCREEN_WIDTH - x; }
+    if(y + h > SCREEN_HEIGHT) { h = SCREEN_HEIGHT - y; }
+    if(w <= 0 || h <= 0) { return; }
+
+    // each SSD1306 page is a strip of 8 rows, so grow every page the rect touches
+    for(uint8_t page = y / 8; page <= (y + h - 1) / 8; page++) {
+        if(dirtyColStart[page] > x) { dirtyColStart[page] = x; }
+        if(dirtyColEnd[page] < x + w - 1) { dirtyColEnd[page] = x + w - 1; }
+    }
+}
+
+void ExtDisplay::ClearRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    display->fillRect(x, y, w, h, BLACK);
+    MarkDirty(x, y, w, h);
+}
+
+void ExtDisplay::SendColumns(uint8_t page, uint8_t start, uint8_t count)
+{
+    // addressing window in one go, since ssd1306_command() would restore the slow clock after every byte
+    displayWire->beginTransmission(DISPLAY_ADDRESS);
+    displayWire->write((uint8_t)0x00);   // Co = 0, D/C = 0: command stream
+    displayWire->write(SSD1306_PAGEADDR);
+    displayWire->write(page);
+    displayWire->write(page);
+    displayWire->write(SSD1306_COLUMNADDR);
+    displayWire->write(start);
+    displayWire->write(start + count - 1);
+    displayWire->endTransmission();
+
+    uint8_t *ptr = display->getBuffer() + page * SCREEN_WIDTH + start;
+    while(count) {
+        uint8_t chunk = min(count, (uint8_t)DISPLAY_WIRE_CHUNK);
+        displayWire->beginTransmission(DISPLAY_ADDRESS);
+        displayWire->write((uint8_t)0x40);   // Co = 0, D/C = 1: everything after this is GDDRAM data
+        displayWire->write(ptr, chunk);
+        displayWire->endTransmission();
+        ptr += chunk, count -= chunk;
+    }
+}
+
+void ExtDisplay::FlushPage(uint8_t page)
+{
+    SendColumns(page, dirtyColStart[page], dirtyColEnd[page] - dirtyColStart[page] + 1);
+    dirtyColStart[page] = SCREEN_WIDTH;
+    dirtyColEnd[page] = 0;
+}
+
+void ExtDisplay::Flush()
+{
+    displayWire->setClock(DISPLAY_WIRE_CLOCK);
+    for(uint8_t page = 0; page < SCREEN_HEIGHT / 8; page++) {
+        if(dirtyColStart[page] <= dirtyColEnd[page]) {
+            FlushPage(page);
+        }
+    }
+    displayWire->setClock(100000);
+}
+
+bool ExtDisplay::FlushStep(uint16_t budget)
+{
+    if(!displayValid) {
+        return false;
+    }
+
+    // a run costs the window command, plus one data write
+    constexpr uint32_t runCost = DisplayWireMicros(7) + DisplayWireMicros(1);
+    bool sent = false;
+
+    // round robin from wherever we left off, so one busy region can't starve the rest of the panel
+    uint8_t clean = 0;
+    while(clean < SCREEN_HEIGHT / 8) {
+        uint8_t page = flushNextPage;
+        if(dirtyColStart[page] > dirtyColEnd[page]) {
+            flushNextPage = (page + 1) % (SCREEN_HEIGHT / 8);
+            clean++;
+            continue;
+        }
+
+        // columns that fit what's left: 9 clocks each
+        uint16_t fit = budget > runCost ? (uint32_t)(budget - runCost) * (DISPLAY_WIRE_CLOCK / 1000) / 9000 : 0;
+        uint8_t left = dirtyColEnd[page] - dirtyColStart[page] + 1;
+        uint8_t count = min(left, (uint8_t)min(fit, (uint16_t)DISPLAY_WIRE_CHUNK));
+        if(count < min(left, (uint8_t)DISPLAY_MIN_CHUNK)) {
+            // not worth the addressing; try again next frame
+            break;
+        }
+
+        if(!sent) {
+            displayWire->setClock(DISPLAY_WIRE_CLOCK);
+            sent = true;
+        }
+        SendColumns(page, dirtyColStart[page], count);
+        uint32_t cost = DisplayWireMicros(7) + DisplayWireMicros(count + 1);
+        budget = budget > cost ? budget - cost : 0;
+        if(count == left) {
+            dirtyColStart[page] = SCREEN_WIDTH;
+            dirtyColEnd[page] = 0;
+            flushNextPage = (page + 1) % (SCREEN_HEIGHT / 8);
+            clean = 0;
+        } else {
+            dirtyColStart[page] += count;
+        }
+    }
+    if(sent) {
+        displayWire->setClock(100000);
+    }
+
+    for(uint8_t page = 0; page < SCREEN_HEIGHT / 8; page++) {
+        if(dirtyColStart[page] <= dirtyColEnd[page]) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ExtDisplay::TopPanelUpdate(char textPrefix[7], char textInput[16])
 {
     if(displayValid) {
-        display->fillRect(0, 0, 128, 16, BLACK);
+        ClearRect(0, 0, 128, 16);
         display->drawFastHLine(0, 15, 128, WHITE);
         display->setCursor(2, 2);
         display->setTextSize(1);
         display->setTextColor(WHITE, BLACK);
         display->print(textPrefix);
         display->println(textInput);
-        display->display();
+        Flush();
     }
 }
 
 void ExtDisplay::ScreenModeChange(int8_t screenMode, bool isAnalog)
 {
     if(displayValid) {
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         if(screenState >= Screen_Mamehook_Single &&
            screenMode == Screen_Normal) {
             currentAmmo = 0, currentLife = 0;
@@ -116,10 +244,10 @@ void ExtDisplay::ScreenModeChange(int8_t screenMode, bool isAnalog)
             break;
           case Screen_None:
           case Screen_Docked:
-            display->fillRect(0, 0, 128, 16, BLACK);
+            ClearRect(0, 0, 128, 16);
             display->drawBitmap(24, 0, customSplashBanner, CUSTSPLASHBANN_WIDTH, CUSTSPLASHBANN_HEIGHT, WHITE);
             display->drawBitmap(40, 16, customSplash, CUSTSPLASH_WIDTH, CUSTSPLASH_HEIGHT, WHITE);
-            display->display();
+            Flush();
             break;
           case Screen_Init:
             display->setTextSize(2);
@@ -178,7 +306,7 @@ void ExtDisplay::ScreenModeChange(int8_t screenMode, bool isAnalog)
             PrintLife(currentLife);
             break;
         }
-        display->display();
+        Flush();
     }
 }
 
@@ -209,14 +337,14 @@ void ExtDisplay::IdleOps()
 void ExtDisplay::DrawVisibleIR(int pointX[4], int pointY[4])
 {
     if(displayValid) {
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         for(uint8_t i = 0; i < 4; i++) {
           pointX[i] = map(pointX[i], 0, 1920, 0, 128);
           pointY[i] = map(pointY[i], 0, 1080, 16, 64);
           pointY[i] = constrain(pointY[i], 16, 64);
           display->fillCircle(pointX[i], pointY[i], 1, WHITE);
         }
-        display->display();
+        Flush();
     }
 }
 
@@ -225,7 +353,7 @@ void ExtDisplay::PauseScreenShow(uint8_t currentProf, char name1[16], char name2
     if(displayValid) {
         char* namesList[16] = { name1, name2, name3, name4 };
         TopPanelUpdate("Using ", namesList[currentProf]); // names are placeholder
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         display->setTextSize(1);
         display->setCursor(0, 17);
         display->print(" A > ");
@@ -239,14 +367,14 @@ void ExtDisplay::PauseScreenShow(uint8_t currentProf, char name1[16], char name2
         display->setCursor(0, 17+(11*3));
         display->print("Sel> ");
         display->println(name4);
-        display->display();
+        Flush();
     }
 }
 
 void ExtDisplay::PauseListUpdate(uint8_t selection)
 {
     if(displayValid) {
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         display->drawBitmap(60, 18, upArrowGlyph, ARROW_WIDTH, ARROW_HEIGHT, WHITE);
         display->drawBitmap(60, 59, downArrowGlyph, ARROW_WIDTH, ARROW_HEIGHT, WHITE);
         display->setTextSize(1);
@@ -386,14 +514,14 @@ void ExtDisplay::PauseListUpdate(uint8_t selection)
             }
             break;
         }
-        display->display();
+        Flush();
     }
 }
 
 void ExtDisplay::PauseProfileUpdate(uint8_t selection, char name1[16], char name2[16], char name3[16], char name4[16])
 {
     if(displayValid) {
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         display->drawBitmap(60, 18, upArrowGlyph, ARROW_WIDTH, ARROW_HEIGHT, WHITE);
         display->drawBitmap(60, 59, downArrowGlyph, ARROW_WIDTH, ARROW_HEIGHT, WHITE);
         display->setTextSize(1);
@@ -442,22 +570,83 @@ void ExtDisplay::PauseProfileUpdate(uint8_t selection, char name1[16], char name
             display->println(name1);
             break;
         }
-        display->display();
+        Flush();
     }
 }
 
 void ExtDisplay::SaveScreen(uint8_t status)
 {
     if(displayValid) {
-        display->fillRect(0, 16, 128, 48, BLACK);
+        ClearRect(0, 16, 128, 48);
         display->setTextColor(WHITE, BLACK);
         display->setTextSize(2);
         display->setCursor(24, 24);
         display->println("Saving...");
-        display->display();
+        Flush();
+    }
+}
+
+void ExtDisplay::BlitGlyph(int16_t x, int16_t y, const uint8_t *pages, uint8_t w, uint8_t h)
+{
+    uint8_t *buffer = display->getBuffer();
+    // glyph pages rarely line up with the panel's, so every glyph byte straddles two buffer bytes
+    uint8_t shift = y & 7;
+    int16_t destPage = y >> 3;
+    for(uint8_t page = 0; page < (h + 7) / 8; page++, destPage++) {
+        for(uint8_t col = 0; col < w; col++) {
+            int16_t destX = x + col;
+            if(destX < 0 || destX >= SCREEN_WIDTH) {
+                continue;
+            }
+            uint8_t bits = pages[page * w + col];
+            if(destPage >= 0 && destPage < SCREEN_HEIGHT / 8) {
+                buffer[destPage * SCREEN_WIDTH + destX] |= bits << shift;
+            }
+            if(shift && destPage + 1 >= 0 && destPage + 1 < SCREEN_HEIGHT / 8) {
+                buffer[(destPage + 1) * SCREEN_WIDTH + destX] |= bits >> (8 - shift);
+            }
+        }
+    }
+    MarkDirty(x, y, w, h);
+}
+
+void ExtDisplay::DrawHeartRow(int16_t x, int16_t y, uint8_t count, uint8_t spacing, bool large)
+{
+    for(uint8_t i = 0; i < count; i++) {
+        if(large) {
+            BlitGlyph(x + spacing * i, y, &lifeIcoLargePage.data[0][0], HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT);
+        } else {
+            BlitGlyph(x + spacing * i, y, &lifeIcoSmallPage.data[0][0], HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT);
+        }
+    }
+}
+
+void ExtDisplay::UpdateHUD(uint8_t ammo, uint8_t life)
+{
+    if(displayValid) {
+        if((serialDisplayType == ScreenSerial_Ammo || serialDisplayType == ScreenSerial_Both) &&
+           ammo != currentAmmo) {
+            PrintAmmo(ammo);
+        }
+        if((serialDisplayType == ScreenSerial_Life || serialDisplayType == ScreenSerial_Both) &&
+           life != currentLife) {
+            PrintLife(life);
+        }
     }
 }
 
+bool ExtDisplay::HUDStep(unsigned long now)
+{
+    if(!hudPending || now - hudStamp < HUD_REDRAW_INTERVAL) {
+        return false;
+    }
+    // clear first, so an update that lands while we're drawing still gets picked up next time around
+    hudPending = false;
+    hudStamp = now;
+    UpdateHUD(postedAmmo, postedLife);
+    return true;
+}
+
 void ExtDisplay::PrintAmmo(uint8_t ammo)
 {
     if(displayValid) {
@@ -466,145 +655,23 @@ void ExtDisplay::PrintAmmo(uint8_t ammo)
         uint8_t ammoLeft = ammo / 10;
         uint8_t ammoRight = ammo - ammoLeft * 10;
         if(!ammo) { ammoEmpty = true; } else { ammoEmpty = false; }
+        uint8_t ammoX;
         if(screenState == Screen_Mamehook_Single) {
-            display->fillRect(40, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
-            switch(ammoLeft) {
-              case 0:
-                display->drawBitmap(40, 22, number_0, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 1:
-                display->drawBitmap(40, 22, number_1, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 2:
-                display->drawBitmap(40, 22, number_2, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 3:
-                display->drawBitmap(40, 22, number_3, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 4:
-                display->drawBitmap(40, 22, number_4, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 5:
-                display->drawBitmap(40, 22, number_5, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 6:
-                display->drawBitmap(40, 22, number_6, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 7:
-                display->drawBitmap(40, 22, number_7, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 8:
-                display->drawBitmap(40, 22, number_8, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 9:
-                display->drawBitmap(40, 22, number_9, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-            }
-
-            display->fillRect(40+NUMBER_GLYPH_WIDTH+6, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
-            switch(ammoRight) {
-              case 0:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_0, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 1:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_1, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 2:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_2, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 3:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_3, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 4:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_4, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 5:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_5, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 6:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_6, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 7:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_7, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 8:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_8, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 9:
-                display->drawBitmap(40+NUMBER_GLYPH_WIDTH+6, 22, number_9, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-            }
-            display->display();
+            ammoX = 40;
         } else if(screenState == Screen_Mamehook_Dual) {
-            display->fillRect(72, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
-            switch(ammoLeft) {
-              case 0:
-                display->drawBitmap(72, 22, number_0, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 1:
-                display->drawBitmap(72, 22, number_1, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 2:
-                display->drawBitmap(72, 22, number_2, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 3:
-                display->drawBitmap(72, 22, number_3, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 4:
-                display->drawBitmap(72, 22, number_4, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 5:
-                display->drawBitmap(72, 22, number_5, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 6:
-                display->drawBitmap(72, 22, number_6, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 7:
-                display->drawBitmap(72, 22, number_7, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 8:
-                display->drawBitmap(72, 22, number_8, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 9:
-                display->drawBitmap(72, 22, number_9, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-            }
+            ammoX = 72;
+        } else {
+            return;
+        }
 
-            display->fillRect(72+NUMBER_GLYPH_WIDTH+6, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
-            switch(ammoRight) {
-              case 0:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_0, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 1:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_1, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 2:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_2, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 3:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_3, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 4:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_4, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 5:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_5, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 6:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_6, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 7:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_7, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 8:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_8, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-              case 9:
-                display->drawBitmap(72+NUMBER_GLYPH_WIDTH+6, 22, number_9, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
-                break;
-            }
-            display->display();
+        ClearRect(ammoX, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT);
+        // three digit counts don't fit, so leave the tens blank like before
+        if(ammoLeft < 10) {
+            BlitGlyph(ammoX, 22, &numberAtlas[ammoLeft].data[0][0], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT);
         }
+
+        ClearRect(ammoX+NUMBER_GLYPH_WIDTH+6, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT);
+        BlitGlyph(ammoX+NUMBER_GLYPH_WIDTH+6, 22, &numberAtlas[ammoRight].data[0][0], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT);
     }
 }
 
@@ -615,8 +682,8 @@ void ExtDisplay::PrintLife(uint8_t life)
         if(!life) { lifeEmpty = true; } else { lifeEmpty = false; }
         if(screenState == Screen_Mamehook_Single) {
             if(lifeBar) {
-                display->fillRect(14, 37, 100, 9, BLACK);
-                display->fillRect(52, 51, 30, 8, BLACK);
+                ClearRect(14, 37, 100, 9);
+                ClearRect(52, 51, 30, 8);
                 display->fillRect(14, 37, life, 9, WHITE);
                 if(life) {
                   display->setTextSize(1);
@@ -625,99 +692,27 @@ void ExtDisplay::PrintLife(uint8_t life)
                   display->print(life);
                   display->println(" %");
                 }
-                display->display();
             } else {
-                display->fillRect(22, 19, HEART_LARGE_WIDTH*5+4, HEART_LARGE_HEIGHT+22+HEART_LARGE_HEIGHT, BLACK);
-                switch(life) {
-                  case 9:
-                    display->drawBitmap(22, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-
-                    display->drawBitmap(30, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+1+HEART_LARGE_WIDTH, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+2+HEART_LARGE_WIDTH*2, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+3+HEART_LARGE_WIDTH*3, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 8:
-                    display->drawBitmap(22, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-
-                    display->drawBitmap(39, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(39+1+HEART_LARGE_WIDTH, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(39+2+HEART_LARGE_WIDTH*2, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 7:
-                    display->drawBitmap(22, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-
-                    display->drawBitmap(48, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(48+1+HEART_LARGE_WIDTH, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 6:
-                    display->drawBitmap(22, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-
-                    display->drawBitmap(56, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 5:
-                    display->drawBitmap(22, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+HEART_LARGE_WIDTH, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+HEART_LARGE_WIDTH*2, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+HEART_LARGE_WIDTH*3, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+HEART_LARGE_WIDTH*4, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 4:
-                    display->drawBitmap(30, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+1+HEART_LARGE_WIDTH, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+2+HEART_LARGE_WIDTH*2, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(30+3+HEART_LARGE_WIDTH*3, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 3:
-                    display->drawBitmap(39, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(39+1+HEART_LARGE_WIDTH, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(39+2+HEART_LARGE_WIDTH*2, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 2:
-                    display->drawBitmap(48, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(48+1+HEART_LARGE_WIDTH, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 1:
-                    display->drawBitmap(56, 30, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
-                  case 0:
-                    break;
-                  default: // 10+
-                    display->drawBitmap(22, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 19, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-
-                    display->drawBitmap(22, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+1+HEART_LARGE_WIDTH, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+2+HEART_LARGE_WIDTH*2, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+3+HEART_LARGE_WIDTH*3, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    display->drawBitmap(22+4+HEART_LARGE_WIDTH*4, 41, lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
-                    break;
+                // x offset of the second (or only) row, indexed by heart count
+                static constexpr uint8_t bottomRowX[10] = { 0, 56, 48, 39, 30, 22, 56, 48, 39, 30 };
+                ClearRect(22, 19, HEART_LARGE_WIDTH*5+4, HEART_LARGE_HEIGHT+22+HEART_LARGE_HEIGHT);
+                if(life >= 10) {
+                    DrawHeartRow(22, 19, 5, HEART_LARGE_WIDTH+1, true);
+                    DrawHeartRow(22, 41, 5, HEART_LARGE_WIDTH+1, true);
+                } else if(life > 5) {
+                    DrawHeartRow(22, 19, 5, HEART_LARGE_WIDTH+1, true);
+                    DrawHeartRow(bottomRowX[life], 41, life - 5, HEART_LARGE_WIDTH+1, true);
+                } else if(life == 5) {
+                    // a full row only fits without gaps
+                    DrawHeartRow(22, 30, 5, HEART_LARGE_WIDTH, true);
+                } else if(life) {
+                    DrawHeartRow(bottomRowX[life], 30, life, HEART_LARGE_WIDTH+1, true);
                 }
-                display->display();
             }
         } else if(screenState == Screen_Mamehook_Dual) {
             if(lifeBar) {
-                display->fillRect(4, 39, 55, 5, BLACK);
-                display->fillRect(20, 51, 30, 8, BLACK);
+                ClearRect(4, 39, 55, 5);
+                ClearRect(20, 51, 30, 8);
                 display->fillRect(4, 39, map(life, 0, 100, 0, 55), 5, WHITE);
                 if(life) {
                   display->setTextSize(1);
@@ -726,94 +721,18 @@ void ExtDisplay::PrintLife(uint8_t life)
                   display->print(life);
                   display->println(" %");
                 }
-                display->display();
             } else {
-                display->fillRect(1, 22, HEART_SMALL_WIDTH*5, HEART_SMALL_HEIGHT+20+HEART_SMALL_HEIGHT, BLACK);
-                switch(life) {
-                  case 9:
-                    display->drawBitmap(1, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-
-                    display->drawBitmap(7, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH*2, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH*3, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 8:
-                    display->drawBitmap(1, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-
-                    display->drawBitmap(13, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(13+HEART_SMALL_WIDTH, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(13+HEART_SMALL_WIDTH*2, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 7:
-                    display->drawBitmap(1, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-
-                    display->drawBitmap(19, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(19+HEART_SMALL_WIDTH, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 6:
-                    display->drawBitmap(1, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-
-                    display->drawBitmap(25, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 5:
-                    display->drawBitmap(1, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 4:
-                    display->drawBitmap(7, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH*2, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(7+HEART_SMALL_WIDTH*3, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 3:
-                    display->drawBitmap(13, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(13+HEART_SMALL_WIDTH, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(13+HEART_SMALL_WIDTH*2, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 2:
-                    display->drawBitmap(19, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(19+HEART_SMALL_WIDTH, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 1:
-                    display->drawBitmap(25, 32, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
-                  case 0:
-                    break;
-                  default: // 10+
-                    display->drawBitmap(1, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 22, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-
-                    display->drawBitmap(1, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*2, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*3, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    display->drawBitmap(1+HEART_SMALL_WIDTH*4, 42, lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
-                    break;
+                static constexpr uint8_t bottomRowX[10] = { 0, 25, 19, 13, 7, 1, 25, 19, 13, 7 };
+                ClearRect(1, 22, HEART_SMALL_WIDTH*5, HEART_SMALL_HEIGHT+20+HEART_SMALL_HEIGHT);
+                if(life >= 10) {
+                    DrawHeartRow(1, 22, 5, HEART_SMALL_WIDTH, false);
+                    DrawHeartRow(1, 42, 5, HEART_SMALL_WIDTH, false);
+                } else if(life > 5) {
+                    DrawHeartRow(1, 22, 5, HEART_SMALL_WIDTH, false);
+                    DrawHeartRow(bottomRowX[life], 42, life - 5, HEART_SMALL_WIDTH, false);
+                } else if(life) {
+                    DrawHeartRow(bottomRowX[life], 32, life, HEART_SMALL_WIDTH, false);
                 }
-                display->display();
             }
         }
     }
@@ -25,6 +25,47 @@
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
+#define DISPLAY_ADDRESS 0x3C
+// max GDDRAM bytes per I2C transaction (+1 control byte has to fit in the Wire buffer)
+#define DISPLAY_WIRE_CHUNK 128
+// I2C clock for panel updates, same as the Adafruit lib uses for its own transactions
+#define DISPLAY_WIRE_CLOCK 400000
+// Per-transaction time on top of the bus itself (Wire setup & FIFO waits), in microseconds
+#define DISPLAY_WIRE_OVERHEAD 20
+// Fewest columns FlushStep() will send at once, so a tight gap isn't spent mostly on addressing
+#define DISPLAY_MIN_CHUNK 8
+// Minimum time between HUD redraws (~30Hz), in milliseconds, so games spamming ammo/life don't stall the camera loop
+#define HUD_REDRAW_INTERVAL 33
+// Time left free before the next camera read, in microseconds; covers the timer IRQ & the rest of the frame's work
+#define DISPLAY_FLUSH_MARGIN 500
+
+/// @brief Worst case time for one I2C write of a number of bytes (control byte included) to the panel, in microseconds
+/// @details Start, address & 9 clocks (8 bits + ack) per byte, then a stop.
+constexpr uint32_t DisplayWireMicros(uint16_t bytes)
+{
+    return (((uint32_t)bytes + 1) * 9 + 2) * 1000000UL / DISPLAY_WIRE_CLOCK + 1 + DISPLAY_WIRE_OVERHEAD;
+}
+
+/// @brief Glyph in the SSD1306's native layout: one byte per column per 8-row page, LSB on top
+template<uint8_t W, uint8_t H>
+struct PageGlyph_s {
+    uint8_t data[(H + 7) / 8][W];
+};
+
+/// @brief Repack an Adafruit GFX style (row-major, MSB first) bitmap into page format at compile time
+template<uint8_t W, uint8_t H>
+constexpr PageGlyph_s<W, H> ToPageGlyph(const uint8_t *bitmap)
+{
+    PageGlyph_s<W, H> glyph{};
+    for(uint8_t row = 0; row < H; row++) {
+        for(uint8_t col = 0; col < W; col++) {
+            if(bitmap[row * ((W + 7) / 8) + col / 8] & (0x80 >> (col & 7))) {
+                glyph.data[row / 8][col] |= 1 << (row & 7);
+            }
+        }
+    }
+    return glyph;
+}
 
 class ExtDisplay {
 public:
@@ -70,13 +111,52 @@ public:
     void SaveScreen(uint8_t status);
 
     /// @brief Update main screen ammo glyphs
+    /// @details Only draws to the framebuffer; the panel is updated by FlushStep().
     /// @return nothing
     void PrintAmmo(uint8_t ammo);
 
     /// @brief Update main screen life glyphs
+    /// @details Only draws to the framebuffer; the panel is updated by FlushStep().
     /// @return nothing
     void PrintLife(uint8_t life);
 
+    /// @brief Redraw the ammo/life elements used by the current serial layout
+    /// @details Elements whose value matches what's already on screen are skipped entirely.
+    /// @return nothing
+    void UpdateHUD(uint8_t ammo, uint8_t life);
+
+    /// @brief Hand over the latest ammo/life counts for the next HUDStep(); safe to call from the other core
+    /// @details Only the latest counts are kept, so a burst of updates costs one redraw.
+    void PostHUD(uint8_t ammo, uint8_t life)
+    {
+        postedAmmo = ammo;
+        postedLife = life;
+        hudPending = true;
+    }
+
+    /// @brief Redraw from the last posted counts, if any came in and the last redraw was at least HUD_REDRAW_INTERVAL ago
+    /// @param now millis()
+    /// @return true if the HUD was redrawn
+    bool HUDStep(unsigned long now);
+
+    /// @brief Push as many dirty columns to the panel as fit in a time budget
+    /// @details Meant to be called right after a camera read, so display traffic only
+    /// ever fills the idle gap before the next camera tick instead of delaying it.
+    /// Pages are split into runs of columns where needed, picking up where the last step left off.
+    /// @param budget Bus time that can be spent, in microseconds (see FlushBudget())
+    /// @return true if more dirty columns are waiting
+    bool FlushStep(uint16_t budget);
+
+    /// @brief Time FlushStep() can have before the next camera read
+    /// @param now micros()
+    /// @param nextTick micros() the next camera read is due at
+    /// @return Budget in microseconds, 0 if the gap is already used up
+    static uint16_t FlushBudget(uint32_t now, uint32_t nextTick)
+    {
+        int32_t left = (int32_t)(nextTick - now) - DISPLAY_FLUSH_MARGIN;
+        return left <= 0 ? 0 : (left > 0xFFFF ? 0xFFFF : left);
+    }
+
     enum ScreenMode_e {
         Screen_None = -1,
         Screen_Init = 0,
@@ -116,15 +196,53 @@ public:
     uint8_t serialDisplayType = 0;
 
 private:
+    /// @brief Clears a region of the framebuffer and marks it for the next Flush()
+    void ClearRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /// @brief Grows the dirty column range of every page a region touches
+    void MarkDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /// @brief Push only the dirty columns of dirty pages to the panel
+    /// @details Replaces display->display(), which always sends the full 1KB framebuffer.
+    void Flush();
+
+    /// @brief Send one page's dirty columns and mark it clean
+    void FlushPage(uint8_t page);
+
+    /// @brief Point the panel at a run of columns in a page, and send them from the framebuffer
+    void SendColumns(uint8_t page, uint8_t start, uint8_t count);
+
+    // Page FlushStep() checks first
+    uint8_t flushNextPage = 0;
+
+    // Counts posted by PostHUD(), and whether HUDStep() has drawn them yet
+    volatile uint8_t postedAmmo = 0;
+    volatile uint8_t postedLife = 0;
+    volatile bool hudPending = false;
+    unsigned long hudStamp = 0;
+
+    /// @brief OR a page format glyph straight into the framebuffer at any x/y, and mark it dirty
+    /// @details Each glyph byte lands in at most two framebuffer bytes, vs. drawBitmap()'s per-pixel writes.
+    void BlitGlyph(int16_t x, int16_t y, const uint8_t *pages, uint8_t w, uint8_t h);
+
+    /// @brief Blit a row of hearts, spaced a given amount of pixels apart
+    void DrawHeartRow(int16_t x, int16_t y, uint8_t count, uint8_t spacing, bool large);
+
     bool displayValid = false;
 
+    // Per-page dirty column range; start > end means the page is clean
+    uint8_t dirtyColStart[SCREEN_HEIGHT / 8] = { SCREEN_WIDTH, SCREEN_WIDTH, SCREEN_WIDTH, SCREEN_WIDTH,
+                                                 SCREEN_WIDTH, SCREEN_WIDTH, SCREEN_WIDTH, SCREEN_WIDTH };
+    uint8_t dirtyColEnd[SCREEN_HEIGHT / 8] = { 0 };
+
     int8_t screenState = Screen_None;
 
     bool ammoEmpty = false;
     bool lifeEmpty = false;
 
-    uint8_t currentAmmo;
-    uint8_t currentLife;
+    // what's currently drawn, which Mamehook screen inits redraw from
+    uint8_t currentAmmo = 0;
+    uint8_t currentLife = 0;
 
     // timestamps, in case we need them for periodic tasks in IdleOps()
     unsigned long ammoTimestamp = 0;
@@ -250,6 +368,24 @@ private:
         0xa0, 0x05, 0xbf, 0xfd, 0xc0, 0x03, 0xff, 0xff
     };
 
+    /// @brief HUD glyphs above in page format, for BlitGlyph()
+    static constexpr PageGlyph_s<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT> numberAtlas[10] = {
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_0),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_1),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_2),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_3),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_4),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_5),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_6),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_7),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_8),
+        ToPageGlyph<NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT>(number_9)
+    };
+    static constexpr PageGlyph_s<HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT> lifeIcoSmallPage =
+        ToPageGlyph<HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT>(lifeIcoSmall);
+    static constexpr PageGlyph_s<HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT> lifeIcoLargePage =
+        ToPageGlyph<HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT>(lifeIcoLarge);
+
     #define LIFEBAR_BANNER_WIDTH 23
     #define LIFEBAR_BANNER_HEIGHT 9
     static constexpr uint8_t lifeBarBanner[] = {
@@ -52,20 +52,34 @@
 #endif
 #ifdef SAMCO_FLASH_ENABLE
     #include <Adafruit_SPIFlashBase.h>
-#elif SAMCO_EEPROM_ENABLE
-    #include <EEPROM.h>
-#endif // SAMCO_FLASH_ENABLE/EEPROM_ENABLE
+#endif // SAMCO_FLASH_ENABLE
 
 
 #include <DFRobotIRPositionEx.h>
 #include <LightgunButtons.h>
 #include <OpenFIRE_Square.h>
+#include <OpenFIRE_Rigid.h>
 #include <OpenFIRE_Diamond.h>
 #include <OpenFIRE_Perspective.h>
+#include <OpenFIRE_Calibration.h>
+#include <OpenFIRE_AxisMap.h>
+#include <OpenFIRE_Average.h>
+#include <OpenFIRE_Fusion.h>
 #include <OpenFIREConst.h>
 #include "SamcoColours.h"
 #include "SamcoPreferences.h"
+#include "SamcoBoardPresets.h"
+#include "OpenFIREEvents.h"
 #include "OpenFIREFeedback.h"
+#include "OpenFIREFrame.h"
+#include "OpenFIRETelemetry.h"
+#include "OpenFIRELights.h"
+#include "OpenFIREPacer.h"
+#include "OpenFIRECalAssist.h"
+#include "OpenFIREAutoCal.h"
+#include "OpenFIREPower.h"
+#include "OpenFIREDispatch.h"
+#include "OpenFIREPrefsLog.h"
 
 #ifdef ARDUINO_ARCH_RP2040
   #include <hardware/pwm.h>
@@ -81,6 +95,29 @@
   // If unsure, leave this uncommented - it only affects RP2040 anyways.
 #define DUAL_CORE
 
+  // Uncomment to pace the cursor to the 1ms USB polling interval, rather than sending it once per camera frame.
+  // Reports only go out when the position changes, so this only pays off with prediction on (docked 'XU1'),
+  // which extrapolates the cursor between camera frames. Pacing stats can be read in docked mode with 'XU'.
+//#define USB_HIGH_RATE
+
+  // Uncomment to keep refining the LED anchors in the background while playing (square layouts only),
+  // to follow a bumped cabinet or a sagging lightbar. Changes are saved the next time the gun's paused.
+//#define AUTO_RECALIBRATE
+
+  // Uncomment to track the square LED layout as one rigid shape, which holds up better with only 2 or 3 LEDs
+  // in view (e.g. near the screen edges, or with an LED blocked); takes one full view of all four to get going.
+//#define RIGID_TRACKING
+
+  // Uncomment if the gun has a second IR camera (angled, or with a wider lens) to see LEDs past the edges of the first one's view.
+  // It needs the I2C channel the first camera isn't using (and the display isn't either), on the Camera 2 pins in the pin map.
+  // There's nothing to set up: it's lined up with the first camera on its own, from frames where both see all four LEDs.
+//#define DUAL_CAMERA
+
+  // Uncomment to save power on a Pico W running off battery (over Bluetooth): while no LEDs are in view and no buttons
+  // are touched, the camera's read less often and both cores sleep in between. Anything seen or pressed brings back the full rate.
+  // The battery voltage (if its pin is set) is read in the background, and shown in docked mode.
+//#define POWER_SAVE
+
   // Here we define the Manufacturer Name/Device Name/PID:VID of the gun as will be displayed by the operating system.
   // For multiplayer, different guns need different IDs!
   // If unsure, or are only using one gun, just leave these at their defaults!
@@ -128,6 +165,11 @@
 #ifdef CUSTOM_NEOPIXEL
     #define LED_ENABLE
     #include <Adafruit_NeoPixel.h>
+    // Uncomment to have the NeoPixel strip (past its static pixels) show the ammo count sent by Mamehook, one pixel per shot.
+    // (Needs MAMEHOOKER & USES_DISPLAY, as that's where the ammo count comes from.)
+    //#define LED_AMMO_GAUGE
+    // Uncomment to flash the LEDs on every shot, in time with the solenoid (or rumble, if that's standing in for it).
+    //#define LED_MUZZLE_FLASH
 #endif // CUSTOM_NEOPIXEL
 
   // Leave this uncommented to enable optional support for SSD1306 monochrome OLED displays.
@@ -201,25 +243,47 @@ enum ButtonMask_e {
 // see LightgunButtons::Desc_t, format is: 
 // {pin, report type, report code (ignored for internal), offscreen report type, offscreen report code, gamepad output report type, gamepad output report code, debounce time, debounce mask, label}
 LightgunButtons::Desc_t LightgunButtons::ButtonDesc[] = {
-    {SamcoPreferences::pins.bTrigger, LightgunButtons::ReportType_Internal, MOUSE_LEFT, LightgunButtons::ReportType_Internal, MOUSE_LEFT, LightgunButtons::ReportType_Internal, PAD_RT, 15, BTN_AG_MASK}, // Barry says: "I'll handle this."
-    {SamcoPreferences::pins.bGunA, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_LT, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunB, LightgunButtons::ReportType_Mouse, MOUSE_MIDDLE, LightgunButtons::ReportType_Mouse, MOUSE_MIDDLE, LightgunButtons::ReportType_Gamepad, PAD_Y, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bStart, LightgunButtons::ReportType_Keyboard, playerStartBtn, LightgunButtons::ReportType_Keyboard, playerStartBtn, LightgunButtons::ReportType_Gamepad, PAD_START, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bSelect, LightgunButtons::ReportType_Keyboard, playerSelectBtn, LightgunButtons::ReportType_Keyboard, playerSelectBtn, LightgunButtons::ReportType_Gamepad, PAD_SELECT, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunUp, LightgunButtons::ReportType_Gamepad, PAD_UP, LightgunButtons::ReportType_Gamepad, PAD_UP, LightgunButtons::ReportType_Gamepad, PAD_UP, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunDown, LightgunButtons::ReportType_Gamepad, PAD_DOWN, LightgunButtons::ReportType_Gamepad, PAD_DOWN, LightgunButtons::ReportType_Gamepad, PAD_DOWN, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunLeft, LightgunButtons::ReportType_Gamepad, PAD_LEFT, LightgunButtons::ReportType_Gamepad, PAD_LEFT, LightgunButtons::ReportType_Gamepad, PAD_LEFT, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunRight, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, 20, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bGunC, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Gamepad, PAD_A, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bPedal, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Gamepad, PAD_X, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bPedal2, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON5, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON5, LightgunButtons::ReportType_Gamepad, PAD_B, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bPump, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_LT, 15, BTN_AG_MASK2},
-    {SamcoPreferences::pins.bHome, LightgunButtons::ReportType_Internal, 0, LightgunButtons::ReportType_Internal, 0, LightgunButtons::ReportType_Internal, 0, 15, BTN_AG_MASK2}
+    {BoardPreset.bTrigger, LightgunButtons::ReportType_Internal, MOUSE_LEFT, LightgunButtons::ReportType_Internal, MOUSE_LEFT, LightgunButtons::ReportType_Internal, PAD_RT, 15, BTN_AG_MASK}, // Barry says: "I'll handle this."
+    {BoardPreset.bGunA, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_LT, 15, BTN_AG_MASK2},
+    {BoardPreset.bGunB, LightgunButtons::ReportType_Mouse, MOUSE_MIDDLE, LightgunButtons::ReportType_Mouse, MOUSE_MIDDLE, LightgunButtons::ReportType_Gamepad, PAD_Y, 15, BTN_AG_MASK2},
+    {BoardPreset.bStart, LightgunButtons::ReportType_Keyboard, playerStartBtn, LightgunButtons::ReportType_Keyboard, playerStartBtn, LightgunButtons::ReportType_Gamepad, PAD_START, 20, BTN_AG_MASK2},
+    {BoardPreset.bSelect, LightgunButtons::ReportType_Keyboard, playerSelectBtn, LightgunButtons::ReportType_Keyboard, playerSelectBtn, LightgunButtons::ReportType_Gamepad, PAD_SELECT, 20, BTN_AG_MASK2},
+    {BoardPreset.bGunUp, LightgunButtons::ReportType_Gamepad, PAD_UP, LightgunButtons::ReportType_Gamepad, PAD_UP, LightgunButtons::ReportType_Gamepad, PAD_UP, 20, BTN_AG_MASK2},
+    {BoardPreset.bGunDown, LightgunButtons::ReportType_Gamepad, PAD_DOWN, LightgunButtons::ReportType_Gamepad, PAD_DOWN, LightgunButtons::ReportType_Gamepad, PAD_DOWN, 20, BTN_AG_MASK2},
+    {BoardPreset.bGunLeft, LightgunButtons::ReportType_Gamepad, PAD_LEFT, LightgunButtons::ReportType_Gamepad, PAD_LEFT, LightgunButtons::ReportType_Gamepad, PAD_LEFT, 20, BTN_AG_MASK2},
+    {BoardPreset.bGunRight, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_RIGHT, 20, BTN_AG_MASK2},
+    {BoardPreset.bGunC, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Gamepad, PAD_A, 15, BTN_AG_MASK2},
+    {BoardPreset.bPedal, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON4, LightgunButtons::ReportType_Gamepad, PAD_X, 15, BTN_AG_MASK2},
+    {BoardPreset.bPedal2, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON5, LightgunButtons::ReportType_Mouse, MOUSE_BUTTON5, LightgunButtons::ReportType_Gamepad, PAD_B, 15, BTN_AG_MASK2},
+    {BoardPreset.bPump, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Mouse, MOUSE_RIGHT, LightgunButtons::ReportType_Gamepad, PAD_LT, 15, BTN_AG_MASK2},
+    {BoardPreset.bHome, LightgunButtons::ReportType_Internal, 0, LightgunButtons::ReportType_Internal, 0, LightgunButtons::ReportType_Internal, 0, 15, BTN_AG_MASK2}
 };
 
 // button count constant
 constexpr unsigned int ButtonCount = sizeof(LightgunButtons::ButtonDesc) / sizeof(LightgunButtons::ButtonDesc[0]);
 
+// pin map field each button reads its pin from, must match ButtonDesc[] order
+constexpr int8_t SamcoPreferences::PinsMap_t::* ButtonPins[] = {
+    &SamcoPreferences::PinsMap_t::bTrigger,
+    &SamcoPreferences::PinsMap_t::bGunA,
+    &SamcoPreferences::PinsMap_t::bGunB,
+    &SamcoPreferences::PinsMap_t::bStart,
+    &SamcoPreferences::PinsMap_t::bSelect,
+    &SamcoPreferences::PinsMap_t::bGunUp,
+    &SamcoPreferences::PinsMap_t::bGunDown,
+    &SamcoPreferences::PinsMap_t::bGunLeft,
+    &SamcoPreferences::PinsMap_t::bGunRight,
+    &SamcoPreferences::PinsMap_t::bGunC,
+    &SamcoPreferences::PinsMap_t::bPedal,
+    &SamcoPreferences::PinsMap_t::bPedal2,
+    &SamcoPreferences::PinsMap_t::bPump,
+    &SamcoPreferences::PinsMap_t::bHome
+};
+static_assert(sizeof(ButtonPins) / sizeof(ButtonPins[0]) == ButtonCount, "ButtonPins[] needs an entry for every button!");
+static_assert(ButtonPins[BtnIdx_Trigger] == &SamcoPreferences::PinsMap_t::bTrigger &&
+              ButtonPins[BtnIdx_Reload] == &SamcoPreferences::PinsMap_t::bGunC &&
+              ButtonPins[BtnIdx_Home] == &SamcoPreferences::PinsMap_t::bHome, "ButtonPins[] is out of order with ButtonIndex_e!");
+
 // button runtime data arrays
 LightgunButtonsStatic<ButtonCount> lgbData;
 
@@ -298,13 +362,19 @@ SamcoPreferences::ProfileData_t profileData[ProfileCount] = {
     {0, 0, 0, 0, 500 << 2, 1420 << 2, 512 << 2, 384 << 2, DFRobotIRPositionEx::Sensitivity_Default, RunMode_Average, BtnMask_Start,  false, 0x0000FF, "Profile Start"},
     {0, 0, 0, 0, 500 << 2, 1420 << 2, 512 << 2, 384 << 2, DFRobotIRPositionEx::Sensitivity_Default, RunMode_Average, BtnMask_Select, false, 0xFF00FF, "Profile Select"}
 };
+
+// grid calibration fit per profile; a profile with none (points = 0) uses its edge offsets above
+CalibrationFit_t calibrationData[ProfileCount] = {};
 //  ------------------------------------------------------------------------------------------------------
 
-int mouseX;
-int mouseY;
-int moveXAxisArr[3] = {0, 0, 0};
-int moveYAxisArr[3] = {0, 0, 0};
-int moveIndex = 0;
+// the last frame through the positioning pipeline, see GetPosition()
+FrameSample_t frameSample = {};
+// perspective output -> mouse position, rebuilt by UpdateOutputMap() whenever what goes into it changes
+OpenFIRE_AxisMap outputMapX;
+OpenFIRE_AxisMap outputMapY;
+int32_t outputMapKey[6];
+bool outputMapValid = false;
+OpenFIRE_Average moveAverage;
 
 // For offscreen button stuff:
 bool offscreenButton = false;                    // Does shooting offscreen also send a button input (for buggy games that don't recognize off-screen shots)? Default to off.
@@ -353,7 +423,6 @@ bool buttonPressed = false;                      // Sanity check.
     int serialSolPulsesLast = 0;                     // What solenoid pulse we've processed last.
     #endif // USES_SOLENOID
     #ifdef USES_DISPLAY
-    bool serialDisplayChange = false;                // Signal of pending display update, sent by Core 2 to be used by Core 1 in dual core configs
     uint8_t serialLifeCount = 0;
     uint8_t serialAmmoCount = 0;
     #endif // USES_DISPLAY
@@ -362,16 +431,32 @@ bool buttonPressed = false;                      // Sanity check.
 #ifdef USES_DISPLAY
 // Display wrapper interface
 ExtDisplay OLED;
+// Camera frame time left over after the HUD flush, in microseconds; lowest since last read out with 'XF'
+int32_t displaySlackMin = INT32_MAX;
 #endif // USES_DISPLAY
 
 // Force feedback interface
 FFB OF_FFB;
 
+// Binary test output for the App
+Telemetry OF_Telemetry;
+
 unsigned int lastSeen = 0;
 
 bool justBooted = true;                              // For ops we need to do on initial boot (custom pins, joystick centering)
+
+// Boot timing breakdown, micros() at the end of each stage. Sent to the App on 'XI'.
+typedef struct BootTimes_s {
+    unsigned long prefs = 0;                         // preferences loaded
+    unsigned long camera = 0;                        // camera configured
+    unsigned long peripherals = 0;                   // buttons, feedback & LEDs set up
+    unsigned long usb = 0;                           // host has mounted us
+    unsigned long firstReport = 0;                   // first camera frame processed in run mode
+} BootTimes_t;
+BootTimes_t bootTimes;
 bool dockedSaving = false;                           // To block sending test output in docked mode.
 bool dockedCalibrating = false;                      // If set, calibration will send back to docked mode.
+int8_t calGridRequest = -1;                          // Next calibration: 3/4 for a 3x3/4x4 grid, 0 for edges, -1 to redo what the profile has.
 
 unsigned long testLastStamp;                         // Timestamp of last print in test mode.
 const byte testPrintInterval = 50;                   // Minimum time allowed between test mode printouts.
@@ -380,7 +465,11 @@ const byte testPrintInterval = 50;                   // Minimum time allowed bet
 unsigned int selectedProfile = 0;
 
 // OpenFIRE Positioning - one for Square, one for Diamond, and a share perspective object
+#ifdef RIGID_TRACKING
+OpenFIRE_Rigid OpenFIREsquare;
+#else
 OpenFIRE_Square OpenFIREsquare;
+#endif // RIGID_TRACKING
 OpenFIRE_Diamond OpenFIREdiamond;
 OpenFIRE_Perspective OpenFIREper;
 
@@ -447,6 +536,7 @@ static const char* RunModeLabels[RunMode_Count] = {
 SamcoPreferences::Preferences_t SamcoPreferences::profiles = {
     profileData, ProfileCount, // profiles
     0, // default profile
+    calibrationData, // grid calibration fits
 };
 
 SamcoPreferences::TogglesMap_t SamcoPreferences::toggles;
@@ -488,23 +578,39 @@ Adafruit_NeoPixel neopixel(1, NEOPIXEL_PIN, NEO_GRB + NEO_KHZ800);
 Adafruit_NeoPixel* externPixel;
 #endif // CUSTOM_NEOPIXEL
 
+#ifdef LED_ENABLE
+// LED effects, shown by LedService()
+Lights OF_Lights;
+#ifdef LED_MUZZLE_FLASH
+// shots picked up from FFB & Mamehook, turned into flashes by LedService()
+Events::Subscriber ledShots;
+const uint32_t muzzleFlashColor = WikiColor::Ghost_white;
+const uint16_t muzzleFlashLength = 60;               // How long a flash takes to fade out, in ms.
+#endif // LED_MUZZLE_FLASH
+#endif // LED_ENABLE
+
 #ifdef SAMCO_EEPROM_ENABLE
 // EEPROM non-volatile storage
 static const char* NVRAMlabel = "EEPROM";
 
 // flag to indicate if non-volatile storage is available
-// unconditional for EEPROM
-bool nvAvailable = true;
+// set once the preferences log's been found, see SamcoPreferences::Begin()
+bool nvAvailable = false;
 #endif
 
 // non-volatile preferences error code
 int nvPrefsError = SamcoPreferences::Error_NoStorage;
 
+// holds a staged save until it's a good time to write it to flash, see SavePreferencesStep()
+PrefsDefer saveDefer;
+
 // number of times the IR camera will update per second
 constexpr unsigned int IRCamUpdateRate = 209;
 
 // timer will set this to 1 when the IR position can update
 volatile unsigned int irPosUpdateTick = 0;
+// micros() of the last timer tick, which the HUD flush counts the frame's time left from
+volatile uint32_t irPosTickStamp = 0;
 
 #ifdef DEBUG_SERIAL
 static unsigned long serialDbMs = 0;
@@ -526,11 +632,39 @@ AbsMouse5_ AbsMouse5(1);
 // IR positioning camera
 DFRobotIRPositionEx *dfrIRPos;
 
+#ifdef DUAL_CAMERA
+// Second IR camera, if it could be set up, and what puts both cameras' LEDs together
+DFRobotIRPositionEx *dfrIRPos2;
+OpenFIRE_Fusion OpenFIREfusion;
+#endif // DUAL_CAMERA
+
+#ifdef USB_HIGH_RATE
+// Decides when the cursor position goes out, see PointerPaceStep()
+Pacer OF_Pacer;
+#endif // USB_HIGH_RATE
+
+#ifdef AUTO_RECALIBRATE
+// Background LED anchor refinement, see AutoCalStep()
+AutoCal OF_AutoCal(res_x, res_y);
+#endif // AUTO_RECALIBRATE
+
+#if defined(ARDUINO_ARCH_RP2040) && defined(DUAL_CORE)
+// What the second core has to do each time it wakes, see loop1()
+Dispatcher OF_Dispatch;
+#endif // DUAL_CORE
+
+#ifdef POWER_SAVE
+// Camera rate & core sleeping while on battery, see PowerStep()
+PowerSaver OF_Power;
+// Camera rate the timer's currently set to
+unsigned int powerCamRate = IRCamUpdateRate;
+#endif // POWER_SAVE
+
 //-----------------------------------------------------------------------------------------------------
 // The main show!
 void setup() {
-    // initialize EEPROM device. Arduino AVR has a 1k flash, so use that.
-    EEPROM.begin(1024);
+    // find the preferences log in flash
+    nvAvailable = SamcoPreferences::Begin() == SamcoPreferences::Error_Success;
 
     #ifdef ARDUINO_ADAFRUIT_ITSYBITSY_RP2040
         // SAMCO 1.1 needs Pin 5 normally HIGH for the camera
@@ -544,10 +678,11 @@ void setup() {
         LoadPreferences();
         if(nvPrefsError == SamcoPreferences::Error_NoData) {
             SamcoPreferences::ResetPreferences();
-        } else if(nvPrefsError == SamcoPreferences::Error_Success) {
+        } else {
             // use values from preferences
             // if default profile is valid then use it
-            if(SamcoPreferences::profiles.selectedProfile < ProfileCount) {
+            if(nvPrefsError == SamcoPreferences::Error_Success &&
+               SamcoPreferences::profiles.selectedProfile < ProfileCount) {
                 // note, just set the value here not call the function to do the set
                 selectedProfile = SamcoPreferences::profiles.selectedProfile;
 
@@ -561,6 +696,7 @@ void setup() {
                     runMode = (RunMode_e)profileData[selectedProfile].runMode;
                 }
             }
+            // every group is checked separately, so a bad profiles record doesn't throw out the rest
             SamcoPreferences::LoadToggles();
             if(SamcoPreferences::toggles.customPinsInUse) {
                 SamcoPreferences::LoadPins();
@@ -569,11 +705,30 @@ void setup() {
             SamcoPreferences::LoadUSBID();
         }
     }
+    bootTimes.prefs = micros();
  
     // We're setting our custom USB identifiers, as defined in the configuration area!
-    #ifdef USE_TINYUSB
-        TinyUSBInit();
-    #endif // USE_TINYUSB
+    // The devices are started right away, so the host can enumerate us while the camera & peripherals come up.
+#ifdef USE_TINYUSB
+    TinyUSBInit();
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
+    // is VBUS (USB voltage) detected?
+    if(digitalRead(34)) {
+        // If so, we're connected via USB, so initializing the USB devices chunk.
+        TinyUSBDevices.begin(1);
+    } else {
+        // Else, we're on batt, so init the Bluetooth chunks.
+        if(SamcoPreferences::usb.deviceName[0] == '\0') {
+            TinyUSBDevices.beginBT(DEVICE_NAME, DEVICE_NAME);
+        } else {
+            TinyUSBDevices.beginBT(SamcoPreferences::usb.deviceName, SamcoPreferences::usb.deviceName);
+        }
+    }
+    #else
+    // Initializing the USB devices chunk.
+    TinyUSBDevices.begin(1);
+    #endif // ARDUINO_RASPBERRY_PI_PICO_W
+#endif // USE_TINYUSB
     if(SamcoPreferences::usb.devicePID >= 1 && SamcoPreferences::usb.devicePID <= 5) {
         playerStartBtn = SamcoPreferences::usb.devicePID + '0';
         playerSelectBtn = SamcoPreferences::usb.devicePID + '0' + 4;
@@ -583,6 +738,7 @@ void setup() {
 
     // Initialize DFRobot Camera Wires & Object
     CameraSet();
+    bootTimes.camera = micros();
 
     // initialize buttons & feedback devices
     buttons.Begin();
@@ -590,28 +746,17 @@ void setup() {
     #ifdef LED_ENABLE
         LedInit();
     #endif // LED_ENABLE
+    bootTimes.peripherals = micros();
     
 #ifdef USE_TINYUSB
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
-    // is VBUS (USB voltage) detected?
-    if(digitalRead(34)) {
-        // If so, we're connected via USB, so initializing the USB devices chunk.
-        TinyUSBDevices.begin(1);
+    if(!TinyUSBDevices.onBattery) {
         // wait until device mounted
         while(!USBDevice.mounted()) { yield(); }
         Serial.begin(9600);
         Serial.setTimeout(0);
-    } else {
-        // Else, we're on batt, so init the Bluetooth chunks.
-        if(SamcoPreferences::usb.deviceName[0] == '\0') {
-            TinyUSBDevices.beginBT(DEVICE_NAME, DEVICE_NAME);
-        } else {
-            TinyUSBDevices.beginBT(SamcoPreferences::usb.deviceName, SamcoPreferences::usb.deviceName);
-        }
     }
     #else
-    // Initializing the USB devices chunk.
-    TinyUSBDevices.begin(1);
     // wait until device mounted
     while(!USBDevice.mounted()) { yield(); }
     Serial.begin(9600);   // 9600 = 1ms data transfer rates, default for MAMEHOOKER COM devices.
@@ -621,6 +766,7 @@ void setup() {
     // was getting weird hangups... maybe nothing, or maybe related to dragons, so wait a bit
     delay(100);
 #endif
+    bootTimes.usb = micros();
     
     AbsMouse5.init(true);
 
@@ -636,7 +782,8 @@ void setup() {
     (profileData[selectedProfile].topOffset == 0 &&
      profileData[selectedProfile].bottomOffset == 0 && 
      profileData[selectedProfile].leftOffset == 0 &&
-     profileData[selectedProfile].rightOffset == 0)) {
+     profileData[selectedProfile].rightOffset == 0 &&
+     !calibrationData[selectedProfile].points)) {
         // SHIT, it's a first boot! Prompt to start calibration.
         unsigned int timerIntervalShort = 600;
         unsigned int timerInterval = 1000;
@@ -681,7 +828,8 @@ void setup() {
         if((profileData[selectedProfile].topOffset == 0 &&
             profileData[selectedProfile].bottomOffset == 0 && 
             profileData[selectedProfile].leftOffset == 0 &&
-            profileData[selectedProfile].rightOffset == 0)) { SetMode(GunMode_Calibration); }
+            profileData[selectedProfile].rightOffset == 0 &&
+            !calibrationData[selectedProfile].points)) { SetMode(GunMode_Calibration); }
             else { SetMode(GunMode_Run); }
     } else {
         // unofficial official "MiSTer mode" - default to camera -> left stick if trigger's held.
@@ -725,6 +873,35 @@ void CameraSet()
     }
     // Start IR Camera with basic data format
     dfrIRPos->begin(DFROBOT_IR_IIC_CLOCK, DFRobotIRPositionEx::DataFormat_Basic, irSensitivity);
+
+    #ifdef DUAL_CAMERA
+        if(dfrIRPos2 != nullptr) {
+            delete dfrIRPos2;
+            dfrIRPos2 = nullptr;
+        }
+        // Both cameras answer on the same address, so the second needs the other I2C channel all to itself
+        if(BoardPresetCam2Usable(SamcoPreferences::pins) && BoardPresetPinsUnique(SamcoPreferences::pins)) {
+            if(bitRead(SamcoPreferences::pins.pCam2SCL, 1)) {
+                Wire1.setSDA(SamcoPreferences::pins.pCam2SDA);
+                Wire1.setSCL(SamcoPreferences::pins.pCam2SCL);
+                dfrIRPos2 = new DFRobotIRPositionEx(Wire1);
+            } else {
+                Wire.setSDA(SamcoPreferences::pins.pCam2SDA);
+                Wire.setSCL(SamcoPreferences::pins.pCam2SCL);
+                dfrIRPos2 = new DFRobotIRPositionEx(Wire);
+            }
+            dfrIRPos2->begin(DFROBOT_IR_IIC_CLOCK, DFRobotIRPositionEx::DataFormat_Basic, irSensitivity);
+        } else {
+        #ifndef PRINT_VERBOSE
+            // only worth saying when someone's there to read it, e.g. right after the App saved new pins
+            if(gunMode == GunMode_Docked)
+        #endif // PRINT_VERBOSE
+            Serial.printf("Second camera not started: pins %d/%d aren't an SDA/SCL pair of their own on the I2C channel the first camera & display aren't on.\r\n",
+                          SamcoPreferences::pins.pCam2SDA, SamcoPreferences::pins.pCam2SCL);
+        }
+        // cameras may have moved, so line them up again
+        OpenFIREfusion.reset();
+    #endif // DUAL_CAMERA
 }
 
 // inits and/or re-sets feedback pins using currently loaded pin values
@@ -760,8 +937,10 @@ void FeedbackSet()
             pinMode(SamcoPreferences::pins.sAutofire, INPUT_PULLUP);
         }
     #endif // USES_SWITCHES
-    #ifdef USES_ANALOG
+    #if defined(USES_ANALOG) || defined(POWER_SAVE)
         analogReadResolution(12);
+    #endif // USES_ANALOG || POWER_SAVE
+    #ifdef USES_ANALOG
         #ifdef USES_TEMP
         if(SamcoPreferences::pins.aStickX >= 0 && SamcoPreferences::pins.aStickY >= 0 && SamcoPreferences::pins.aStickX != SamcoPreferences::pins.aStickY &&
         SamcoPreferences::pins.aStickX != SamcoPreferences::pins.aTMP36 && SamcoPreferences::pins.aStickY != SamcoPreferences::pins.aTMP36) {
@@ -807,6 +986,8 @@ void FeedbackSet()
             }
             externPixel->show();
         }
+        // new strip, so make sure the current color gets pushed to it
+        OF_Lights.Refresh();
     }
     #endif // CUSTOM_NEOPIXEL
     #ifdef USES_DISPLAY
@@ -862,6 +1043,7 @@ void PinsReset()
             if(externPixel != nullptr) {
                 externPixel->clear();
                 delete externPixel;
+                externPixel = nullptr;
             }
         #endif // CUSTOM_NEOPIXEL
     #endif // LED_ENABLE
@@ -922,6 +1104,9 @@ void rp2040pwmIrq(void)
 {
     pwm_hw->intr = 0xff;
     irPosUpdateTick = 1;
+    irPosTickStamp = micros();
+    // wakes the main core if it's sleeping between frames
+    __sev();
 }
 #endif // ARDUINO_ARCH_RP2040
 
@@ -933,20 +1118,47 @@ void setup1()
     // i sleep
 }
 
+// Button pins' interrupt, on the second core: flags the change, and wakes the loop in case it was about to sleep
+void ButtonEdgeIrq()
+{
+    Events::Publish(Events::Event_ButtonEdge);
+    __sev();
+}
+
 // Second core main loop
 // currently handles all button & serial processing when Core 0 is in ExecRunMode()
+// Sleeps until there's something to do: a button pin changing wakes it right away, and anything timed runs on a 1ms tick.
 void loop1()
 {
+    if(gunMode != GunMode_Run) {
+        return;
+    }
     #ifdef USES_ANALOG
         unsigned long lastAnalogPoll = millis();
     #endif // USES_ANALOG
+    Events::Subscriber edges;
+    buttons.AttachEdges(ButtonEdgeIrq);
+    OF_Dispatch.Reset(micros());
     while(gunMode == GunMode_Run) {
-        // For processing the trigger specifically.
-        // (buttons.debounced is a binary variable intended to be read 1 bit at a time, with the 0'th point == rightmost == decimal 1 == trigger, 3 = start, 4 = select)
-        buttons.Poll(0);
+        uint8_t work = OF_Dispatch.Next(micros(), edges.Take(Events::Event_ButtonEdge), buttons.Settled());
+        if(!work) {
+            // the pins' interrupt, the tick's deadline, or the main core (every camera frame) wakes us
+            best_effort_wfe_or_timeout(make_timeout_time_us(OF_Dispatch.Remaining(micros())));
+            continue;
+        }
+
+        if(work & Dispatcher::Work_Buttons) {
+            // For processing the trigger specifically.
+            // (buttons.debounced is a binary variable intended to be read 1 bit at a time, with the 0'th point == rightmost == decimal 1 == trigger, 3 = start, 4 = select)
+            buttons.Poll(0);
+            #ifdef POWER_SAVE
+                PowerButtonsStep();
+            #endif // POWER_SAVE
+        }
 
         #ifdef MAMEHOOKER
-            if(Serial.available()) {
+            // CDC data only ever lands once per 1ms USB frame, so checking on the tick doesn't hold anything up
+            if((work & Dispatcher::Work_Tick) && Serial.available()) {
                 SerialProcessing();
             }
             if(!serialMode) {   // Have we released a serial signal pulse? If not,
@@ -972,12 +1184,17 @@ void loop1()
             }
         #endif // MAMEHOOKER
 
-        #ifdef USES_ANALOG
-            if(analogIsValid && (millis() - lastAnalogPoll > 1)) {
-                AnalogStickPoll();
-                lastAnalogPoll = millis();
-            }
-        #endif // USES_ANALOG
+        if(work & Dispatcher::Work_Tick) {
+            #ifdef USES_ANALOG
+                if(analogIsValid && (millis() - lastAnalogPoll > 1)) {
+                    AnalogStickPoll();
+                    lastAnalogPoll = millis();
+                }
+            #endif // USES_ANALOG
+            #ifdef POWER_SAVE
+                BatteryPoll();
+            #endif // POWER_SAVE
+        }
         
         if(buttons.pressedReleased == EscapeKeyBtnMask) {
             SendEscapeKey();
@@ -1020,6 +1237,7 @@ void loop1()
             }
         }
     }
+    buttons.DetachEdges();
 }
 #endif // ARDUINO_ARCH_RP2040 || DUAL_CORE
 
@@ -1076,13 +1294,8 @@ void loop()
                         }
                         pauseModeSelectingProfile = false;
                         #ifdef LED_ENABLE
-                            for(byte i = 0; i < 2; i++) {
-                                LedUpdate(180,180,180);
-                                delay(125);
-                                LedOff();
-                                delay(100);
-                            }
                             LedUpdate(255,0,0);
+                            LedBlink(0xB4B4B4, 2, 125, 100);
                         #endif // LED_ENABLE
                         pauseModeSelection = PauseMode_Calibrate;
                         #ifdef USES_DISPLAY
@@ -1153,12 +1366,8 @@ void loop()
                               OLED.TopPanelUpdate("", "Sent Escape Key!");
                           #endif // USES_DISPLAY
                           #ifdef LED_ENABLE
-                              for(byte i = 0; i < 3; i++) {
-                                  LedUpdate(150,0,150);
-                                  delay(55);
-                                  LedOff();
-                                  delay(40);
-                              }
+                              LedOff();
+                              LedBlink(0x960096, 3, 55, 40);
                           #endif // LED_ENABLE
                           #ifdef USES_DISPLAY
                               OLED.TopPanelUpdate("Using ", profileData[selectedProfile].name);
@@ -1289,11 +1498,22 @@ void loop()
             case RunMode_Normal:
             default:
                 ExecRunMode();
+                #ifdef POWER_SAVE
+                    PowerReset();
+                #endif // POWER_SAVE
                 break;
             }
             break;
     }
 
+    // pause menu saves land here
+    SavePreferencesStep();
+    // and button releases, when in composite mode
+    TinyUSBDevices.flush();
+    #ifdef LED_ENABLE
+        LedService();
+    #endif // LED_ENABLE
+
 #ifdef DEBUG_SERIAL
     PrintDebugSerial();
 #endif // DEBUG_SERIAL
@@ -1312,16 +1532,33 @@ void ExecRunMode()
     Serial.println(RunModeLabels[runMode]);
 #endif
     buttons.ReportEnable();
-    if(justBooted) {
-        // center the joystick so RetroArch doesn't throw a hissy fit about uncentered joysticks
-        delay(100);  // Exact time needed to wait seems to vary, so make a safe assumption here.
-        Gamepad16.releaseAll();
-        justBooted = false;
-    }
     #ifdef USES_ANALOG
         unsigned long lastAnalogPoll = millis();
     #endif // USES_ANALOG
+    #ifdef USB_HIGH_RATE
+        // samples from before pausing are stale, don't predict off of them
+        OF_Pacer.Reset();
+    #endif // USB_HIGH_RATE
+    #ifdef POWER_SAVE
+        PowerReset();
+    #endif // POWER_SAVE
     for(;;) {
+        #ifdef USB_HIGH_RATE
+            PointerPaceStep();
+        #endif // USB_HIGH_RATE
+        #ifdef POWER_SAVE
+            PowerStep();
+        #endif // POWER_SAVE
+        // composite mode: everything changed since the last pass goes out together
+        TinyUSBDevices.flush();
+        if(justBooted && micros() - bootTimes.usb >= 100000) {
+            // center the joystick so RetroArch doesn't throw a hissy fit about uncentered joysticks
+            // Exact time needed to wait after mounting seems to vary, so make a safe assumption here;
+            // it's counted from mount rather than blocking, so the cursor's live in the meantime.
+            Gamepad16.releaseAll();
+            justBooted = false;
+        }
+
         // Setting the state of our toggles, if used.
         // Only sets these values if the switches are mapped to valid pins.
         #ifdef USES_SWITCHES
@@ -1343,6 +1580,9 @@ void ExecRunMode()
         // If we're on RP2040, we offload the button polling to the second core.
         #if !defined(ARDUINO_ARCH_RP2040) || !defined(DUAL_CORE)
         buttons.Poll(0);
+        #ifdef POWER_SAVE
+            PowerButtonsStep();
+        #endif // POWER_SAVE
 
         // The main gunMode loop: here it splits off to different paths,
         // depending on if we're in serial handoff (MAMEHOOK) or normal mode.
@@ -1382,20 +1622,34 @@ void ExecRunMode()
         if(irPosUpdateTick) {
             irPosUpdateTick = 0;
             GetPosition();
+            if(!bootTimes.firstReport) {
+                bootTimes.firstReport = micros();
+            }
+            #ifdef POWER_SAVE
+                if(lastSeen) {
+                    OF_Power.Poke();
+                }
+            #endif // POWER_SAVE
+            #ifdef USES_DISPLAY
+                // camera's done until the next tick, so that's when HUD changes get pushed out
+                DisplayFlushStep();
+            #endif // USES_DISPLAY
+            SavePreferencesStep();
+            #ifdef LED_ENABLE
+                LedService();
+            #endif // LED_ENABLE
         }
 
         #ifdef MAMEHOOKER
             #ifdef USES_DISPLAY
                 // For some reason, solenoid feedback is hella wonky when ammo updates are performed on the second core,
                 // so just do it here using the signal sent by it.
-                if(serialDisplayChange) {
-                    if(OLED.serialDisplayType == ExtDisplay::ScreenSerial_Ammo) { OLED.PrintAmmo(serialAmmoCount); }
-                    else if(OLED.serialDisplayType == ExtDisplay::ScreenSerial_Life) { OLED.PrintLife(serialLifeCount); }
-                    else if(OLED.serialDisplayType == ExtDisplay::ScreenSerial_Both) {
-                      OLED.PrintAmmo(serialAmmoCount);
-                      OLED.PrintLife(serialLifeCount);
-                    }
-                    serialDisplayChange = false;
+                // Only the latest counts matter, so anything sent between redraws just gets folded into the next one.
+                if(OLED.HUDStep(millis())) {
+                    #ifdef LED_AMMO_GAUGE
+                        OF_Lights.Gauge(serialAmmoCount);
+                        LedService();
+                    #endif // LED_AMMO_GAUGE
                 }
             #endif // USES_DISPLAY
         #endif // MAMEHOOKER
@@ -1409,6 +1663,9 @@ void ExecRunMode()
                 lastAnalogPoll = millis();
             }
         #endif // USES_ANALOG
+        #ifdef POWER_SAVE
+            BatteryPoll();
+        #endif // POWER_SAVE
 
         if(buttons.pressedReleased == EscapeKeyBtnMask) {
             SendEscapeKey();
@@ -1485,6 +1742,18 @@ void ExecRunMode()
         }
         #endif // ARDUINO_ARCH_RP2040 || DUAL_CORE
 
+        #ifdef POWER_SAVE
+            if(OF_Power.Asleep() && !irPosUpdateTick) {
+                #if defined(ARDUINO_ARCH_RP2040) && defined(DUAL_CORE)
+                    // the next frame's interrupt or a button on the other core wakes us
+                    __wfe();
+                #else
+                    // buttons are polled here, so don't sleep past their debounce interval
+                    sleep_us(POWER_POLL_INTERVAL);
+                #endif // DUAL_CORE
+            }
+        #endif // POWER_SAVE
+
 #ifdef DEBUG_SERIAL
         ++frameCount;
         PrintDebugSerial();
@@ -1515,6 +1784,10 @@ void ExecRunModeProcessing()
         if(irPosUpdateTick) {
             irPosUpdateTick = 0;
             GetPosition();
+            SavePreferencesStep();
+            #ifdef LED_ENABLE
+                LedService();
+            #endif // LED_ENABLE
         }
     }
 }
@@ -1525,7 +1798,8 @@ void ExecGunModeDocked()
     buttons.ReportDisable();
     if(justBooted) {
         // center the joystick so RetroArch/Windows doesn't throw a hissy fit about uncentered joysticks
-        delay(250);  // Exact time needed to wait seems to vary, so make a safe assumption here.
+        // Exact time needed to wait seems to vary, so make a safe assumption here (only whatever's left of it since mounting).
+        while(micros() - bootTimes.usb < 250000) { yield(); }
         Gamepad16.releaseAll();
     }
     #ifdef LED_ENABLE
@@ -1642,8 +1916,14 @@ void ExecGunModeDocked()
             unsigned long currentMillis = millis();
             if(currentMillis - tempChecked >= 1000) {
                 if(SamcoPreferences::pins.aTMP36 >= 0) { Serial.printf("Temperature: %d\r\n", OF_FFB.temperatureCurrent); }
+                #ifdef POWER_SAVE
+                    if(SamcoPreferences::pins.aBattRead >= 0) { Serial.printf("Battery: %d\r\n", OF_Power.battery); }
+                #endif // POWER_SAVE
                 tempChecked = currentMillis;
             }
+            #ifdef POWER_SAVE
+                BatteryPoll();
+            #endif // POWER_SAVE
             
             if(analogIsValid) {
                 if(currentMillis - aStickChecked >= 16) {
@@ -1709,6 +1989,11 @@ void ExecGunModeDocked()
         }
         if(runMode == RunMode_Processing) {
             ExecRunModeProcessing();
+        } else {
+            SavePreferencesStep();
+            #ifdef LED_ENABLE
+                LedService();
+            #endif // LED_ENABLE
         }
     }
 }
@@ -1716,6 +2001,18 @@ void ExecGunModeDocked()
 // Dedicated calibration method
 void ExecCalMode()
 {
+    // grid if asked for, or if that's what this profile was last calibrated with
+    int8_t gridSide = calGridRequest;
+    if(gridSide < 0) {
+        uint8_t points = calibrationData[selectedProfile].points;
+        gridSide = points > 9 ? 4 : (points ? 3 : 0);
+    }
+    calGridRequest = -1;
+    if(gridSide) {
+        ExecGridCalMode(gridSide);
+        return;
+    }
+
     buttons.ReportDisable();
     uint8_t calStage = 0;
     // hold values in a buffer till calibration is complete
@@ -1732,9 +2029,16 @@ void ExecCalMode()
     float _TRled = profileData[selectedProfile].TRled;
     float _adjX = profileData[selectedProfile].adjX;
     float _adjY = profileData[selectedProfile].adjY;
+    CalibrationFit_t _calibration = calibrationData[selectedProfile];
     // set current values to factory defaults
     profileData[selectedProfile].topOffset = 0, profileData[selectedProfile].bottomOffset = 0,
     profileData[selectedProfile].leftOffset = 0, profileData[selectedProfile].rightOffset = 0;
+    // edge calibration replaces any grid fit
+    calibrationData[selectedProfile] = {};
+    // cursor moves between targets, and the aim sample taken at each
+    CalGlide glide;
+    CalSteady steady;
+    bool aimed = false;
 
     // force center mouse to center
     AbsMouse5.move(32768/2, 32768/2);
@@ -1745,8 +2049,14 @@ void ExecCalMode()
 
         if(irPosUpdateTick) {
             irPosUpdateTick = 0;
-            GetPosition();
+            if(GetPosition() && steady.Armed()) {
+                aimed = steady.Feed(frameSample.filteredX, frameSample.filteredY, micros());
+            }
+            #ifdef LED_ENABLE
+                LedService();
+            #endif // LED_ENABLE
         }
+        CaliGlideStep(glide);
         
         if((buttons.pressedReleased & (ExitPauseModeBtnMask | ExitPauseModeHoldBtnMask)) && !justBooted) {
             Serial.println("Calibration cancelled");
@@ -1759,6 +2069,7 @@ void ExecCalMode()
             profileData[selectedProfile].TRled = _TRled;
             profileData[selectedProfile].adjX = _adjX;
             profileData[selectedProfile].adjY = _adjY;
+            calibrationData[selectedProfile] = _calibration;
             // re-print the profile
             stateFlags |= StateFlag_PrintSelectedProfile;
             // re-apply the cal stored in the profile
@@ -1770,9 +2081,12 @@ void ExecCalMode()
                 SetMode(GunMode_Run);
             }
             return;
-        } else if(buttons.pressed == BtnMask_Trigger) {
+        } else if(buttons.pressed == BtnMask_Trigger && !glide.Active() && !steady.Armed()) {
+            // sample once the aim's settled, rather than wherever the trigger pull jolted it to
+            steady.Arm(micros());
+        } else if(aimed) {
+            aimed = false;
             calStage++;
-            CaliMousePosMove(calStage);
             switch(calStage) {
                 case Cali_Init:
                   break;
@@ -1782,71 +2096,48 @@ void ExecCalMode()
                   bottomOffset = 0;         
                   leftOffset = 0; 
                   rightOffset = 0;
-                  // Set Cam center offsets
-                  if(profileData[selectedProfile].irLayout) {
-                      profileData[selectedProfile].adjX = (OpenFIREdiamond.testMedianX() - (512 << 2)) * cos(OpenFIREdiamond.Ang()) - (OpenFIREdiamond.testMedianY() - (384 << 2)) * sin(OpenFIREdiamond.Ang()) + (512 << 2);       
-                      profileData[selectedProfile].adjY = (OpenFIREdiamond.testMedianX() - (512 << 2)) * sin(OpenFIREdiamond.Ang()) + (OpenFIREdiamond.testMedianY() - (384 << 2)) * cos(OpenFIREdiamond.Ang()) + (384 << 2);
-                  } else {
-                      profileData[selectedProfile].adjX = (OpenFIREsquare.testMedianX() - (512 << 2)) * cos(OpenFIREsquare.Ang()) - (OpenFIREsquare.testMedianY() - (384 << 2)) * sin(OpenFIREsquare.Ang()) + (512 << 2);       
-                      profileData[selectedProfile].adjY = (OpenFIREsquare.testMedianX() - (512 << 2)) * sin(OpenFIREsquare.Ang()) + (OpenFIREsquare.testMedianY() - (384 << 2)) * cos(OpenFIREsquare.Ang()) + (384 << 2);
-                      // Work out Led locations by assuming height is 100%
-                      profileData[selectedProfile].TLled = (res_x / 2) - ( (OpenFIREsquare.W() * (res_y  / OpenFIREsquare.H()) ) / 2);            
-                      profileData[selectedProfile].TRled = (res_x / 2) + ( (OpenFIREsquare.W() * (res_y  / OpenFIREsquare.H()) ) / 2);
-                  }
-                  
-                  // Update Cam centre in perspective library
-                  OpenFIREper.source(profileData[selectedProfile].adjX, profileData[selectedProfile].adjY);                                                          
-                  OpenFIREper.deinit(0);
+                  // Set Cam center offsets & LED anchors
+                  CaliCamCenter(true);
                   // Move to top calibration point
-                  AbsMouse5.move(32768/2, 0);
+                  glide.Start(32768/2, 32768/2, 32768/2, 0, micros());
                   break;
 
                 case Cali_Bottom:
                   // Set Offset buffer
-                  topOffset = mouseY;
+                  topOffset = steady.y;
                   // Move to bottom calibration point
-                  AbsMouse5.move(32768/2, 32767);
+                  glide.Start(32768/2, 0, 32768/2, 32767, micros());
                   break;
 
                 case Cali_Left:
                   // Set Offset buffer
-                  bottomOffset = (res_y - mouseY);
+                  bottomOffset = (res_y - steady.y);
                   // Move to left calibration point
-                  AbsMouse5.move(0, 32768/2);
+                  glide.Start(32768/2, 32767, 0, 32768/2, micros());
                   break;
 
                 case Cali_Right:
                   // Set Offset buffer
-                  leftOffset = mouseX;
+                  leftOffset = steady.x;
                   // Move to right calibration point
-                  AbsMouse5.move(32767, 32768/2);
+                  glide.Start(0, 32768/2, 32767, 32768/2, micros());
                   break;
 
                 case Cali_Center:
                   // Set Offset buffer
-                  rightOffset = (res_x - mouseX);
-                  delay(100);
+                  rightOffset = (res_x - steady.x);
                   // Save Offset buffer to profile
                   profileData[selectedProfile].topOffset = topOffset;
                   profileData[selectedProfile].bottomOffset = bottomOffset;
                   profileData[selectedProfile].leftOffset = leftOffset;
                   profileData[selectedProfile].rightOffset = rightOffset;
                   // Move back to center calibration point
-                  AbsMouse5.move(32768/2, 32768/2);
+                  glide.Start(32767, 32768/2, 32768/2, 32768/2, micros());
                   break;
 
                 case Cali_Verify:
                   // Apply new Cam center offsets with Offsets applied
-                  if(profileData[selectedProfile].irLayout) {
-                      profileData[selectedProfile].adjX = (OpenFIREdiamond.testMedianX() - (512 << 2)) * cos(OpenFIREdiamond.Ang()) - (OpenFIREdiamond.testMedianY() - (384 << 2)) * sin(OpenFIREdiamond.Ang()) + (512 << 2);       
-                      profileData[selectedProfile].adjY = (OpenFIREdiamond.testMedianX() - (512 << 2)) * sin(OpenFIREdiamond.Ang()) + (OpenFIREdiamond.testMedianY() - (384 << 2)) * cos(OpenFIREdiamond.Ang()) + (384 << 2);
-                  } else {
-                      profileData[selectedProfile].adjX = (OpenFIREsquare.testMedianX() - (512 << 2)) * cos(OpenFIREsquare.Ang()) - (OpenFIREsquare.testMedianY() - (384 << 2)) * sin(OpenFIREsquare.Ang()) + (512 << 2);       
-                      profileData[selectedProfile].adjY = (OpenFIREsquare.testMedianX() - (512 << 2)) * sin(OpenFIREsquare.Ang()) + (OpenFIREsquare.testMedianY() - (384 << 2)) * cos(OpenFIREsquare.Ang()) + (384 << 2);
-                  }
-                  // Update Cam centre in perspective library
-                  OpenFIREper.source(profileData[selectedProfile].adjX, profileData[selectedProfile].adjY);
-                  OpenFIREper.deinit(0);
+                  CaliCamCenter(false);
 
                   // let the user test.
                   SetMode(GunMode_Verification);
@@ -1855,7 +2146,12 @@ void ExecCalMode()
                       if(irPosUpdateTick) {
                           irPosUpdateTick = 0;
                           GetPosition();
+                          #ifdef LED_ENABLE
+                              LedService();
+                          #endif // LED_ENABLE
                       }
+                      // composite mode: the verification cursor goes out here
+                      TinyUSBDevices.flush();
                       // If it's good, move onto cali finish.
                       if(buttons.pressed == BtnMask_Trigger) {
                           calStage++;
@@ -1882,6 +2178,7 @@ void ExecCalMode()
                           profileData[selectedProfile].TRled = _TRled;
                           profileData[selectedProfile].adjX = _adjX;
                           profileData[selectedProfile].adjY = _adjY;
+                          calibrationData[selectedProfile] = _calibration;
                           // re-print the profile
                           stateFlags |= StateFlag_PrintSelectedProfile;
                           // re-apply the cal stored in the profile
@@ -1898,7 +2195,12 @@ void ExecCalMode()
             }
         }
     }
-    // Break Cali
+    CaliFinish();
+}
+
+// Wraps up a finished calibration: saves it if it's the first, reports back if docked.
+void CaliFinish()
+{
     if(justBooted) {
         // If this is an initial calibration, save it immediately!
         stateFlags |= StateFlag_SavePreferencesEn;
@@ -1931,158 +2233,403 @@ void ExecCalMode()
     #endif // USES_RUMBLE
 }
 
-// Locking function moving from cali point to point
-void CaliMousePosMove(uint8_t caseNumber)
+// Grid calibration: center first for the camera center, then each point of a side x side grid,
+// with a least-squares homography + radial fit over all of them.
+// For screens where the corners don't land where the edges say they should (curved panels, projectors).
+void ExecGridCalMode(uint8_t side)
 {
-    int32_t xPos;
-    int32_t yPos;
-
-    // Note: All TinyUSB device updates are blocking when a previous signal hasn't finished transmitting,
-    // so we skip chunks to speed things the hell up.
-    // These originally were inc/decrementing by 1 with a 20us delay between.
-
-    switch(caseNumber) {
-        case Cali_Top:
-          for(yPos = 32768/2; yPos > 0; yPos = yPos - 30) {
-              if(yPos < 31) { yPos = 0; }
-              AbsMouse5.move(32768/2, yPos);
-          }
-          delay(5);
-          break;
-        case Cali_Bottom:
-          for(yPos = 0; yPos < 32767; yPos = yPos + 30) {
-              if(yPos > 32767-31) { yPos = 32767; }
-              AbsMouse5.move(32768/2, yPos);
-          }
-          delay(5);
-          break;
-        case Cali_Left:
-          yPos = 32767;
-          for(xPos = 32768/2; xPos > 0; xPos = xPos - 30) {
-              if(xPos < 31) { xPos = 0; }
-              if(yPos > 32768/2) { yPos = yPos - 30; }
-              else { yPos = 32768/2; }
-              AbsMouse5.move(xPos, yPos);
-          }
-          delay(5);
-          break;
-        case Cali_Right:
-          for(xPos = 0; xPos < 32767; xPos = xPos + 30) {
-              if(xPos > 32767-31) { xPos = 32767; }
-              AbsMouse5.move(xPos, 32768/2);
-          }
-          delay(5);
-          break;
-        case Cali_Center:
-          for(xPos = 32767; xPos > 32768/2; xPos = xPos - 30) {
-              if(xPos < 32768/2) { xPos = 32768/2; }
-              AbsMouse5.move(xPos, 32768/2);
-          }
-          delay(5);
-          break;
-        default:
-          break;
+    buttons.ReportDisable();
+    uint8_t points = side * side;
+    // backup current values in case the user cancels
+    int _topOffset = profileData[selectedProfile].topOffset;
+    int _bottomOffset = profileData[selectedProfile].bottomOffset;
+    int _leftOffset = profileData[selectedProfile].leftOffset;
+    int _rightOffset = profileData[selectedProfile].rightOffset;
+    float _TLled = profileData[selectedProfile].TLled;
+    float _TRled = profileData[selectedProfile].TRled;
+    float _adjX = profileData[selectedProfile].adjX;
+    float _adjY = profileData[selectedProfile].adjY;
+    CalibrationFit_t _calibration = calibrationData[selectedProfile];
+    // no correction while sampling, so each sample is the bare perspective output
+    profileData[selectedProfile].topOffset = 0, profileData[selectedProfile].bottomOffset = 0,
+    profileData[selectedProfile].leftOffset = 0, profileData[selectedProfile].rightOffset = 0;
+    calibrationData[selectedProfile] = {};
+
+    OpenFIRE_Calibration grid;
+    // -1 is the center shot, points is verification
+    int8_t point = -1;
+    // current target, in screen resolution & mouse units
+    int targetX = res_x / 2, targetY = res_y / 2;
+    uint16_t mouseTargetX = 32768/2, mouseTargetY = 32768/2;
+    // cursor moves between targets, and the aim sample taken at each
+    CalGlide glide;
+    CalSteady steady;
+    bool aimed = false;
+
+    AbsMouse5.move(mouseTargetX, mouseTargetY);
+    SetMode(GunMode_Calibration);
+    while(gunMode == GunMode_Calibration || gunMode == GunMode_Verification) {
+        buttons.Poll(1);
+
+        if(irPosUpdateTick) {
+            irPosUpdateTick = 0;
+            if(GetPosition() && steady.Armed()) {
+                aimed = steady.Feed(frameSample.filteredX, frameSample.filteredY, micros());
+            }
+            #ifdef LED_ENABLE
+                LedService();
+            #endif // LED_ENABLE
+        }
+        CaliGlideStep(glide);
+
+        bool verifying = (point == points);
+        // A/B while verifying restarts, C/Home cancels; either cancels while sampling
+        if(verifying && (buttons.pressedReleased & ExitPauseModeHoldBtnMask)) {
+            point = -1;
+            calibrationData[selectedProfile] = {};
+            profileData[selectedProfile].adjX = 512 << 2, profileData[selectedProfile].adjY = 384 << 2;
+            SetMode(GunMode_Calibration);
+            delay(1);
+            mouseTargetX = 32768/2, mouseTargetY = 32768/2;
+            AbsMouse5.move(mouseTargetX, mouseTargetY);
+        } else if((buttons.pressedReleased & (verifying ? ExitPauseModeBtnMask : (ExitPauseModeBtnMask | ExitPauseModeHoldBtnMask))) && !justBooted) {
+            Serial.println("Calibration cancelled");
+            // Reapplying backed up data
+            profileData[selectedProfile].topOffset = _topOffset;
+            profileData[selectedProfile].bottomOffset = _bottomOffset;
+            profileData[selectedProfile].leftOffset = _leftOffset;
+            profileData[selectedProfile].rightOffset = _rightOffset;
+            profileData[selectedProfile].TLled = _TLled;
+            profileData[selectedProfile].TRled = _TRled;
+            profileData[selectedProfile].adjX = _adjX;
+            profileData[selectedProfile].adjY = _adjY;
+            calibrationData[selectedProfile] = _calibration;
+            OpenFIREper.source(_adjX, _adjY);
+            OpenFIREper.deinit(0);
+            // re-print the profile
+            stateFlags |= StateFlag_PrintSelectedProfile;
+            if(dockedCalibrating) {
+                SetMode(GunMode_Docked);
+                dockedCalibrating = false;
+            } else {
+                SetMode(GunMode_Run);
+            }
+            return;
+        } else if(buttons.pressed == BtnMask_Trigger && verifying) {
+            // If it's good, move onto cali finish.
+            break;
+        } else if(buttons.pressed == BtnMask_Trigger && !glide.Active() && !steady.Armed()) {
+            // sample once the aim's settled, rather than wherever the trigger pull jolted it to
+            steady.Arm(micros());
+        } else if(aimed) {
+            aimed = false;
+            if(point < 0) {
+                CaliCamCenter(true);
+                grid.begin(res_x, res_y);
+            } else {
+                grid.add(steady.x, steady.y, targetX, targetY);
+            }
+            point++;
+
+            if(point < points) {
+                // on to the next grid point
+                OpenFIRE_Calibration::target(side, point, res_x, res_y, targetX, targetY);
+                uint16_t nextX = map(targetX, 0, res_x, 0, 32767);
+                uint16_t nextY = map(targetY, 0, res_y, 0, 32767);
+                glide.Start(mouseTargetX, mouseTargetY, nextX, nextY, micros());
+                mouseTargetX = nextX, mouseTargetY = nextY;
+            } else if(grid.fit(calibrationData[selectedProfile])) {
+                Serial.print("Grid fit residual: ");
+                Serial.println(grid.residual());
+                // let the user test.
+                SetMode(GunMode_Verification);
+            } else {
+                Serial.println("Grid fit failed, starting over");
+                point = -1;
+                glide.Start(mouseTargetX, mouseTargetY, 32768/2, 32768/2, micros());
+                mouseTargetX = 32768/2, mouseTargetY = 32768/2;
+            }
+        }
+    }
+    SetMode(GunMode_Run);
+    CaliFinish();
+}
+
+// Sets the camera center from where the gun's aimed right now (should be the middle of the screen),
+// and for square layouts, works out the LED anchors too if asked to.
+void CaliCamCenter(bool setAnchors)
+{
+    if(profileData[selectedProfile].irLayout) {
+        profileData[selectedProfile].adjX = (OpenFIREdiamond.testMedianX() - (512 << 2)) * cos(OpenFIREdiamond.Ang()) - (OpenFIREdiamond.testMedianY() - (384 << 2)) * sin(OpenFIREdiamond.Ang()) + (512 << 2);       
+        profileData[selectedProfile].adjY = (OpenFIREdiamond.testMedianX() - (512 << 2)) * sin(OpenFIREdiamond.Ang()) + (OpenFIREdiamond.testMedianY() - (384 << 2)) * cos(OpenFIREdiamond.Ang()) + (384 << 2);
+    } else {
+        profileData[selectedProfile].adjX = (OpenFIREsquare.testMedianX() - (512 << 2)) * cos(OpenFIREsquare.Ang()) - (OpenFIREsquare.testMedianY() - (384 << 2)) * sin(OpenFIREsquare.Ang()) + (512 << 2);       
+        profileData[selectedProfile].adjY = (OpenFIREsquare.testMedianX() - (512 << 2)) * sin(OpenFIREsquare.Ang()) + (OpenFIREsquare.testMedianY() - (384 << 2)) * cos(OpenFIREsquare.Ang()) + (384 << 2);
+        if(setAnchors) {
+            // Work out Led locations by assuming height is 100%
+            profileData[selectedProfile].TLled = (res_x / 2) - ( (OpenFIREsquare.W() * (res_y  / OpenFIREsquare.H()) ) / 2);            
+            profileData[selectedProfile].TRled = (res_x / 2) + ( (OpenFIREsquare.W() * (res_y  / OpenFIREsquare.H()) ) / 2);
+        }
+    }
+
+    // Update Cam centre in perspective library
+    OpenFIREper.source(profileData[selectedProfile].adjX, profileData[selectedProfile].adjY);
+    OpenFIREper.deinit(0);
+}
+
+// Sends the calibration cursor's next glide position, if one's due this USB frame
+void CaliGlideStep(CalGlide &glide)
+{
+    uint16_t x, y;
+    if(glide.Tick(micros(), TinyUSBDevices.ready(), x, y)) {
+        AbsMouse5.move(x, y);
     }
+    // composite mode: the cursor only goes out on a flush
+    TinyUSBDevices.flush();
 }
 
-// Get tilt adjusted position from IR postioning camera
-// Updates finalX and finalY values
-void GetPosition()
+#ifdef AUTO_RECALIBRATE
+// Feeds the background LED anchor refinement from the square tracker's latest frame,
+// and applies whatever small step it decides on straight to the profile.
+void AutoCalStep()
 {
+    // only learn from frames like the one calibration used: all LEDs in view, aimed near the middle
+    bool usable = OpenFIREsquare.seen() == 0x0F &&
+                  abs(OpenFIREsquare.testMedianX() - profileData[selectedProfile].adjX) < AUTOCAL_CENTER_RADIUS &&
+                  abs(OpenFIREsquare.testMedianY() - profileData[selectedProfile].adjY) < AUTOCAL_CENTER_RADIUS;
+    float tl, tr;
+    if(OF_AutoCal.Feed(profileData[selectedProfile].TLled, profileData[selectedProfile].TRled,
+                       OpenFIREsquare.W(), OpenFIREsquare.H(), usable, tl, tr)) {
+        profileData[selectedProfile].TLled = tl;
+        profileData[selectedProfile].TRled = tr;
+    }
+}
+#endif // AUTO_RECALIBRATE
+
+// Folds the offset map, the mouse resolution map & 4:3 correction into one map per axis.
+// Only rebuilt when the profile's offsets, grid fit or AR correction state actually change.
+void UpdateOutputMap()
+{
+    // a grid fit already lands in screen resolution, so the offsets are skipped
+    bool fitted = calibrationData[selectedProfile].points;
+    int32_t key[6] = {
+        fitted ? 0 : profileData[selectedProfile].topOffset,
+        fitted ? 0 : profileData[selectedProfile].bottomOffset,
+        fitted ? 0 : profileData[selectedProfile].leftOffset,
+        fitted ? 0 : profileData[selectedProfile].rightOffset,
+        // AR correction only ever applied to run mode output
+        serialARcorrection && gunMode == GunMode_Run,
+        fitted
+    };
+    if(outputMapValid && !memcmp(key, outputMapKey, sizeof(key))) {
+        return;
+    }
+    memcpy(outputMapKey, key, sizeof(key));
+    outputMapValid = true;
+
+    // Offsets are measured in pixels at screen resolution
+    outputMapX.reset();
+    outputMapX.map(0, res_x, 0 - key[2], res_x + key[3]);
+    outputMapX.map(0, res_x, 0, 32767);
+    if(key[4]) {
+        outputMapX.map(4147, 28697, 0, 32767);
+    }
+    outputMapX.bake();
+
+    outputMapY.reset();
+    outputMapY.map(0, res_y, 0 - key[0], res_y + key[1]);
+    outputMapY.map(0, res_y, 0, 32767);
+    outputMapY.bake();
+}
+
+// Reads the IR camera, and points camX/camY/camSeen at this frame's LEDs.
+// With a second camera, both are read together and their LEDs are fused into the first camera's view.
+// Returns an error code from DFRobotIRPositionEx::Errors_e, for the first camera.
+int CameraRead(const int* &camX, const int* &camY, unsigned int &camSeen)
+{
+    #ifdef DUAL_CAMERA
+    if(dfrIRPos2 != nullptr) {
+        int error2;
+        int error = dfrIRPos->basicAtomicPair(*dfrIRPos2, error2, DFRobotIRPositionEx::Retry_2);
+        if(error == DFRobotIRPositionEx::Error_Success) {
+            // a bad read on the second camera just leaves it out of this frame
+            OpenFIREfusion.begin(dfrIRPos->xPositions(), dfrIRPos->yPositions(), dfrIRPos->seen(),
+                                 dfrIRPos2->xPositions(), dfrIRPos2->yPositions(),
+                                 error2 == DFRobotIRPositionEx::Error_Success ? dfrIRPos2->seen() : 0);
+            camX = OpenFIREfusion.xPositions();
+            camY = OpenFIREfusion.yPositions();
+            camSeen = OpenFIREfusion.seen();
+        }
+        return error;
+    }
+    #endif // DUAL_CAMERA
     int error = dfrIRPos->basicAtomic(DFRobotIRPositionEx::Retry_2);
+    camX = dfrIRPos->xPositions();
+    camY = dfrIRPos->yPositions();
+    camSeen = dfrIRPos->seen();
+    return error;
+}
+
+// Positioning pipeline stages: each fills in its part of the frame, in order (see FrameSample_t).
+
+// Reads the camera into the frame's raw points & seen mask.
+// Returns an error code from DFRobotIRPositionEx::Errors_e; the points are only filled in on success.
+int FrameRead(FrameSample_t &frame)
+{
+    frame.timestamp = micros();
+    const int *camX, *camY;
+    unsigned int camSeen;
+    int error = CameraRead(camX, camY, camSeen);
     if(error == DFRobotIRPositionEx::Error_Success) {
-        // if diamond layout, or square
-        if(profileData[selectedProfile].irLayout) {
-            OpenFIREdiamond.begin(dfrIRPos->xPositions(), dfrIRPos->yPositions(), dfrIRPos->seen());
-            OpenFIREper.warp(OpenFIREdiamond.X(0), OpenFIREdiamond.Y(0),
-                             OpenFIREdiamond.X(1), OpenFIREdiamond.Y(1),
-                             OpenFIREdiamond.X(2), OpenFIREdiamond.Y(2),
-                             OpenFIREdiamond.X(3), OpenFIREdiamond.Y(3),
-                             res_x / 2, 0, 0,
-                             res_y / 2, res_x / 2,
-                             res_y, res_x, res_y / 2);
-        } else {
-            OpenFIREsquare.begin(dfrIRPos->xPositions(), dfrIRPos->yPositions(), dfrIRPos->seen());
-            OpenFIREper.warp(OpenFIREsquare.X(0), OpenFIREsquare.Y(0),
-                             OpenFIREsquare.X(1), OpenFIREsquare.Y(1),
-                             OpenFIREsquare.X(2), OpenFIREsquare.Y(2),
-                             OpenFIREsquare.X(3), OpenFIREsquare.Y(3),
-                             profileData[selectedProfile].TLled, 0,
-                             profileData[selectedProfile].TRled, 0,
-                             profileData[selectedProfile].TLled, res_y,
-                             profileData[selectedProfile].TRled, res_y);
+        for(int i = 0; i < 4; i++) {
+            frame.rawX[i] = camX[i];
+            frame.rawY[i] = camY[i];
         }
+        frame.seen = camSeen;
+    }
+    frame.timeCam = micros() - frame.timestamp;
+    return error;
+}
 
-        // Output mapped to screen resolution because offsets are measured in pixels
-        mouseX = map(OpenFIREper.getX(), 0, res_x, (0 - profileData[selectedProfile].leftOffset), (res_x + profileData[selectedProfile].rightOffset));                 
-        mouseY = map(OpenFIREper.getY(), 0, res_y, (0 - profileData[selectedProfile].topOffset), (res_y + profileData[selectedProfile].bottomOffset));
-
-        switch(runMode) {
-            case RunMode_Average:
-                // 2 position moving average
-                moveIndex ^= 1;
-                moveXAxisArr[moveIndex] = mouseX;
-                moveYAxisArr[moveIndex] = mouseY;
-                mouseX = (moveXAxisArr[0] + moveXAxisArr[1]) / 2;
-                mouseY = (moveYAxisArr[0] + moveYAxisArr[1]) / 2;
-                break;
-            case RunMode_Average2:
-                // weighted average of current position and previous 2
-                if(moveIndex < 2) {
-                    ++moveIndex;
-                } else {
-                    moveIndex = 0;
-                }
-                moveXAxisArr[moveIndex] = mouseX;
-                moveYAxisArr[moveIndex] = mouseY;
-                mouseX = (mouseX + moveXAxisArr[0] + moveXAxisArr[1] + moveXAxisArr[2]) / 4;
-                mouseY = (mouseY + moveYAxisArr[0] + moveYAxisArr[1] + moveYAxisArr[2]) / 4;
-                break;
-            default:
-                break;
+// Solves the LED corners from the raw points, and warps them into the screen's space.
+void FrameSolve(FrameSample_t &frame)
+{
+    uint32_t stamp = micros();
+    int px[4], py[4];
+    for(int i = 0; i < 4; i++) {
+        px[i] = frame.rawX[i];
+        py[i] = frame.rawY[i];
+    }
+    // if diamond layout, or square
+    frame.layout = profileData[selectedProfile].irLayout;
+    if(frame.layout) {
+        OpenFIREdiamond.begin(px, py, frame.seen);
+        for(int i = 0; i < 4; i++) {
+            frame.cornerX[i] = OpenFIREdiamond.X(i);
+            frame.cornerY[i] = OpenFIREdiamond.Y(i);
+        }
+    } else {
+        OpenFIREsquare.begin(px, py, frame.seen);
+        for(int i = 0; i < 4; i++) {
+            frame.cornerX[i] = OpenFIREsquare.X(i);
+            frame.cornerY[i] = OpenFIREsquare.Y(i);
+        }
+    }
+    uint32_t stampWarp = micros();
+    frame.timeSolve = stampWarp - stamp;
+
+    if(frame.layout) {
+        OpenFIREper.warp(frame.cornerX[0], frame.cornerY[0],
+                         frame.cornerX[1], frame.cornerY[1],
+                         frame.cornerX[2], frame.cornerY[2],
+                         frame.cornerX[3], frame.cornerY[3],
+                         res_x / 2, 0, 0,
+                         res_y / 2, res_x / 2,
+                         res_y, res_x, res_y / 2);
+    } else {
+        OpenFIREper.warp(frame.cornerX[0], frame.cornerY[0],
+                         frame.cornerX[1], frame.cornerY[1],
+                         frame.cornerX[2], frame.cornerY[2],
+                         frame.cornerX[3], frame.cornerY[3],
+                         profileData[selectedProfile].TLled, 0,
+                         profileData[selectedProfile].TRled, 0,
+                         profileData[selectedProfile].TLled, res_y,
+                         profileData[selectedProfile].TRled, res_y);
+        #ifdef AUTO_RECALIBRATE
+            if(gunMode == GunMode_Run) {
+                AutoCalStep();
             }
+        #endif // AUTO_RECALIBRATE
+    }
+    frame.warpX = OpenFIREper.getX();
+    frame.warpY = OpenFIREper.getY();
+    frame.timeWarp = micros() - stampWarp;
+}
 
-        // Constrain that bisch so negatives don't cause underflow
-        int32_t conMoveX = constrain(mouseX, 0, res_x);
-        int32_t conMoveY = constrain(mouseY, 0, res_y);
+// Runs the warped point through the grid fit if there is one, then averages it over the last few frames, as the run mode asks.
+void FrameFilter(FrameSample_t &frame)
+{
+    uint32_t stamp = micros();
 
-        // Output mapped to Mouse resolution
-        conMoveX = map(conMoveX, 0, res_x, 0, 32767);
-        conMoveY = map(conMoveY, 0, res_y, 0, 32767);
+    int x = frame.warpX;
+    int y = frame.warpY;
 
-        if(gunMode == GunMode_Run) {
-            UpdateLastSeen();
+    // A grid fit isn't linear, so it goes first: averaging before it would bend the average of a fast sweep.
+    // Everything after averaging is a straight linear map, so all of that still folds into one.
+    if(calibrationData[selectedProfile].points) {
+        // homography + radial correction in one go, already in screen resolution
+        OpenFIRE_Calibration::apply(calibrationData[selectedProfile], res_x, res_y, frame.warpX, frame.warpY, x, y);
+    }
 
-            if(serialARcorrection) {
-                conMoveX = map(conMoveX, 4147, 28697, 0, 32767);
-                conMoveX = constrain(conMoveX, 0, 32767);
-            }
+    switch(runMode) {
+        case RunMode_Average:
+            moveAverage.pair(x, y);
+            break;
+        case RunMode_Average2:
+            moveAverage.weighted(x, y);
+            break;
+        default:
+            break;
+        }
 
-            bool offXAxis = false;
-            bool offYAxis = false;
+    frame.filteredX = x;
+    frame.filteredY = y;
+    frame.timeFilter = micros() - stamp;
+}
 
-            if(conMoveX == 0 || conMoveX == 32767) {
-                offXAxis = true;
-            }
-            
-            if(conMoveY == 0 || conMoveY == 32767) {
-                offYAxis = true;
-            }
+// Maps the filtered point out to the host's range, and flags it if it's off screen.
+void FrameOutput(FrameSample_t &frame)
+{
+    uint32_t stamp = micros();
 
-            if(offXAxis || offYAxis) {
-                buttons.offScreen = true;
-            } else {
-                buttons.offScreen = false;
-            }
+    // Offsets, mouse resolution & AR correction in a single multiply per axis
+    UpdateOutputMap();
+    frame.outX = outputMapX.apply(frame.filteredX);
+    frame.outY = outputMapY.apply(frame.filteredY);
 
-            if(buttons.analogOutput) {
-                Gamepad16.moveCam(conMoveX, conMoveY);
-            } else {
-                AbsMouse5.move(conMoveX, conMoveY);
-            }
+    // Constrain that bisch so negatives don't cause underflow
+    frame.hidX = constrain(frame.outX, 0, 32767);
+    frame.hidY = constrain(frame.outY, 0, 32767);
+
+    frame.offScreen = frame.hidX == 0 || frame.hidX == 32767 ||
+                      frame.hidY == 0 || frame.hidY == 32767;
+    frame.timeFilter += micros() - stamp;
+}
+
+// Runs a camera frame through the pipeline into frameSample, and sends it on as the mode calls for.
+// Returns true if the camera gave a fresh position this time.
+bool GetPosition()
+{
+    FrameSample_t frame = {};
+    int error = FrameRead(frame);
+    if(error == DFRobotIRPositionEx::Error_Success) {
+        FrameSolve(frame);
+        FrameFilter(frame);
+        FrameOutput(frame);
+        frameSample = frame;
+
+        if(gunMode == GunMode_Run) {
+            UpdateLastSeen();
+
+            buttons.offScreen = frame.offScreen;
+
+            #ifdef USB_HIGH_RATE
+                // sent out by PointerPaceStep() in the next free slot
+                OF_Pacer.Sample(frame.hidX, frame.hidY, frame.timestamp);
+            #else
+                if(buttons.analogOutput) {
+                    Gamepad16.moveCam(frame.hidX, frame.hidY);
+                } else {
+                    AbsMouse5.move(frame.hidX, frame.hidY);
+                }
+            #endif // USB_HIGH_RATE
         } else if(gunMode == GunMode_Verification) {
-            AbsMouse5.move(conMoveX, conMoveY);
+            AbsMouse5.move(frame.hidX, frame.hidY);
         } else {
+            // Telemetry goes out every frame, the text output & OLED stay throttled below
+            if(OF_Telemetry.active && runMode == RunMode_Processing && !dockedSaving) {
+                OF_Telemetry.Send(frame, buttons.debounced, profileData[selectedProfile].runMode);
+            }
             if(millis() - testLastStamp > testPrintInterval) {
                 testLastStamp = millis();
                 // RAW Camera Output mapped to screen res (1920x1080)
@@ -2090,24 +2637,23 @@ void GetPosition()
                 int rawY[4];
                 // RAW Output for viewing in processing sketch mapped to 1920x1080 screen resolution
                 for (int i = 0; i < 4; i++) {
-                    if(profileData[selectedProfile].irLayout) {
-                        rawX[i] = map(OpenFIREdiamond.X(i), 0, 1023 << 2, 1920, 0);
-                        rawY[i] = map(OpenFIREdiamond.Y(i), 0, 768 << 2, 0, 1080);
+                    if(frame.layout) {
+                        rawX[i] = map(frame.cornerX[i], 0, 1023 << 2, 1920, 0);
                     } else {
-                        rawX[i] = map(OpenFIREsquare.X(i), 0, 1023 << 2, 0, 1920);
-                        rawY[i] = map(OpenFIREsquare.Y(i), 0, 768 << 2, 0, 1080);
+                        rawX[i] = map(frame.cornerX[i], 0, 1023 << 2, 0, 1920);
                     }
+                    rawY[i] = map(frame.cornerY[i], 0, 768 << 2, 0, 1080);
                 }
-                if(runMode == RunMode_Processing) {
+                if(runMode == RunMode_Processing && !OF_Telemetry.active) {
                     for(int i = 0; i < 4; i++) {
                         Serial.print(rawX[i]);
                         Serial.print( "," );
                         Serial.print(rawY[i]);
                         Serial.print( "," );
                     }
-                    Serial.print( mouseX / 4 );
+                    Serial.print(map(frame.outX, 0, 32767, 0, 1920));
                     Serial.print( "," );
-                    Serial.print( mouseY / 4 );
+                    Serial.print(map(frame.outY, 0, 32767, 0, 1080));
                     Serial.print( "," );
                     // Median for viewing in processing
                     if(profileData[selectedProfile].irLayout) {
@@ -2128,8 +2674,94 @@ void GetPosition()
     } else if(error != DFRobotIRPositionEx::Error_DataMismatch) {
         Serial.println("Device not available!");
     }
+    return error == DFRobotIRPositionEx::Error_Success;
+}
+
+#ifdef USB_HIGH_RATE
+// Sends the cursor out if the pacer says this slot's due & the position's changed.
+// Called every pass of the run mode loop; only checks the endpoint, never waits on it.
+void PointerPaceStep()
+{
+    uint16_t x, y;
+    if(OF_Pacer.Tick(micros(), TinyUSBDevices.ready(), x, y)) {
+        if(buttons.analogOutput) {
+            Gamepad16.moveCam(x, y);
+        } else {
+            AbsMouse5.move(x, y);
+        }
+    }
+}
+#endif // USB_HIGH_RATE
+
+#ifdef USES_DISPLAY
+// Pushes what HUD changes fit before the next camera read, and notes how much of the frame that left.
+// Called right after each camera read in run mode, on the main core.
+void DisplayFlushStep()
+{
+    #ifdef POWER_SAVE
+        uint32_t nextTick = irPosTickStamp + 1000000 / powerCamRate;
+    #else
+        uint32_t nextTick = irPosTickStamp + 1000000 / IRCamUpdateRate;
+    #endif // POWER_SAVE
+    OLED.FlushStep(ExtDisplay::FlushBudget(micros(), nextTick));
+    int32_t slack = nextTick - micros();
+    if(slack < displaySlackMin) {
+        displaySlackMin = slack;
+    }
+}
+#endif // USES_DISPLAY
+
+#ifdef POWER_SAVE
+// Sets the camera timer to the power saver's rate, and catches up with any activity since the last pass.
+// Called every pass of the run mode loop, on the main core (which is what the camera timer's interrupt runs on).
+void PowerStep()
+{
+    if(!TinyUSBDevices.onBattery || !OF_Power.Update(millis())) {
+        return;
+    }
+    unsigned int rate = OF_Power.Rate(IRCamUpdateRate);
+    if(rate != powerCamRate) {
+        rp2040EnablePWMTimer(0, rate);
+        powerCamRate = rate;
+    }
+    if(!OF_Power.Asleep()) {
+        // don't wait out what's left of a slow frame
+        irPosUpdateTick = 1;
+        irPosTickStamp = micros();
+    }
+}
+
+// Back to the full camera rate, when entering & leaving run mode.
+void PowerReset()
+{
+    OF_Power.Reset(millis());
+    if(powerCamRate != IRCamUpdateRate) {
+        rp2040EnablePWMTimer(0, IRCamUpdateRate);
+        powerCamRate = IRCamUpdateRate;
+    }
+}
+
+// Counts any button held or just released as activity; called right after polling the buttons, on whichever core does that.
+void PowerButtonsStep()
+{
+    if(buttons.debounced || buttons.released) {
+        OF_Power.Poke();
+        if(OF_Power.Asleep()) {
+            // the main core might be sleeping until the next slow frame
+            __sev();
+        }
+    }
 }
 
+// Reads the battery every so often. Called on whichever core is polling the analog pins, so the ADC's never shared between cores.
+void BatteryPoll()
+{
+    if(SamcoPreferences::pins.aBattRead >= 0 && OF_Power.BatteryDue(millis())) {
+        OF_Power.BatterySample(analogRead(SamcoPreferences::pins.aBattRead) * 3300 / 4096);
+    }
+}
+#endif // POWER_SAVE
+
 // wait up to given amount of time for no buttons to be pressed before setting the mode
 void SetModeWaitNoButtons(GunMode_e newMode, unsigned long maxWait)
 {
@@ -2293,6 +2925,7 @@ void SerialProcessingDocked()
               // Toggle Test/Processing Mode
               case 'T':
                 if(runMode == RunMode_Processing) {
+                    OF_Telemetry.active = false;
                     Serial.println("Exiting processing mode...");
                     switch(profileData[selectedProfile].runMode) {
                         case RunMode_Normal:
@@ -2310,12 +2943,54 @@ void SerialProcessingDocked()
                     SetRunMode(RunMode_Processing);
                 }
                 break;
+              // Enter Test Mode w/ binary telemetry output, one record per camera frame
+              case 'D':
+                if(runMode != RunMode_Processing) {
+                    Serial.println("Entering Telemetry Mode...");
+                    OF_Telemetry.Reset();
+                    OF_Telemetry.active = true;
+                    SetRunMode(RunMode_Processing);
+                }
+                break;
               // Enter Docked Mode
               case 'P':
                 SetMode(GunMode_Docked);
                 break;
+              #ifdef USB_HIGH_RATE
+              // Cursor pacing: 0/1 sets prediction, anything else prints the last second's stats
+              case 'U':
+                serialInput = Serial.read();
+                if(serialInput == '0' || serialInput == '1') {
+                    OF_Pacer.predict = serialInput == '1';
+                    Serial.printf("Cursor prediction %s\r\n", OF_Pacer.predict ? "enabled" : "disabled");
+                } else {
+                    Serial.printf("PacerStats: %u,%u,%u,%u\r\n",
+                    OF_Pacer.stats.reports,
+                    OF_Pacer.stats.dropped,
+                    OF_Pacer.stats.ageAvg,
+                    OF_Pacer.stats.ageMax);
+                }
+                break;
+              #endif // USB_HIGH_RATE
+              #ifdef USES_DISPLAY
+              // Least camera frame time left after a HUD flush since the last ask, in microseconds
+              case 'F':
+                Serial.printf("DisplaySlack: %ld\r\n", displaySlackMin == INT32_MAX ? -1L : (long)displaySlackMin);
+                displaySlackMin = INT32_MAX;
+                break;
+              #endif // USES_DISPLAY
+              // Boot timing breakdown, in microseconds since power on
+              case 'I':
+                Serial.printf("BootTimes: %lu,%lu,%lu,%lu,%lu\r\n",
+                bootTimes.prefs,
+                bootTimes.camera,
+                bootTimes.peripherals,
+                bootTimes.usb,
+                bootTimes.firstReport);
+                break;
               // Exit Docked Mode
               case 'E':
+                OF_Telemetry.active = false;
                 if(!justBooted) {
                     SetMode(GunMode_Run);
                 } else {
@@ -2343,10 +3018,18 @@ void SerialProcessingDocked()
                     Serial.println(i-1);
                     if(Serial.peek() == 'C') {
                         Serial.read(); // nomf
+                        calGridRequest = 0;
                         dockedCalibrating = true;
                         //Serial.print("Now calibrating selected profile: ");
                         //Serial.println(profileDesc[selectedProfile].profileLabel);
                         SetMode(GunMode_Calibration);
+                    } else if(Serial.peek() == 'G') {
+                        // grid calibration: 'G3' for 3x3, 'G4' for 4x4
+                        Serial.read(); // nomf
+                        byte side = Serial.read() - '0';
+                        calGridRequest = (side == 4) ? 4 : 3;
+                        dockedCalibrating = true;
+                        SetMode(GunMode_Calibration);
                     }
                 }
                 break;
@@ -2357,18 +3040,9 @@ void SerialProcessingDocked()
                 // Update bindings so LED/Pixel changes are reflected immediately
                 FeedbackSet();
                 // dockedSaving flag is set by Xm, since that's required anyways for this to make any sense.
+                // (this only stages it; "Settings saved" is sent once the flash write actually finishes)
                 SavePreferences();
                 // load everything back to commit custom pins setting to memory
-                if(nvPrefsError == SamcoPreferences::Error_Success) {
-                    #ifdef LED_ENABLE
-                    // Save op above resets color, so re-set it back to docked idle color
-                    if(gunMode == GunMode_Docked) {
-                        LedUpdate(127, 127, 255);
-                    } else if(gunMode == GunMode_Pause) {
-                        SetLedPackedColor(profileData[selectedProfile].color);
-                    }
-                    #endif // LED_ENABLE
-                }
                 CameraSet();
                 if(SamcoPreferences::usb.devicePID >= 1 && SamcoPreferences::usb.devicePID <= 5) {
                     playerStartBtn = SamcoPreferences::usb.devicePID + '0';
@@ -2381,7 +3055,13 @@ void SerialProcessingDocked()
               // Clear EEPROM.
               case 'c':
                 //Serial.println(EEPROM.length());
+                if(!nvAvailable) {
+                    // Begin() found nowhere safe to keep them, so there's nothing here to erase
+                    Serial.println("No storage to clear!");
+                    break;
+                }
                 dockedSaving = true;
+                saveDefer.Cancel();
                 SamcoPreferences::ResetPreferences();
                 Serial.println("Cleared! Please reset the board.");
                 dockedSaving = false;
@@ -2677,6 +3357,20 @@ void SerialProcessingDocked()
                             Serial.println("OK: Set Temperature Sensor pin.");
                             break;
                           #endif
+                          #ifdef DUAL_CAMERA
+                          case SamcoPreferences::Pin_Camera2SDA:
+                            Serial.read(); // nomf
+                            SamcoPreferences::pins.pCam2SDA = Serial.parseInt();
+                            SamcoPreferences::pins.pCam2SDA = constrain(SamcoPreferences::pins.pCam2SDA, -1, 40);
+                            Serial.println("OK: Set Camera 2 SDA pin.");
+                            break;
+                          case SamcoPreferences::Pin_Camera2SCL:
+                            Serial.read(); // nomf
+                            SamcoPreferences::pins.pCam2SCL = Serial.parseInt();
+                            SamcoPreferences::pins.pCam2SCL = constrain(SamcoPreferences::pins.pCam2SCL, -1, 40);
+                            Serial.println("OK: Set Camera 2 SCL pin.");
+                            break;
+                          #endif
                           default:
                             while(!Serial.available()) {
                               Serial.read(); // nomf it all
@@ -2908,7 +3602,7 @@ void SerialProcessingDocked()
                     break;
                   case 'p':
                     Serial.printf(
-                    "%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i\r\n",
+                    "%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i\r\n",
                     SamcoPreferences::pins.bTrigger,
                     SamcoPreferences::pins.bGunA,
                     SamcoPreferences::pins.bGunB,
@@ -2939,7 +3633,9 @@ void SerialProcessingDocked()
                     SamcoPreferences::pins.aBattRead,
                     SamcoPreferences::pins.aStickX,
                     SamcoPreferences::pins.aStickY,
-                    SamcoPreferences::pins.aTMP36
+                    SamcoPreferences::pins.aTMP36,
+                    SamcoPreferences::pins.pCam2SDA,
+                    SamcoPreferences::pins.pCam2SCL
                     );
                     break;
                   case 's':
@@ -3016,7 +3712,11 @@ void SerialProcessingDocked()
                 }
                 break;
               case 'x':
-                if(Serial.peek() == 'x') { rp2040.rebootToBootloader(); }
+                if(Serial.peek() == 'x') {
+                    // don't lose a save that's still waiting on an idle window
+                    if(saveDefer.Pending()) { saveDefer.Cancel(); SamcoPreferences::Commit(); }
+                    rp2040.rebootToBootloader();
+                }
                 // we probably left the firmware by now, but eh.
                 break;
           }
@@ -3158,7 +3858,11 @@ void SerialProcessing()
                       serialLEDG = 0;
                       serialLEDB = 0;
                       serialLEDChange = false;
-                      if(gunMode == GunMode_Run) { LedOff(); }           // Turn it off, and let lastSeen handle it from here.
+                      if(gunMode == GunMode_Run) {
+                          LedSet(0, Lights::Set_Whole);                  // Turn it off & back to the whole strip, and let lastSeen handle it from here.
+                      } else {
+                          OF_Lights.Gauge(LIGHTS_GAUGE_OFF);             // Back to lighting the whole strip (outside of run mode, this is the main core).
+                      }
                   #endif // LED_ENABLE
                   #ifdef USES_RUMBLE
                       digitalWrite(SamcoPreferences::pins.oRumble, LOW);
@@ -3254,10 +3958,44 @@ void SerialProcessing()
               case 'P':
                 SetMode(GunMode_Docked);
                 break;
+              // Set Mouse Output Type
+              case 'M':
+                serialInput = Serial.read();
+                if(serialInput >= '0' && serialInput < '0' + AbsMouse5_::Pointer_Count) {
+                    AbsMouse5.setMode(serialInput - '0');
+                    switch(AbsMouse5.mode()) {
+                      case AbsMouse5_::Pointer_Relative:
+                        Serial.println("Mouse output set to relative.");
+                        break;
+                      case AbsMouse5_::Pointer_Digitizer:
+                        Serial.println("Mouse output set to digitizer.");
+                        break;
+                      default:
+                        Serial.println("Mouse output set to absolute.");
+                        break;
+                    }
+                } else {
+                    Serial.println("SERIALREAD: No valid mouse output type set! (Expected 0 to 2)");
+                }
+                break;
+              // Toggle Composite Report Output
+              case 'C':
+                serialInput = Serial.read();
+                if(serialInput == '0' || serialInput == '1') {
+                    TinyUSBDevices.setComposite(serialInput == '1');
+                    if(TinyUSBDevices.composite) {
+                        Serial.println("Switched to Composite Report output!");
+                    } else {
+                        Serial.println("Switched to separate Mouse/Keyboard/Gamepad reports!");
+                    }
+                } else {
+                    Serial.println("SERIALREAD: No valid composite output setting! (Expected 0 or 1)");
+                }
+                break;
               default:
                 Serial.println("SERIALREAD: Internal setting command detected, but no valid option found!");
                 Serial.println("Internally recognized commands are:");
-                Serial.println("A(nalog)[L/R] / I(nterval Autofire)2/3/4 / R(emap)1/2/3/4 / P(ause)");
+                Serial.println("A(nalog)[L/R] / I(nterval Autofire)2/3/4 / R(emap)1/2/3/4 / P(ause) / M(ouse)0/1/2 / C(omposite)0/1");
                 break;
           }
           // End of 'X'
@@ -3272,6 +4010,9 @@ void SerialProcessing()
                 Serial.read();                                         // nomf the padding
                 serialInput = Serial.read();                           // Read the next number.
                 if(serialInput == '1') {         // Is it a solenoid "on" command?)
+                    if(!bitRead(serialQueue, 0)) {
+                        Events::Publish(Events::Event_SerialShot);     // Only counts as a shot if it wasn't on already.
+                    }
                     bitSet(serialQueue, 0);                            // Queue the solenoid on bit.
                 } else if(serialInput == '2' &&  // Is it a solenoid pulse command?
                 !bitRead(serialQueue, 1)) {      // (and we aren't already pulsing?)
@@ -3457,8 +4198,8 @@ void SerialProcessing()
                     break;
                   }
                 }
-                // screen is handled by core 0, so just signal that it's ready to go now.
-                serialDisplayChange = true;
+                // screen is handled by core 0, so just hand it the new counts.
+                OLED.PostHUD(serialAmmoCount, serialLifeCount);
                 break;
               #endif // USES_DISPLAY
               #if !defined(USES_SOLENOID) && !defined(USES_RUMBLE) && !defined(LED_ENABLE)
@@ -3484,6 +4225,7 @@ void SerialHandling()
           } else if(bitRead(serialQueue, 1)) {                      // if the solenoid pulse bit is on,
               if(!serialSolPulsesLast) {                            // Have we started pulsing?
                   analogWrite(SamcoPreferences::pins.oSolenoid, 178);                         // Start pulsing it on!
+                  Events::Publish(Events::Event_SerialShot);
                   serialSolPulseOn = true;                               // Set that the pulse cycle is in on.
                   serialSolPulsesLast = 1;                               // Start the sequence.
                   serialSolPulses++;                                     // Cheating and scooting the pulses bit up.
@@ -3497,6 +4239,7 @@ void SerialHandling()
                           serialSolPulsesLastUpdate = millis();          // Timestamp our last pulse event.
                       } else {                                      // Or if we're pulsing off,
                           analogWrite(SamcoPreferences::pins.oSolenoid, 178);                 // Start pulsing it on.
+                          Events::Publish(Events::Event_SerialShot);
                           serialSolPulseOn = true;                       // Set that we're in on.
                           serialSolPulsesLastUpdate = millis();          // Timestamp our last pulse event.
                       }
@@ -3734,6 +4477,12 @@ void SetMode(GunMode_e newMode)
           if(SamcoPreferences::toggles.simpleMenu) { OLED.PauseListUpdate(pauseModeSelection); }
           else { OLED.PauseScreenShow(selectedProfile, profileData[0].name, profileData[1].name, profileData[2].name, profileData[3].name); }
         #endif // USES_DISPLAY
+        #ifdef AUTO_RECALIBRATE
+            // anchors refined in the background get saved now, while nobody's aiming
+            if(OF_AutoCal.Drifted()) {
+                SavePreferences();
+            }
+        #endif // AUTO_RECALIBRATE
         break;
     case GunMode_Docked:
         stateFlags |= StateFlag_SavePreferencesEn;
@@ -4166,6 +4915,10 @@ void VerifyPreferences()
         if(profileData[i].runMode >= RunMode_Count) {
             profileData[i].runMode = RunMode_Normal;
         }
+
+        if(!OpenFIRE_Calibration::valid(calibrationData[i])) {
+            calibrationData[i] = {};
+        }
     }
 
     // if default profile is not valid, use current selected profile instead
@@ -4175,7 +4928,7 @@ void VerifyPreferences()
 }
 
 // Saves profile settings to EEPROM
-// Blinks LEDs (if any) on success or failure.
+// The flash write itself is deferred to SavePreferencesStep(), which reports back when it's done.
 void SavePreferences()
 {
     // Unless the user's Docked,
@@ -4195,30 +4948,61 @@ void SavePreferences()
     // use selected profile as the default
     SamcoPreferences::profiles.selectedProfile = (uint8_t)selectedProfile;
 
+    #ifdef AUTO_RECALIBRATE
+        OF_AutoCal.Persisted();
+    #endif // AUTO_RECALIBRATE
+
 #ifdef SAMCO_FLASH_ENABLE
     nvPrefsError = SamcoPreferences::Save(flash);
 #else
+    // stage every group first, so the whole save is a single flash erase/program (or none if unchanged)
     nvPrefsError = SamcoPreferences::SaveProfiles();
-#endif // SAMCO_FLASH_ENABLE
     if(nvPrefsError == SamcoPreferences::Error_Success) {
-        #ifdef USES_DISPLAY
-            OLED.ScreenModeChange(ExtDisplay::Screen_SaveSuccess);
-        #endif // USES_DISPLAY
-        Serial.print("Settings saved to ");
-        Serial.println(NVRAMlabel);
         SamcoPreferences::SaveToggles();
         if(SamcoPreferences::toggles.customPinsInUse) {
             SamcoPreferences::SavePins();
         }
         SamcoPreferences::SaveSettings();
         SamcoPreferences::SaveUSBID();
+        saveDefer.Request(millis());
+        return;
+    }
+#endif // SAMCO_FLASH_ENABLE
+    SavePreferencesReport();
+}
+
+// Commits a staged save once the gun's idle.
+// Committing stalls both cores while the flash is programmed (and erased, when the log moves sectors), so hold off while any button's down
+// (a solenoid/rumble pulse would be stuck on for that long) and, when tracking, only go right after a frame.
+void SavePreferencesStep()
+{
+    if(!saveDefer.Due(millis(), buttons.debounced)) {
+        return;
+    }
+    nvPrefsError = SamcoPreferences::Commit();
+    SavePreferencesReport();
+}
+
+// Reports the result of a save to the App, OLED & LEDs.
+// Blinks LEDs (if any) on success or failure.
+void SavePreferencesReport()
+{
+    #ifdef LED_ENABLE
+        // set the color to come back to first, the blinks below land on it when they're done
+        if(gunMode == GunMode_Docked) {
+            LedUpdate(127, 127, 255);
+        } else if(gunMode == GunMode_Pause) {
+            SetLedPackedColor(profileData[selectedProfile].color);
+        }
+    #endif // LED_ENABLE
+    if(nvPrefsError == SamcoPreferences::Error_Success) {
+        #ifdef USES_DISPLAY
+            OLED.ScreenModeChange(ExtDisplay::Screen_SaveSuccess);
+        #endif // USES_DISPLAY
+        Serial.print("Settings saved to ");
+        Serial.println(NVRAMlabel);
         #ifdef LED_ENABLE
-            for(byte i = 0; i < 3; i++) {
-                LedUpdate(25,25,255);
-                delay(55);
-                LedOff();
-                delay(40);
-            }
+            LedBlink(0x1919FF, 3, 55, 40);
         #endif // LED_ENABLE
     } else {
         #ifdef USES_DISPLAY
@@ -4227,12 +5011,7 @@ void SavePreferences()
         Serial.println("Error saving Preferences.");
         PrintNVPrefsError();
         #ifdef LED_ENABLE
-            for(byte i = 0; i < 2; i++) {
-                LedUpdate(255,10,5);
-                delay(145);
-                LedOff();
-                delay(60);
-            }
+            LedBlink(0xFF0A05, 2, 145, 60);
         #endif // LED_ENABLE
     }
     #ifdef USES_DISPLAY
@@ -4303,6 +5082,11 @@ void SetIrSensitivity(uint8_t sensitivity)
     if(irSensitivity != (DFRobotIRPositionEx::Sensitivity_e)sensitivity) {
         irSensitivity = (DFRobotIRPositionEx::Sensitivity_e)sensitivity;
         dfrIRPos->sensitivityLevel(irSensitivity);
+        #ifdef DUAL_CAMERA
+            if(dfrIRPos2 != nullptr) {
+                dfrIRPos2->sensitivityLevel(irSensitivity);
+            }
+        #endif // DUAL_CAMERA
         if(!(stateFlags & StateFlag_PrintSelectedProfile)) {
             PrintIrSensitivity();
         }
@@ -4416,58 +5200,78 @@ void LedInit()
 // 32-bit packed color value update across all LED units
 void SetLedPackedColor(uint32_t color)
 {
-#ifdef DOTSTAR_ENABLE
-    dotstar.setPixelColor(0, color);
-    dotstar.show();
-#endif // DOTSTAR_ENABLE
-#ifdef NEOPIXEL_PIN
-    neopixel.setPixelColor(0, color);
-    neopixel.show();
-#endif // NEOPIXEL_PIN
-#ifdef CUSTOM_NEOPIXEL
-    if(SamcoPreferences::pins.oPixel >= 0) {
-        if(SamcoPreferences::settings.customLEDstatic < SamcoPreferences::settings.customLEDcount) {
-            externPixel->fill(color, SamcoPreferences::settings.customLEDstatic);
-            externPixel->show();
-        }
-    }
-#endif // CUSTOM_NEOPIXEL
-#ifdef FOURPIN_LED
-    if(ledIsValid) {
-        byte r = highByte(color >> 8);
-        byte g = highByte(color);
-        byte b = lowByte(color);
-        if(SamcoPreferences::toggles.commonAnode) {
-            r = ~r;
-            g = ~g;
-            b = ~b;
+    LedSet(color, Lights::Set_Color);
+}
+
+// Solid color update from either core.
+// Only the main core renders & pushes frames out, so the second core (serial & FFB handling, pausing) just posts
+// the color, and the main core's next LedService() picks it up.
+void LedSet(uint32_t color, uint8_t what)
+{
+    #if defined(ARDUINO_ARCH_RP2040) && defined(DUAL_CORE)
+        if(rp2040.cpuid()) {
+            OF_Lights.Post(color, what);
+            return;
         }
-        analogWrite(SamcoPreferences::pins.oLedR, r);
-        analogWrite(SamcoPreferences::pins.oLedG, g);
-        analogWrite(SamcoPreferences::pins.oLedB, b);
-    }
-#endif // FOURPIN_LED
-#ifdef ARDUINO_NANO_RP2040_CONNECT
-    byte r = highByte(color >> 8);
-    byte g = highByte(color);
-    byte b = lowByte(color);
-    r = ~r;
-    g = ~g;
-    b = ~b;
-    analogWrite(LEDR, r);
-    analogWrite(LEDG, g);
-    analogWrite(LEDB, b);
-#endif // NANO_RP2040
+    #endif // DUAL_CORE
+    OF_Lights.Set(color, what);
+    LedService();
 }
 
 void LedOff()
 {
-    LedUpdate(0, 0, 0);
+    SetLedPackedColor(0);
 }
 
 // Generic R/G/B value update across all LED units
 void LedUpdate(byte r, byte g, byte b)
 {
+    SetLedPackedColor(((uint32_t)r << 16) | ((uint32_t)g << 8) | b);
+}
+
+// Blinks all LED units, then returns to the last set color.
+// Runs in the background, so this returns right away.
+void LedBlink(uint32_t color, uint8_t count, uint16_t onTime, uint16_t offTime)
+{
+    OF_Lights.Blink(color, count, onTime, offTime, millis());
+    LedService();
+}
+
+// Pushes the current frame of LED effects out, if it's changed since the last one.
+// Called every pass of each mode's loop, on the main core only.
+void LedService()
+{
+    #if defined(ARDUINO_ARCH_RP2040) && defined(DUAL_CORE)
+        // the shot subscriber & the effect state are the main core's alone; the second core posts through LedSet()
+        if(rp2040.cpuid()) {
+            return;
+        }
+    #endif // DUAL_CORE
+    #ifdef CUSTOM_NEOPIXEL
+        // still latching the last frame; rather than wait it out, catch it next time around
+        if(externPixel != nullptr && !externPixel->canShow()) {
+            return;
+        }
+    #endif // CUSTOM_NEOPIXEL
+    unsigned long now = millis();
+    OF_Lights.Take();
+    #ifdef LED_MUZZLE_FLASH
+        // any number of shots since last time makes the one flash, restarted from now
+        if(ledShots.Take(Events::Event_Shot) + ledShots.Take(Events::Event_SerialShot)) {
+            OF_Lights.Flash(muzzleFlashColor, muzzleFlashLength, now);
+        }
+    #endif // LED_MUZZLE_FLASH
+    if(OF_Lights.Render(now)) {
+        LedShow(OF_Lights.color);
+    }
+}
+
+// Writes a color to every LED unit
+void LedShow(uint32_t color)
+{
+    byte r = (color >> 16) & 0xFF;
+    byte g = (color >> 8) & 0xFF;
+    byte b = color & 0xFF;
     #ifdef DOTSTAR_ENABLE
         dotstar.setPixelColor(0, r, g, b);
         dotstar.show();
@@ -4477,9 +5281,15 @@ void LedUpdate(byte r, byte g, byte b)
         neopixel.show();
     #endif // NEOPIXEL_PIN
     #ifdef CUSTOM_NEOPIXEL
-        if(SamcoPreferences::pins.oPixel >= 0) {
+        if(externPixel != nullptr) {
             if(SamcoPreferences::settings.customLEDstatic < SamcoPreferences::settings.customLEDcount) {
-                externPixel->fill(Adafruit_NeoPixel::Color(r, g, b), SamcoPreferences::settings.customLEDstatic);
+                if(OF_Lights.gaugeLit == LIGHTS_GAUGE_OFF) {
+                    externPixel->fill(color, SamcoPreferences::settings.customLEDstatic);
+                } else {
+                    for(byte i = SamcoPreferences::settings.customLEDstatic; i < SamcoPreferences::settings.customLEDcount; i++) {
+                        externPixel->setPixelColor(i, i - SamcoPreferences::settings.customLEDstatic < OF_Lights.gaugeLit ? color : 0);
+                    }
+                }
                 externPixel->show();
             }
         }
@@ -4567,15 +5377,8 @@ void OffscreenToggle()
     } else {                                                      // Or we're turning this OFF,
         Serial.println("Disabled Offscreen Button!");
         #ifdef LED_ENABLE
-            SetLedPackedColor(WikiColor::Ghost_white);            // Just set a color,
-            delay(150);                                           // Keep it on,
-            LedOff();                                             // Flicker it off
-            delay(100);                                           // for a bit,
-            SetLedPackedColor(WikiColor::Ghost_white);            // Flicker it back on
-            delay(150);                                           // for a bit,
-            LedOff();                                             // And turn it back off
-            delay(200);                                           // for a bit,
-            SetLedPackedColor(profileData[selectedProfile].color);// And reset the LED back to pause mode color
+            SetLedPackedColor(profileData[selectedProfile].color);// Come back to the pause mode color
+            LedBlink(WikiColor::Ghost_white, 2, 150, 150);        // after flickering a color on & off twice
         #endif // LED_ENABLE
         return;
     }
@@ -4691,15 +5494,8 @@ void RumbleToggle()
             OLED.TopPanelUpdate("Toggli", "ng Rumble OFF");
         #endif // USES_DISPLAY
         #ifdef LED_ENABLE
-            SetLedPackedColor(WikiColor::Salmon);                 // Set a color,
-            delay(150);                                           // Keep it on,
-            LedOff();                                             // Flicker it off
-            delay(100);                                           // for a bit,
-            SetLedPackedColor(WikiColor::Salmon);                 // Flicker it back on
-            delay(150);                                           // for a bit,
-            LedOff();                                             // And turn it back off
-            delay(200);                                           // for a bit,
-            SetLedPackedColor(profileData[selectedProfile].color);// And reset the LED back to pause mode color
+            SetLedPackedColor(profileData[selectedProfile].color);// Come back to the pause mode color
+            LedBlink(WikiColor::Salmon, 2, 150, 150);            // after flickering a color on & off twice
         #endif // LED_ENABLE
     }
     #ifdef USES_DISPLAY
@@ -4734,15 +5530,8 @@ void SolenoidToggle()
             OLED.TopPanelUpdate("Toggli", "ng Solenoid OFF");
         #endif // USES_DISPLAY
         #ifdef LED_ENABLE
-            SetLedPackedColor(WikiColor::Yellow);                 // Set a color,
-            delay(150);                                           // Keep it on,
-            LedOff();                                             // Flicker it off
-            delay(100);                                           // for a bit,
-            SetLedPackedColor(WikiColor::Yellow);                 // Flicker it back on
-            delay(150);                                           // for a bit,
-            LedOff();                                             // And turn it back off
-            delay(200);                                           // for a bit,
-            SetLedPackedColor(profileData[selectedProfile].color);// And reset the LED back to pause mode color
+            SetLedPackedColor(profileData[selectedProfile].color);// Come back to the pause mode color
+            LedBlink(WikiColor::Yellow, 2, 150, 150);            // after flickering a color on & off twice
         #endif // LED_ENABLE
     }
     #ifdef USES_DISPLAY
@@ -4755,20 +5544,9 @@ void SolenoidToggle()
 void UpdateBindings(bool offscreenEnable)
 {
     // Updates pins
-    LightgunButtons::ButtonDesc[BtnIdx_Trigger].pin = SamcoPreferences::pins.bTrigger;
-    LightgunButtons::ButtonDesc[BtnIdx_A].pin = SamcoPreferences::pins.bGunA;
-    LightgunButtons::ButtonDesc[BtnIdx_B].pin = SamcoPreferences::pins.bGunB;
-    LightgunButtons::ButtonDesc[BtnIdx_Reload].pin = SamcoPreferences::pins.bGunC;
-    LightgunButtons::ButtonDesc[BtnIdx_Start].pin = SamcoPreferences::pins.bStart;
-    LightgunButtons::ButtonDesc[BtnIdx_Select].pin = SamcoPreferences::pins.bSelect;
-    LightgunButtons::ButtonDesc[BtnIdx_Up].pin = SamcoPreferences::pins.bGunUp;
-    LightgunButtons::ButtonDesc[BtnIdx_Down].pin = SamcoPreferences::pins.bGunDown;
-    LightgunButtons::ButtonDesc[BtnIdx_Left].pin = SamcoPreferences::pins.bGunLeft;
-    LightgunButtons::ButtonDesc[BtnIdx_Right].pin = SamcoPreferences::pins.bGunRight;
-    LightgunButtons::ButtonDesc[BtnIdx_Pedal].pin = SamcoPreferences::pins.bPedal;
-    LightgunButtons::ButtonDesc[BtnIdx_Pedal2].pin = SamcoPreferences::pins.bPedal2;
-    LightgunButtons::ButtonDesc[BtnIdx_Pump].pin = SamcoPreferences::pins.bPump;
-    LightgunButtons::ButtonDesc[BtnIdx_Home].pin = SamcoPreferences::pins.bHome;
+    for(unsigned int i = 0; i < ButtonCount; ++i) {
+        LightgunButtons::ButtonDesc[i].pin = SamcoPreferences::pins.*ButtonPins[i];
+    }
 
     // Updates button functions for low-button mode
     if(offscreenEnable) {
@@ -12,369 +12,247 @@
  */
 
 #include "SamcoPreferences.h"
+#include "SamcoBoardPresets.h"
 #include <Arduino.h>
 
 #ifdef SAMCO_EEPROM_ENABLE
-#include <EEPROM.h>
+#include "OpenFIREPrefsLog.h"
+#include <hardware/flash.h>
+#if defined(ARDUINO_RASPBERRY_PI_PICO_W) && (defined(ENABLE_CLASSIC) || defined(ENABLE_BLE))
+#include <pico/btstack_flash_bank.h>
+#endif // ARDUINO_RASPBERRY_PI_PICO_W
+
+// top of flash, where the Arduino EEPROM library kept the old layout
+extern "C" uint8_t _EEPROM_start;
+// the filesystem space picked under Tools -> Flash Size; the sketch doesn't use LittleFS, so the log goes there
+extern "C" uint8_t _FS_start;
+extern "C" uint8_t _FS_end;
+// end of the sketch itself
+extern "C" uint8_t __flash_binary_end;
 #endif // SAMCO_EEPROM_ENABLE
 
 // 4 byte header ID
-const SamcoPreferences::HeaderId_t SamcoPreferences::HeaderId = {'O', 'F', '0', '1'};
+const SamcoPreferences::HeaderId_t SamcoPreferences::HeaderIdLegacy = {'O', 'F', '0', '1'};
 
 #ifdef SAMCO_EEPROM_ENABLE
-void SamcoPreferences::WriteHeader()
+// the old layout stored each group raw at these offsets
+constexpr uint16_t PrefsLegacy_SelectedProfile = 4;
+constexpr uint16_t PrefsLegacy_Profiles = 5;
+constexpr uint16_t PrefsLegacy_Toggles = 300;
+constexpr uint16_t PrefsLegacy_Pins = 350;
+constexpr uint16_t PrefsLegacy_Settings = 400;
+constexpr uint16_t PrefsLegacy_USB = 900;
+// for groups the old layout never had
+constexpr uint16_t PrefsLegacy_None = 0xFFFF;
+
+// layout versions of each group
+constexpr uint8_t PrefsVersion_Profiles = 1;
+constexpr uint8_t PrefsVersion_SelectedProfile = 1;
+constexpr uint8_t PrefsVersion_Toggles = 1;
+constexpr uint8_t PrefsVersion_Pins = 2;
+constexpr uint8_t PrefsVersion_Settings = 1;
+constexpr uint8_t PrefsVersion_USB = 1;
+constexpr uint8_t PrefsVersion_Calibration = 1;
+
+static_assert(sizeof(PrefsLog::SectorHeader_t) + sizeof(PrefsLog::RecordHeader_t) * 7 +
+              (sizeof(SamcoPreferences::ProfileData_t) + sizeof(CalibrationFit_t)) * 4 + 1 +
+              sizeof(SamcoPreferences::TogglesMap_t) + sizeof(SamcoPreferences::PinsMap_t) +
+              sizeof(SamcoPreferences::SettingsMap_t) + sizeof(SamcoPreferences::USBMap_t) <= PREFS_SECTOR_SIZE / 2,
+              "A full set of preferences should leave room in a sector for a few more saves!");
+
+/// @brief The log's sectors, at the top of the filesystem space
+/// @details The linker keeps the sketch below _FS_start, so the filesystem space is the one part of flash that's
+/// set aside & otherwise unused; without one (a "no FS" flash size), there's nowhere safe and nothing's saved.
+/// Both cores are stopped for each erase/program, since the other one can't be running from flash meanwhile.
+class PrefsFlashRP2040 : public PrefsFlash {
+public:
+    const uint8_t *Data() override { return &_FS_end - PREFS_LOG_SECTORS * PREFS_SECTOR_SIZE; }
+
+    bool Erase(uint32_t offset) override {
+        rp2040.idleOtherCore();
+        noInterrupts();
+        flash_range_erase(Data() - (const uint8_t*)XIP_BASE + offset, PREFS_SECTOR_SIZE);
+        interrupts();
+        rp2040.resumeOtherCore();
+        return true;
+    }
+
+    bool Program(uint32_t offset, const uint8_t *page) override {
+        rp2040.idleOtherCore();
+        noInterrupts();
+        flash_range_program(Data() - (const uint8_t*)XIP_BASE + offset, page, PREFS_PAGE_SIZE);
+        interrupts();
+        rp2040.resumeOtherCore();
+        return true;
+    }
+};
+
+static PrefsFlashRP2040 prefsFlash;
+static PrefsLog prefsLog(prefsFlash);
+
+int SamcoPreferences::Begin()
 {
-    EEPROM.put(0, HeaderId.u32);
+    uintptr_t bankStart = 0, bankEnd = 0;
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && (defined(ENABLE_CLASSIC) || defined(ENABLE_BLE))
+        // BTstack's pairings
+        bankStart = XIP_BASE + PICO_FLASH_BANK_STORAGE_OFFSET;
+        bankEnd = bankStart + PICO_FLASH_BANK_TOTAL_SIZE;
+    #endif // ARDUINO_RASPBERRY_PI_PICO_W
+    // too small a filesystem space (or none), or something else in it: leave the flash alone
+    if(!PrefsLog::Placed((uintptr_t)prefsFlash.Data(), (uintptr_t)&_FS_start, (uintptr_t)&_FS_end,
+                         (uintptr_t)&__flash_binary_end, bankStart, bankEnd)) {
+        return Error_NoStorage;
+    }
+    prefsLog.Begin();
+    return Error_Success;
 }
 
-int SamcoPreferences::CheckHeader()
+int SamcoPreferences::ReadRecord(uint16_t legacyOffset, uint8_t type, uint8_t version, void *data, uint16_t length)
 {
-    uint32_t u32;
-    EEPROM.get(0, u32);
-    if(u32 != HeaderId.u32) {
-        return Error_NoData;
-    } else {
+    if(prefsLog.Empty()) {
+        // nothing's been saved since updating from the old layout, so carry over what it had
+        uint32_t u32;
+        memcpy(&u32, &_EEPROM_start, sizeof(u32));
+        if(u32 != HeaderIdLegacy.u32 || legacyOffset == PrefsLegacy_None) {
+            return Error_NoData;
+        }
+        memcpy(data, &_EEPROM_start + legacyOffset, length);
         return Error_Success;
     }
+
+    if(prefsLog.Read(type, version, data, length) != PrefsLog::Result_Ok) {
+        return Error_Read;
+    }
+    return Error_Success;
+}
+
+void SamcoPreferences::WriteRecord(uint8_t type, uint8_t version, const void *data, uint16_t length)
+{
+    prefsLog.Stage(type, version, data, length);
 }
 
 int SamcoPreferences::LoadProfiles()
 {
-    int status = CheckHeader();
-    if(status == Error_Success) {
-        profiles.selectedProfile = EEPROM.read(4);
-        uint8_t* p = ((uint8_t*)profiles.pProfileData);
-        for(unsigned int i = 0; i < sizeof(ProfileData_t) * profiles.profileCount; ++i) {
-            p[i] = EEPROM.read(5 + i);
-        }
-        return Error_Success;
-    } else {
+    int status = ReadRecord(PrefsLegacy_SelectedProfile, Record_SelectedProfile, PrefsVersion_SelectedProfile,
+                            &profiles.selectedProfile, sizeof(profiles.selectedProfile));
+    if(status != Error_Success) {
         return status;
     }
+    status = ReadRecord(PrefsLegacy_Profiles, Record_Profiles, PrefsVersion_Profiles,
+                        profiles.pProfileData, sizeof(ProfileData_t) * profiles.profileCount);
+    if(status != Error_Success) {
+        return status;
+    }
+    if(ReadRecord(PrefsLegacy_None, Record_Calibration, PrefsVersion_Calibration,
+                  profiles.pCalibration, sizeof(CalibrationFit_t) * profiles.profileCount) != Error_Success) {
+        memset(profiles.pCalibration, 0, sizeof(CalibrationFit_t) * profiles.profileCount);
+    }
+    return Error_Success;
 }
 
 int SamcoPreferences::SaveProfiles()
 {
-    WriteHeader();
-    EEPROM.update(4, profiles.selectedProfile);
-    uint8_t* p = ((uint8_t*)profiles.pProfileData);
-    for(unsigned int i = 0; i < sizeof(ProfileData_t) * profiles.profileCount; ++i) {
-        EEPROM.write(5 + i, p[i]);
-    }
-
-    // Remember that we need to commit changes to the virtual EEPROM on RP2040!
-    EEPROM.commit();
+    WriteRecord(Record_SelectedProfile, PrefsVersion_SelectedProfile,
+                &profiles.selectedProfile, sizeof(profiles.selectedProfile));
+    WriteRecord(Record_Profiles, PrefsVersion_Profiles,
+                profiles.pProfileData, sizeof(ProfileData_t) * profiles.profileCount);
+    WriteRecord(Record_Calibration, PrefsVersion_Calibration,
+                profiles.pCalibration, sizeof(CalibrationFit_t) * profiles.profileCount);
     return Error_Success;
 }
 
 int SamcoPreferences::LoadToggles()
 {
-    int status = CheckHeader();
-    if(status == Error_Success) {
-        EEPROM.get(300, toggles);
-        return Error_Success;
-    } else {
-        return status;
-    }
+    return ReadRecord(PrefsLegacy_Toggles, Record_Toggles, PrefsVersion_Toggles, &toggles, sizeof(toggles));
 }
 
 int SamcoPreferences::SaveToggles()
 {
-    WriteHeader();
-    EEPROM.put(300, toggles);
-    EEPROM.commit();
+    WriteRecord(Record_Toggles, PrefsVersion_Toggles, &toggles, sizeof(toggles));
     return Error_Success;
 }
 
+// version 1 (and the old layout) ended before the second camera's pins
+constexpr uint16_t PinsLength_V1 = offsetof(SamcoPreferences::PinsMap_t, pCam2SDA);
+
 int SamcoPreferences::LoadPins()
 {
-    int status = CheckHeader();
+    int status = ReadRecord(PrefsLegacy_None, Record_Pins, PrefsVersion_Pins, &pins, sizeof(pins));
     if(status == Error_Success) {
-        EEPROM.get(350, pins);
-        return Error_Success;
-    } else {
         return status;
     }
+    // carry over an older map, with the second camera where the board has it
+    if(ReadRecord(PrefsLegacy_Pins, Record_Pins, 1, &pins, PinsLength_V1) == Error_Success) {
+        pins.pCam2SDA = BoardPreset.pCam2SDA;
+        pins.pCam2SCL = BoardPreset.pCam2SCL;
+        return Error_Success;
+    }
+    return status;
 }
 
 int SamcoPreferences::SavePins()
 {
-    WriteHeader();
-    EEPROM.put(350, pins);
-    EEPROM.commit();
+    WriteRecord(Record_Pins, PrefsVersion_Pins, &pins, sizeof(pins));
     return Error_Success;
 }
 
 int SamcoPreferences::LoadSettings()
 {
-    int status = CheckHeader();
-    if(status == Error_Success) {
-        EEPROM.get(400, settings);
-        return Error_Success;
-    } else {
-        return status;
-    }
+    return ReadRecord(PrefsLegacy_Settings, Record_Settings, PrefsVersion_Settings, &settings, sizeof(settings));
 }
 
 int SamcoPreferences::SaveSettings()
 {
-    WriteHeader();
-    EEPROM.put(400, settings);
-    EEPROM.commit();
+    WriteRecord(Record_Settings, PrefsVersion_Settings, &settings, sizeof(settings));
     return Error_Success;
 }
 
 int SamcoPreferences::LoadUSBID()
 {
-    int status = CheckHeader();
-    if(status == Error_Success) {
-        EEPROM.get(900, usb);
-        return Error_Success;
-    } else {
-        return status;
-    }
+    return ReadRecord(PrefsLegacy_USB, Record_USB, PrefsVersion_USB, &usb, sizeof(usb));
 }
 
 int SamcoPreferences::SaveUSBID()
 {
-    WriteHeader();
-    EEPROM.put(900, usb);
-    EEPROM.commit();
+    WriteRecord(Record_USB, PrefsVersion_USB, &usb, sizeof(usb));
     return Error_Success;
 }
 
-void SamcoPreferences::ResetPreferences()
+int SamcoPreferences::Commit()
 {
-    for(uint16_t i = 0; i < EEPROM.length(); ++i) {
-        EEPROM.update(i, 0);
+    if(prefsLog.Commit() != PrefsLog::Result_Ok) {
+        return Error_Write;
     }
+    return Error_Success;
+}
+
+void SamcoPreferences::ResetPreferences()
+{
+    prefsLog.Erase();
 
-    EEPROM.commit();
+    // the old layout would otherwise be carried over again on the next boot
+    uint32_t u32;
+    memcpy(&u32, &_EEPROM_start, sizeof(u32));
+    if(u32 == HeaderIdLegacy.u32) {
+        rp2040.idleOtherCore();
+        noInterrupts();
+        flash_range_erase(&_EEPROM_start - (const uint8_t*)XIP_BASE, FLASH_SECTOR_SIZE);
+        interrupts();
+        rp2040.resumeOtherCore();
+    }
 }
 
 void SamcoPreferences::LoadPresets()
 {
-// For the Adafruit ItsyBitsy RP2040 - optimized for SAMCO boards
-#ifdef ARDUINO_ADAFRUIT_ITSYBITSY_RP2040
-
-    #ifdef USES_SOLENOID
-        #ifdef USES_TEMP    
-            pins.aTMP36 = -1;
-        #endif // USES_TEMP
-    #endif // USES_SOLENOID
-
-      // Remember: PWM PINS ONLY!
-    #ifdef FOURPIN_LED
-        #define LED_ENABLE
-        pins.oLedR = -1;
-        pins.oLedG = -1;
-        pins.oLedB = -1;
-    #endif // FOURPIN_LED
-
-      // Any digital pin is fine for NeoPixels.
-    #ifdef CUSTOM_NEOPIXEL
-        #define LED_ENABLE
-        pins.customLEDpin = -1;
-    #endif // CUSTOM_NEOPIXEL
-
-    pins.oRumble = 24;
-    pins.oSolenoid = 25;
-    pins.bTrigger = 6;
-    pins.bGunA = 27;
-    pins.bGunB = 26;
-    pins.bGunC = 11;
-    pins.bStart = 28;
-    pins.bSelect = 29;
-    pins.bGunUp = 9;
-    pins.bGunDown = 7;
-    pins.bGunLeft = 8;
-    pins.bGunRight = 10;
-    pins.bPedal = 4;
-    pins.bPedal2 = -1;
-    pins.bPump = -1;
-    pins.bHome = -1;
-
-// For the Adafruit KB2040 - optimized for GUN4IR boards
-#elifdef ARDUINO_ADAFRUIT_KB2040_RP2040
-
-    #ifdef USES_SOLENOID
-        #ifdef USES_TEMP    
-            pins.aTMP36 = A0;
-        #endif // USES_TEMP
-    #endif // USES_SOLENOID
-
-      // Remember: PWM PINS ONLY!
-    #ifdef FOURPIN_LED
-        #define LED_ENABLE
-        pins.oLedR = -1;
-        pins.oLedG = -1;
-        pins.oLedB = -1;
-    #endif // FOURPIN_LED
-
-      // Any digital pin is fine for NeoPixels.
-    #ifdef CUSTOM_NEOPIXEL
-        #define LED_ENABLE
-        pins.oPixel = -1;
-    #endif // CUSTOM_NEOPIXEL
-
-    pins.oRumble = 5;
-    pins.oSolenoid = 7;
-    pins.bTrigger = A2;
-    pins.bGunA = A3;
-    pins.bGunB = 4;
-    pins.bGunC = 6;
-    pins.bStart = 9;
-    pins.bSelect = 8;
-    pins.bGunUp = 18;
-    pins.bGunDown = 20;
-    pins.bGunLeft = 19;
-    pins.bGunRight = 10;
-    pins.bPedal = -1;
-    pins.bPedal2 = -1;
-    pins.bPump = -1;
-    pins.bHome = A1;
-
-// For the Arduino Nano RP2040 Connect - because it was requested
-#elifdef ARDUINO_NANO_RP2040_CONNECT
-
-    #ifdef USES_SOLENOID
-        #ifdef USES_TEMP    
-            pins.aTMP36 = A2;
-        #endif // USES_TEMP
-    #endif // USES_SOLENOID
-
-      // Remember: PWM PINS ONLY!
-    #ifdef FOURPIN_LED
-        #define LED_ENABLE
-        pins.oLedR = -1;
-        pins.oLedG = -1;
-        pins.oLedB = -1;
-    #endif // FOURPIN_LED
-
-      // Any digital pin is fine for NeoPixels.
-    #ifdef CUSTOM_NEOPIXEL
-        #define LED_ENABLE
-        pins.oPixel = -1;
-    #endif // CUSTOM_NEOPIXEL
-
-      // Button Pins setup
-    pins.oRumble = 17;
-    pins.oSolenoid = 16;
-    pins.bTrigger = 15;
-    pins.bGunA = 0;
-    pins.bGunB = 1;
-    pins.bGunC = 18;
-    pins.bStart = 19;
-    pins.bSelect = 20;
-    pins.bGunUp = -1;
-    pins.bGunDown = -1;
-    pins.bGunLeft = -1;
-    pins.bGunRight = -1;
-    pins.bPedal = -1;
-    pins.bPedal2 = -1;
-    pins.bPump = -1;
-    pins.bHome = -1;
-
-// For the Waveshare RP2040 Zero - smallest/cheapest board
-#elifdef ARDUINO_WAVESHARE_RP2040_ZERO
-
-    #ifdef USES_SOLENOID
-        #ifdef USES_TEMP    
-            pins.aTMP36 = A3;
-        #endif // USES_TEMP
-    #endif // USES_SOLENOID
-
-      // Remember: PWM PINS ONLY!
-    #ifdef FOURPIN_LED
-        #define LED_ENABLE
-        pins.oLedR = -1;
-        pins.oLedG = -1;
-        pins.oLedB = -1;
-    #endif // FOURPIN_LED
-
-      // Any digital pin is fine for NeoPixels.
-    #ifdef CUSTOM_NEOPIXEL
-        #define LED_ENABLE
-        pins.oPixel = -1
-    #endif // CUSTOM_NEOPIXEL
-
-    pins.oRumble = 17;
-    pins.oSolenoid = 16;
-    pins.bTrigger = 0;
-    pins.bGunA = 1;
-    pins.bGunB = 2;
-    pins.bGunC = 3;
-    pins.bStart = 4;
-    pins.bSelect = 5;
-    pins.bGunUp = -1;
-    pins.bGunDown = -1;
-    pins.bGunLeft = -1;
-    pins.bGunRight = -1;
-    pins.bPedal = -1;
-    pins.bPedal2 = -1;
-    pins.bPump = -1;
-    pins.bHome = -1;
-
-// For the Raspberry Pi Pico - first party baybeeee
-#elif defined(ARDUINO_RASPBERRY_PI_PICO) || defined(ARDUINO_RASPBERRY_PI_PICO_W)
-
-    #ifdef USES_SOLENOID
-        #ifdef USES_TEMP    
-            pins.aTMP36 = A2;
-        #endif // USES_TEMP
-    #endif // USES_SOLENOID
-
-      // Remember: PWM PINS ONLY!
-    #ifdef FOURPIN_LED
-        #define LED_ENABLE
-        pins.oLedR = 10;
-        pins.oLedG = 11;
-        pins.oLedB = 12;
-    #endif // FOURPIN_LED
-
-      // Any digital pin is fine for NeoPixels.
-    #ifdef CUSTOM_NEOPIXEL
-        #define LED_ENABLE
-        pins.oPixel = -1
-    #endif // CUSTOM_NEOPIXEL
-
-    pins.oRumble = 17;
-    pins.oSolenoid = 16;
-    pins.bTrigger = 15;
-    pins.bGunA = 0;
-    pins.bGunB = 1;
-    pins.bGunC = 2;
-    pins.bStart = 3;
-    pins.bSelect = 4;
-    pins.bGunUp = 6;
-    pins.bGunDown = 7;
-    pins.bGunLeft = 8;
-    pins.bGunRight = 9;
-    pins.bPedal = 14;
-    pins.bPedal2 = -1;
-    pins.bPump = 13;
-    pins.bHome = 5;
-
-    #endif // ARDUINO_BOARD
-
-    PresetCam();
+    pins = BoardPreset;
 }
 
 void SamcoPreferences::PresetCam()
 {
-#if defined(ARDUINO_ADAFRUIT_ITSYBITSY_RP2040) || defined(ARDUINO_ADAFRUIT_KB2040_RP2040)
-    pins.pCamSCL = 3;
-    pins.pCamSDA = 2;
-#elifdef ARDUINO_NANO_RP2040_CONNECT
-    pins.pCamSCL = 13;
-    pins.pCamSDA = 12;
-#elifdef ARDUINO_WAVESHARE_RP2040_ZERO
-    pins.pCamSCL = 15;
-    pins.pCamSDA = 14;
-#else // RASPBERRY_PI_PICO et al
-    pins.pCamSCL = 21;
-    pins.pCamSDA = 20;
-#endif // ARDUINO_BOARD
+    pins.pCamSCL = BoardPreset.pCamSCL;
+    pins.pCamSDA = BoardPreset.pCamSDA;
+    pins.pCam2SCL = BoardPreset.pCam2SCL;
+    pins.pCam2SDA = BoardPreset.pCam2SDA;
 }
 
 #else
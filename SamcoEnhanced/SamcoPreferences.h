@@ -15,6 +15,7 @@
 #define _SAMCOPREFERENCES_H_
 
 #include <OpenFIREBoard.h>
+#include <OpenFIRE_Calibration.h>
 #include <stdint.h>
 
 /// @brief Static instance of preferences to save in non-volatile memory
@@ -37,6 +38,19 @@ public:
         uint32_t u32;
     } __attribute__ ((packed)) HeaderId_t;
 
+    /// @brief Types of records kept in the preferences log, see PrefsLog
+    /// @details Each group's validated on its own: one whose version/length doesn't match what the firmware expects
+    /// is left at its defaults, and the other groups still load.
+    enum RecordTypes_e {
+        Record_Profiles = 1,
+        Record_SelectedProfile,
+        Record_Toggles,
+        Record_Pins,
+        Record_Settings,
+        Record_USB,
+        Record_Calibration
+    };
+
     /// @brief Profile data
     typedef struct ProfileData_s {
         int topOffset;              // Perspective: Offsets
@@ -65,6 +79,9 @@ public:
 
         // default profile
         uint8_t selectedProfile;
+
+        // pointer to CalibrationFit_t array, one per profile
+        CalibrationFit_t* pCalibration;
     } __attribute__ ((packed)) Preferences_t;
 
     // single instance of the preference data
@@ -127,7 +144,9 @@ public:
         Pin_Battery,
         Pin_AnalogX,
         Pin_AnalogY,
-        Pin_AnalogTMP
+        Pin_AnalogTMP,
+        Pin_Camera2SDA,
+        Pin_Camera2SCL
     };
 
     typedef struct PinsMap_s {
@@ -162,6 +181,8 @@ public:
         int8_t aStickX = -1;               // Analog Stick X-axis
         int8_t aStickY = -1;               // Analog Stick Y-axis
         int8_t aTMP36 = -1;                // Analog TMP36 Temperature Sensor Pin
+        int8_t pCam2SDA = -1;              // Second Camera I2C Data Pin (DUAL_CAMERA)
+        int8_t pCam2SCL = -1;              // Second Camera I2C Clock Pin (DUAL_CAMERA)
     } PinsMap_t;
 
     static PinsMap_t pins;
@@ -210,25 +231,33 @@ public:
 
     static USBMap_t usb;
 
-    // header ID to ensure junk isn't loaded if preferences aren't saved
-    static const HeaderId_t HeaderId;
+    // header ID of the old fixed-offset EEPROM layout, loaded until the first save to the log
+    static const HeaderId_t HeaderIdLegacy;
 
     /// @brief Required size for the preferences
     static unsigned int Size() { return sizeof(ProfileData_t) * profiles.profileCount + sizeof(HeaderId_u) + sizeof(profiles.selectedProfile); }
 
-    /// @brief Save/Update header
-    /// @return Nothing
-    static void WriteHeader();
-
-    /// @brief Load and compare the header
+    /// @brief Finds the preferences log in flash and scans it for the newest of each record
     /// @return An error code from Errors_e
-    static int CheckHeader();
+    static int Begin();
+
+    /// @brief Copy out the newest record of a type
+    /// @details If nothing's been saved to the log yet, the payload's read raw from legacyOffset of the old layout instead.
+    /// @return An error code from Errors_e, data is untouched on failure
+    static int ReadRecord(uint16_t legacyOffset, uint8_t type, uint8_t version, void *data, uint16_t length);
+
+    /// @brief Stage a record to go out with the next Commit()
+    /// @details Records that match what's stored cost nothing.
+    /// @return Nothing
+    static void WriteRecord(uint8_t type, uint8_t version, const void *data, uint16_t length);
 
     /// @brief Load preferences
+    /// @details Grid calibration fits are loaded alongside, but kept in their own record;
+    /// any profile without a valid one just falls back to its edge offsets.
     /// @return An error code from Errors_e
     static int LoadProfiles();
 
-    /// @brief Save current preferences
+    /// @brief Stage current preferences (written by Commit())
     /// @return An error code from Errors_e
     static int SaveProfiles();
 
@@ -236,7 +265,7 @@ public:
     /// @return An error code from Errors_e
     static int LoadToggles();
 
-    /// @brief Save current toggles states
+    /// @brief Stage current toggles states (written by Commit())
     /// @return An error code from Errors_e
     static int SaveToggles();
 
@@ -244,7 +273,7 @@ public:
     /// @return An error code from Errors_e
     static int LoadPins();
 
-    /// @brief Save current pin mapping
+    /// @brief Stage current pin mapping (written by Commit())
     /// @return An error code from Errors_e
     static int SavePins();
 
@@ -252,7 +281,7 @@ public:
     /// @return An error code from Errors_e
     static int LoadSettings();
 
-    /// @brief Save current settings
+    /// @brief Stage current settings (written by Commit())
     /// @return An error code from Errors_e
     static int SaveSettings();
 
@@ -260,11 +289,17 @@ public:
     /// @return An error code from Errors_e
     static int LoadUSBID();
 
-    /// @brief Save current USB ID
+    /// @brief Stage current USB ID (written by Commit())
     /// @return An error code from Errors_e
     static int SaveUSBID();
 
-    /// @brief Resets preferences with a zero-fill to the EEPROM.
+    /// @brief Write all staged groups to flash in one go
+    /// @details Skips the flash entirely if nothing staged differs from what's stored;
+    /// otherwise they're appended to the log, and a sector's only erased when the log has to move over.
+    /// @return An error code from Errors_e
+    static int Commit();
+
+    /// @brief Resets preferences by erasing the log (and any old EEPROM layout)
     /// @return Nothing
     static void ResetPreferences();
 
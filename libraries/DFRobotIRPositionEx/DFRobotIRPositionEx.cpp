@@ -34,12 +34,20 @@ constexpr uint8_t DFRIRdata_ModeExtended = 0x33;
 constexpr uint8_t DFRIRdata_ModeFull = 0x55;
 
 // IIC delay, the Wiki says to use at least 50ms, but the original source uses 10
+// now only an upper bound, register writes are followed by polling the sensor until it ACKs
 constexpr unsigned long DFRIRdata_IICdelay = 10;
 
+// minimum time between register writes; nothing says the sensor NACKs while it's busy,
+// so don't lean on the ACK polling alone to pace them
+constexpr unsigned long DFRIRdata_IICsettle = 5;
+
+// time the camera needs after being started before its frames are any good
+constexpr unsigned long DFRIRdata_StartDelay = 100;
+
 // maximum valid Y position
 constexpr int DFRIRdata_MaxY = 767;
 
-DFRobotIRPositionEx::DFRobotIRPositionEx(TwoWire& _wire) : wire(_wire), seenFlags(0)
+DFRobotIRPositionEx::DFRobotIRPositionEx(TwoWire& _wire) : wire(_wire), seenFlags(0), startStamp(0)
 {
 }
 
@@ -55,11 +63,23 @@ void DFRobotIRPositionEx::writeTwoIICByte(uint8_t first, uint8_t second)
     wire.endTransmission();
 }
 
+void DFRobotIRPositionEx::waitForAck()
+{
+    unsigned long start = millis();
+    delay(DFRIRdata_IICsettle);
+    do {
+        wire.beginTransmission(IRAddress);
+        if(wire.endTransmission() == 0) {
+            return;
+        }
+    } while(millis() - start < DFRIRdata_IICdelay);
+}
+
 void DFRobotIRPositionEx::dataFormat(DataFormat_e format)
 {
     uint8_t mode = format ? DFRIRdata_ModeExtended : DFRIRdata_ModeBasic;
     writeTwoIICByte(0x33, mode);
-    delay(DFRIRdata_IICdelay);
+    waitForAck();
 }
 
 void DFRobotIRPositionEx::sensitivityLevel(Sensitivity_e sensitivity)
@@ -72,11 +92,11 @@ void DFRobotIRPositionEx::sensitivityLevel(Sensitivity_e sensitivity)
         sensitivity = Sensitivity_Max;
     }
     writeTwoIICByte(0x06, reg06[sensitivity]);
-    delay(DFRIRdata_IICdelay);
+    waitForAck();
     writeTwoIICByte(0x08, reg08[sensitivity]);
-    delay(DFRIRdata_IICdelay);
+    waitForAck();
     writeTwoIICByte(0x1A, reg1A[sensitivity]);
-    delay(DFRIRdata_IICdelay);
+    waitForAck();
 }
 
 void DFRobotIRPositionEx::begin(uint32_t clock, DataFormat_e format, Sensitivity_e sensitivity)
@@ -94,13 +114,13 @@ void DFRobotIRPositionEx::begin(uint32_t clock, DataFormat_e format, Sensitivity
 #endif
     // stop camera?
     writeTwoIICByte(0x30,0x01);
-    delay(DFRIRdata_IICdelay);
+    waitForAck();
     sensitivityLevel(sensitivity);
     dataFormat(format);
     // start camera?
+    // rather than blocking here until it's settled, readPosition() drops frames until then
     writeTwoIICByte(0x30,0x08);
-
-    delay(100);
+    startStamp = millis();
 }
 
 void DFRobotIRPositionEx::requestPositionExtended()
@@ -157,7 +177,7 @@ bool DFRobotIRPositionEx::availableBasicNoSeen()
 
 bool DFRobotIRPositionEx::readPosition(PositionData_t& posData, unsigned int length)
 {
-    if(wire.available() == length) {   //read only the data lenth fits.
+    if(wire.available() == length && millis() - startStamp >= DFRIRdata_StartDelay) {   //read only the data lenth fits.
         for(int i = 0; i < length; ++i) {
             posData.receivedBuffer[i] = wire.read();
         }
@@ -227,6 +247,26 @@ void DFRobotIRPositionEx::unpackBasicFrameSeen(unsigned int posData)
     }
 }
 
+int DFRobotIRPositionEx::basicAtomicStep(unsigned int& index)
+{
+    requestPositionBasic();
+
+    // switch to other buffer for next read
+    index ^= 1;
+
+    if(!readPosition(positionData[index], DFRIRdata_LengthBasic)) {
+        return Error_IICerror;
+    }
+
+    // compare but ignore the header byte
+    if(!memcmp(&positionData[0].receivedBuffer[1], &positionData[1].receivedBuffer[1], DFRIRdata_LengthBasic - 1)) {
+        // position data is identical so unpack the data
+        unpackBasicFrameSeen(0);
+        return Error_Success;
+    }
+    return Error_DataMismatch;
+}
+
 int DFRobotIRPositionEx::basicAtomic(DFRobotIRPositionEx::Retry_e retry)
 {
     // initial index for positiondata[1]
@@ -239,20 +279,9 @@ int DFRobotIRPositionEx::basicAtomic(DFRobotIRPositionEx::Retry_e retry)
     }
 
     for(unsigned int i = 0, retries = retry >> 1; i <= retries; ++i) {
-        requestPositionBasic();
-
-        // switch to other buffer for next read
-        index ^= 1;
-
-        if(!readPosition(positionData[index], DFRIRdata_LengthBasic)) {
-            return Error_IICerror;
-        }
-
-        // compare but ignore the header byte
-        if(!memcmp(&positionData[0].receivedBuffer[1], &positionData[1].receivedBuffer[1], DFRIRdata_LengthBasic - 1)) {
-            // position data is identical so unpack the data
-            unpackBasicFrameSeen(0);
-            return Error_Success;
+        int error = basicAtomicStep(index);
+        if(error != Error_DataMismatch) {
+            return error;
         }
     }
     
@@ -264,6 +293,50 @@ int DFRobotIRPositionEx::basicAtomic(DFRobotIRPositionEx::Retry_e retry)
     return Error_DataMismatch;
 }
 
+int DFRobotIRPositionEx::basicAtomicPair(DFRobotIRPositionEx& other, int& otherError, DFRobotIRPositionEx::Retry_e retry)
+{
+    unsigned int index = 0;
+    unsigned int otherIndex = 0;
+    int error = Error_DataMismatch;
+    otherError = Error_DataMismatch;
+
+    // initial reads back to back
+    requestPositionBasic();
+    if(!readPosition(positionData[0], DFRIRdata_LengthBasic)) {
+        error = Error_IICerror;
+    }
+    other.requestPositionBasic();
+    if(!other.readPosition(other.positionData[0], DFRIRdata_LengthBasic)) {
+        otherError = Error_IICerror;
+    }
+
+    // then take turns, each camera dropping out once it's settled
+    for(unsigned int i = 0, retries = retry >> 1; i <= retries; ++i) {
+        if(error == Error_DataMismatch) {
+            error = basicAtomicStep(index);
+        }
+        if(otherError == Error_DataMismatch) {
+            otherError = other.basicAtomicStep(otherIndex);
+        }
+        if(error != Error_DataMismatch && otherError != Error_DataMismatch) {
+            break;
+        }
+    }
+
+    if(retry & 1) {
+        if(error == Error_DataMismatch) {
+            unpackBasicFrameSeen(index);
+            error = Error_SuccessMismatch;
+        }
+        if(otherError == Error_DataMismatch) {
+            other.unpackBasicFrameSeen(otherIndex);
+            otherError = Error_SuccessMismatch;
+        }
+    }
+
+    return error;
+}
+
 void DFRobotIRPositionEx::unpackExtendedFrame(unsigned int posData)
 {
     for(int i = 0; i < 4; ++i) {
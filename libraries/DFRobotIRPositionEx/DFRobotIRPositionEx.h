@@ -90,11 +90,25 @@ class DFRobotIRPositionEx {
     */
     void writeTwoIICByte(uint8_t first, uint8_t second);
 
+    /*!
+    * @brief Wait for the sensor to acknowledge its address again after a register write.
+    * @details Always waits DFRIRdata_IICsettle milliseconds first, then gives up
+    * DFRIRdata_IICdelay milliseconds after it was called, the old fixed delay.
+    */
+    void waitForAck();
+
     /*!
     * @brief Request the position data. IIC will block the progress until all the data is recevied.
     */
     bool readPosition(PositionData_t& posData, unsigned int length);
 
+    /*!
+    * @brief One compare step of basicAtomic(): reads into the other buffer and compares against the last read.
+    * @param[in,out] index Buffer the last read went into; switched to the one this read went into.
+    * @return Error_Success (positions unpacked) if the two matched, Error_DataMismatch if not, or Error_IICerror.
+    */
+    int basicAtomicStep(unsigned int& index);
+
     /*!
     * @brief Unconditionally unpack basic frame from positionData. Does not update seen flags.
     */
@@ -145,6 +159,11 @@ class DFRobotIRPositionEx {
     */
     unsigned int seenFlags;
 
+    /*!
+    * @brief millis() when the camera was started, frames are ignored until it's had time to settle.
+    */
+    unsigned long startStamp;
+
 public:
   
     /*!
@@ -280,6 +299,17 @@ public:
     */
     int basicAtomic(DFRobotIRPositionEx::Retry_e retry = DFRobotIRPositionEx::Retry_1s);
 
+    /*!
+    * @brief Atomically update basic position data on this and a second camera, on a separate IIC bus.
+    * @details Same as basicAtomic() on each, but with the reads interleaved between the two cameras,
+    * so both frames are taken as close together as the buses allow, rather than one full atomic read after the other.
+    * @param[in] other The second camera.
+    * @param[out] otherError An error code from Errors_e for the second camera.
+    * @param[in] retries Number of extra times to retry getting and matching the position, for each camera.
+    * @return An error code from Errors_e for this camera.
+    */
+    int basicAtomicPair(DFRobotIRPositionEx& other, int& otherError, DFRobotIRPositionEx::Retry_e retry = DFRobotIRPositionEx::Retry_1s);
+
     /*!
     * @brief Atomically update extended position data that includes the size.
     * @details Since there is no aparent signalling to synchronize the read when the position updates,
@@ -80,6 +80,38 @@ void LightgunButtons::Unset()
     reportedPressed = 0;
 }
 
+bool LightgunButtons::Settled() const
+{
+    for(unsigned int i = 0; i < count; ++i) {
+        const Desc_t& btn = ButtonDesc[i];
+        if(btn.pin >= 0 && btn.debounceFifoMask) {
+            uint32_t m = stateFifo[i] & btn.debounceFifoMask;
+            if(m && m != btn.debounceFifoMask) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void LightgunButtons::AttachEdges(void (*callback)(void))
+{
+    for(unsigned int i = 0; i < count; ++i) {
+        if(ButtonDesc[i].pin >= 0) {
+            attachInterrupt(digitalPinToInterrupt(ButtonDesc[i].pin), callback, CHANGE);
+        }
+    }
+}
+
+void LightgunButtons::DetachEdges()
+{
+    for(unsigned int i = 0; i < count; ++i) {
+        if(ButtonDesc[i].pin >= 0) {
+            detachInterrupt(digitalPinToInterrupt(ButtonDesc[i].pin));
+        }
+    }
+}
+
 uint32_t LightgunButtons::Poll(unsigned long minTicks)
 {
     unsigned long m = millis();
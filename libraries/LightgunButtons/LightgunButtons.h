@@ -74,6 +74,18 @@ public:
     /// @return The pressed value.
     uint32_t Poll(unsigned long minTicks = 0);
 
+    /// @brief Whether every button's state FIFO agrees with itself.
+    /// @details While this is true, polling only matters once a pin changes or a debounce runs out;
+    /// while false, a button's mid-change and should be polled as fast as possible until it settles.
+    bool Settled() const;
+
+    /// @brief Calls back on any change of a button pin, to know when polling's needed without polling.
+    /// @details Interrupts are enabled on the core this is called from.
+    void AttachEdges(void (*callback)(void));
+
+    /// @brief Stops calling back on button pin changes.
+    void DetachEdges();
+
     /// @brief Update the internal repeat value.
     /// @details Call after Poll() if the repeat value is required.
     /// @return The repeat value.
@@ -0,0 +1,53 @@
+/*
+ * @file OpenFIRE_Average.h
+ * @brief Run mode averaging of the aimed position over the last few frames
+ * @n Runs wherever the position's last put through anything non-linear, i.e. after a grid fit if there is one:
+ * @n the fit of an average isn't the average of the fits.
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ *
+ * Header-only with no Arduino dependencies, so it can be built & checked on a host compiler.
+ */
+
+#ifndef OpenFIRE_Average_h
+#define OpenFIRE_Average_h
+
+class OpenFIRE_Average {
+
+private:
+
+  int histX[3] = {0, 0, 0};
+  int histY[3] = {0, 0, 0};
+  int index = 0;
+
+public:
+
+  /// @brief 2 position moving average
+  void pair(int &x, int &y) {
+    index = index ? 0 : 1;
+    histX[index] = x;
+    histY[index] = y;
+    x = (histX[0] + histX[1]) / 2;
+    y = (histY[0] + histY[1]) / 2;
+  }
+
+  /// @brief Weighted average of the current position and previous 2
+  void weighted(int &x, int &y) {
+    if(index < 2) {
+      ++index;
+    } else {
+      index = 0;
+    }
+    histX[index] = x;
+    histY[index] = y;
+    x = (x + histX[0] + histX[1] + histX[2]) / 4;
+    y = (y + histY[0] + histY[1] + histY[2]) / 4;
+  }
+};
+
+#endif
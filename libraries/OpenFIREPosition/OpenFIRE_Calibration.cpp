@@ -0,0 +1,207 @@
+/*
+ * @file OpenFIRE_Calibration.cpp
+ * @brief Grid calibration for the perspective output
+ * @n Fits a homography plus a radial term from a 3x3 or 4x4 grid of aimed points,
+ * @n for screens that aren't a flat rectangle (curved panels, projectors with keystone/lens bow).
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ */
+
+#include "OpenFIRE_Calibration.h"
+#include "math.h"
+
+// range the radial term is searched over; well past any bow a real screen would have
+#define CALIBRATION_K1_RANGE 0.5f
+#define CALIBRATION_K1_STEPS 40
+
+void OpenFIRE_Calibration::begin(int width, int height) {
+  centerX = width * 0.5f;
+  centerY = height * 0.5f;
+  scale = width * 0.5f;
+  count = 0;
+  rms = 0.0f;
+}
+
+bool OpenFIRE_Calibration::add(int x, int y, int targetX, int targetY) {
+  if(count >= CALIBRATION_POINTS_MAX) {
+    return false;
+  }
+  inX[count] = (x - centerX) / scale;
+  inY[count] = (y - centerY) / scale;
+  outX[count] = (targetX - centerX) / scale;
+  outY[count] = (targetY - centerY) / scale;
+  count++;
+  return true;
+}
+
+// Linear least-squares homography over the radially corrected samples,
+// solved through the 8x8 normal equations (plenty well conditioned in normalized coordinates).
+bool OpenFIRE_Calibration::fitHomography(float k1, float *h) {
+  double ata[8][9] = {};
+
+  for(uint8_t i = 0; i < count; i++) {
+    double r = 1.0 + k1 * (inX[i] * inX[i] + inY[i] * inY[i]);
+    double x = inX[i] * r;
+    double y = inY[i] * r;
+    double rows[2][9] = {
+      {x, y, 1, 0, 0, 0, -x * outX[i], -y * outX[i], outX[i]},
+      {0, 0, 0, x, y, 1, -x * outY[i], -y * outY[i], outY[i]}
+    };
+    for(uint8_t n = 0; n < 2; n++) {
+      for(uint8_t j = 0; j < 8; j++) {
+        for(uint8_t k = 0; k < 9; k++) {
+          ata[j][k] += rows[n][j] * rows[n][k];
+        }
+      }
+    }
+  }
+
+  // Gaussian elimination with partial pivoting; the last column holds A'b
+  for(uint8_t col = 0; col < 8; col++) {
+    uint8_t pivot = col;
+    for(uint8_t row = col + 1; row < 8; row++) {
+      if(fabs(ata[row][col]) > fabs(ata[pivot][col])) {
+        pivot = row;
+      }
+    }
+    if(fabs(ata[pivot][col]) < 1e-9) {
+      return false;
+    }
+    if(pivot != col) {
+      for(uint8_t k = 0; k < 9; k++) {
+        double t = ata[col][k];
+        ata[col][k] = ata[pivot][k];
+        ata[pivot][k] = t;
+      }
+    }
+    for(uint8_t row = col + 1; row < 8; row++) {
+      double f = ata[row][col] / ata[col][col];
+      for(uint8_t k = col; k < 9; k++) {
+        ata[row][k] -= f * ata[col][k];
+      }
+    }
+  }
+  for(int8_t row = 7; row >= 0; row--) {
+    double sum = ata[row][8];
+    for(uint8_t k = row + 1; k < 8; k++) {
+      sum -= ata[row][k] * h[k];
+    }
+    h[row] = sum / ata[row][row];
+  }
+  return true;
+}
+
+// RMS distance between the targets and where the fit puts the samples, normalized
+float OpenFIRE_Calibration::error(float k1, const float *h) {
+  float sum = 0.0f;
+  for(uint8_t i = 0; i < count; i++) {
+    float r = 1.0f + k1 * (inX[i] * inX[i] + inY[i] * inY[i]);
+    float x = inX[i] * r;
+    float y = inY[i] * r;
+    float d = h[6] * x + h[7] * y + 1.0f;
+    float ex = (h[0] * x + h[1] * y + h[2]) / d - outX[i];
+    float ey = (h[3] * x + h[4] * y + h[5]) / d - outY[i];
+    sum += ex * ex + ey * ey;
+  }
+  return sqrtf(sum / count);
+}
+
+bool OpenFIRE_Calibration::fit(CalibrationFit_t &fit, bool radial) {
+  // a homography alone needs 4 points, the radial term one more
+  if(count < (radial ? 5 : 4)) {
+    return false;
+  }
+
+  // plain homography first, so the radial search can only ever improve on it
+  float bestH[8];
+  if(!fitHomography(0.0f, bestH)) {
+    return false;
+  }
+  float bestK1 = 0.0f;
+  float bestErr = error(0.0f, bestH);
+
+  // golden section search over k1, refitting the homography at each step
+  const float ratio = 0.618034f;
+  float lo = -CALIBRATION_K1_RANGE;
+  float hi = CALIBRATION_K1_RANGE;
+  float h[8];
+  for(uint8_t step = 0; radial && step < CALIBRATION_K1_STEPS; step++) {
+    float a = hi - ratio * (hi - lo);
+    float b = lo + ratio * (hi - lo);
+    float errA = fitHomography(a, h) ? error(a, h) : INFINITY;
+    float errB = fitHomography(b, h) ? error(b, h) : INFINITY;
+    if(errA < errB) {
+      hi = b;
+    } else {
+      lo = a;
+    }
+  }
+  float k1 = (lo + hi) * 0.5f;
+  if(radial && fitHomography(k1, h)) {
+    float err = error(k1, h);
+    if(err < bestErr) {
+      bestErr = err;
+      bestK1 = k1;
+      for(uint8_t i = 0; i < 8; i++) {
+        bestH[i] = h[i];
+      }
+    }
+  }
+
+  fit.points = count;
+  for(uint8_t i = 0; i < 8; i++) {
+    fit.h[i] = bestH[i];
+  }
+  fit.k1 = bestK1;
+  rms = bestErr * scale;
+  return true;
+}
+
+void OpenFIRE_Calibration::target(uint8_t side, uint8_t index, int width, int height, int &x, int &y) {
+  float step = (1.0f - 2 * CALIBRATION_GRID_MARGIN) / (side - 1);
+  x = (int)((CALIBRATION_GRID_MARGIN + (index % side) * step) * width + 0.5f);
+  y = (int)((CALIBRATION_GRID_MARGIN + (index / side) * step) * height + 0.5f);
+}
+
+void OpenFIRE_Calibration::apply(const CalibrationFit_t &fit, int width, int height, int x, int y, int &outX, int &outY) {
+  float cx = width * 0.5f;
+  float cy = height * 0.5f;
+  float s = width * 0.5f;
+  float nx = (x - cx) / s;
+  float ny = (y - cy) / s;
+  float r = 1.0f + fit.k1 * (nx * nx + ny * ny);
+  nx *= r;
+  ny *= r;
+  float d = fit.h[6] * nx + fit.h[7] * ny + 1.0f;
+  // only reachable way off-screen, past the horizon of the fit
+  if(d < 0.01f) {
+    d = 0.01f;
+  }
+  float fx = (fit.h[0] * nx + fit.h[1] * ny + fit.h[2]) / d * s + cx;
+  float fy = (fit.h[3] * nx + fit.h[4] * ny + fit.h[5]) / d * s + cy;
+  // keep well clear of int overflow; anything past the screen gets constrained after anyways
+  fx = fminf(fmaxf(fx, -4.0f * width), 4.0f * width);
+  fy = fminf(fmaxf(fy, -4.0f * height), 4.0f * height);
+  outX = (int)lroundf(fx);
+  outY = (int)lroundf(fy);
+}
+
+bool OpenFIRE_Calibration::valid(const CalibrationFit_t &fit) {
+  if(!fit.points) {
+    return true;
+  }
+  if(fit.points < 5 || fit.points > CALIBRATION_POINTS_MAX) {
+    return false;
+  }
+  for(uint8_t i = 0; i < 8; i++) {
+    if(!isfinite(fit.h[i])) {
+      return false;
+    }
+  }
+  return isfinite(fit.k1) && fabsf(fit.k1) <= CALIBRATION_K1_RANGE;
+}
@@ -0,0 +1,89 @@
+/*
+ * @file OpenFIRE_Calibration.h
+ * @brief Grid calibration for the perspective output
+ * @n Fits a homography plus a radial term from a 3x3 or 4x4 grid of aimed points,
+ * @n for screens that aren't a flat rectangle (curved panels, projectors with keystone/lens bow).
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ *
+ * Has no Arduino dependencies, so the fitter can be built & checked on a host compiler.
+ */
+
+#ifndef OpenFIRE_Calibration_h
+#define OpenFIRE_Calibration_h
+
+#include <stdint.h>
+
+// most points a grid calibration can take (4x4)
+#define CALIBRATION_POINTS_MAX 16
+
+// how far in from the screen edges the outer grid points sit, as a fraction of the screen
+#define CALIBRATION_GRID_MARGIN 0.05f
+
+/// @brief Fitted grid calibration, as stored per profile
+/// @details Everything is in centered coordinates normalized to half the output width,
+/// so the same coefficients hold regardless of the output resolution.
+/// Input is radially corrected first: p' = p * (1 + k1 * |p|^2),
+/// then projected: X = (h0 x' + h1 y' + h2) / (h6 x' + h7 y' + 1), Y = (h3 x' + h4 y' + h5) / (same).
+typedef struct CalibrationFit_s {
+  uint8_t points;       // grid points this was fit from; 0 = no fit, the edge offsets are used instead
+  float h[8];           // homography, row-major, with the last term fixed at 1
+  float k1;             // radial term
+} __attribute__ ((packed)) CalibrationFit_t;
+
+class OpenFIRE_Calibration {
+
+private:
+
+  float inX[CALIBRATION_POINTS_MAX];
+  float inY[CALIBRATION_POINTS_MAX];
+  float outX[CALIBRATION_POINTS_MAX];
+  float outY[CALIBRATION_POINTS_MAX];
+  uint8_t count = 0;
+
+  // the space the perspective output lives in
+  float centerX = 0.0f;
+  float centerY = 0.0f;
+  float scale = 1.0f;
+  float rms = 0.0f;
+
+  bool fitHomography(float k1, float *h);
+  float error(float k1, const float *h);
+
+public:
+
+  /// @brief Clears all samples, and sets the space the perspective output lives in
+  void begin(int width, int height);
+
+  /// @brief Adds a sample: where the perspective output was, and where it should have been
+  /// @return false if there's no room left
+  bool add(int x, int y, int targetX, int targetY);
+
+  /// @brief Samples collected so far
+  uint8_t samples() { return count; }
+
+  /// @brief Least-squares fit over all samples collected
+  /// @param radial Whether to search for the radial term too; without it, the fit is a single
+  /// linear solve and 4 samples will do
+  /// @return false if the samples are degenerate (too few, or all in a line), fit untouched
+  bool fit(CalibrationFit_t &fit, bool radial = true);
+
+  /// @brief RMS distance between each target and where the last fit puts its sample, in output units
+  float residual() { return rms; }
+
+  /// @brief Where grid point index of a side x side grid is on a width x height screen
+  static void target(uint8_t side, uint8_t index, int width, int height, int &x, int &y);
+
+  /// @brief Runs a perspective output position through a fit
+  static void apply(const CalibrationFit_t &fit, int width, int height, int x, int y, int &outX, int &outY);
+
+  /// @brief Checks that a stored fit is usable, e.g. after loading from storage
+  static bool valid(const CalibrationFit_t &fit);
+};
+
+#endif
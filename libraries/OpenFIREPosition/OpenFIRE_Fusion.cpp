@@ -0,0 +1,193 @@
+/*
+ * @file OpenFIRE_Fusion.cpp
+ * @brief Fuses two IR cameras into one set of LED positions
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ */
+
+#include <math.h>
+#include <string.h>
+#include "OpenFIRE_Fusion.h"
+
+// Puts a full frame's four LEDs in a fixed order (top two by Y, then each pair by X),
+// so both cameras' views of the same frame line up LED for LED.
+static void sortQuad(const int* px, const int* py, uint8_t* order) {
+  for(uint8_t i = 0; i < 4; i++) {
+    order[i] = i;
+  }
+  for(uint8_t i = 1; i < 4; i++) {
+    for(uint8_t j = i; j > 0 && py[order[j]] < py[order[j - 1]]; j--) {
+      uint8_t t = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = t;
+    }
+  }
+  for(uint8_t i = 0; i < 4; i += 2) {
+    if(px[order[i + 1]] < px[order[i]]) {
+      uint8_t t = order[i];
+      order[i] = order[i + 1];
+      order[i + 1] = t;
+    }
+  }
+}
+
+void OpenFIRE_Fusion::reset() {
+  extrinsics = {};
+  learnFrames = 0;
+}
+
+bool OpenFIRE_Fusion::refit() {
+  learner.begin(CamResX, CamResY);
+  for(uint8_t k = 0; k < learnFrames; k++) {
+    for(uint8_t i = 0; i < 4; i++) {
+      learner.add(learnX[k][1][i], learnY[k][1][i], learnX[k][0][i], learnY[k][0][i]);
+    }
+  }
+  // a single linear solve: the lenses' own distortion is small next to the camera's resolution
+  CalibrationFit_t fit;
+  if(!learner.fit(fit, false) || learner.residual() > FUSION_LEARN_ERROR) {
+    return false;
+  }
+  extrinsics = fit;
+  return true;
+}
+
+void OpenFIRE_Fusion::learn(const int* px0, const int* py0, const int* px1, const int* py1) {
+  float cx = (px0[0] + px0[1] + px0[2] + px0[3]) * 0.25f;
+  float cy = (py0[0] + py0[1] + py0[2] + py0[3]) * 0.25f;
+
+  // how close this frame is to each one kept
+  float dist[FUSION_LEARN_FRAMES];
+  for(uint8_t k = 0; k < learnFrames; k++) {
+    dist[k] = (cx - learnCX[k]) * (cx - learnCX[k]) + (cy - learnCY[k]) * (cy - learnCY[k]);
+    if(dist[k] < FUSION_LEARN_SPREAD * FUSION_LEARN_SPREAD) {
+      return;
+    }
+  }
+
+  uint8_t slot = learnFrames;
+  if(learnFrames == FUSION_LEARN_FRAMES) {
+    // full: this frame takes the place of one of the two kept frames closest together,
+    // but only if that leaves the set more spread out than before
+    uint8_t a = 0, b = 1;
+    float closest = INFINITY;
+    for(uint8_t i = 0; i < learnFrames; i++) {
+      for(uint8_t j = i + 1; j < learnFrames; j++) {
+        float d = (learnCX[i] - learnCX[j]) * (learnCX[i] - learnCX[j]) + (learnCY[i] - learnCY[j]) * (learnCY[i] - learnCY[j]);
+        if(d < closest) {
+          closest = d, a = i, b = j;
+        }
+      }
+    }
+    float spreadA = INFINITY, spreadB = INFINITY;
+    for(uint8_t k = 0; k < learnFrames; k++) {
+      if(k != a && dist[k] < spreadA) {
+        spreadA = dist[k];
+      }
+      if(k != b && dist[k] < spreadB) {
+        spreadB = dist[k];
+      }
+    }
+    slot = spreadA > spreadB ? a : b;
+    if((spreadA > spreadB ? spreadA : spreadB) <= closest) {
+      return;
+    }
+  }
+
+  // keep what's there, in case the fit doesn't take this frame
+  int keepX[2][4], keepY[2][4];
+  float keepCX = learnCX[slot], keepCY = learnCY[slot];
+  memcpy(keepX, learnX[slot], sizeof(keepX));
+  memcpy(keepY, learnY[slot], sizeof(keepY));
+
+  uint8_t order0[4], order1[4];
+  sortQuad(px0, py0, order0);
+  sortQuad(px1, py1, order1);
+  for(uint8_t i = 0; i < 4; i++) {
+    learnX[slot][0][i] = px0[order0[i]];
+    learnY[slot][0][i] = py0[order0[i]];
+    learnX[slot][1][i] = px1[order1[i]];
+    learnY[slot][1][i] = py1[order1[i]];
+  }
+  learnCX[slot] = cx;
+  learnCY[slot] = cy;
+
+  bool added = slot == learnFrames;
+  if(added) {
+    learnFrames++;
+  }
+  // one frame fits exactly whatever it's given, so wait for a second to check it against
+  if(learnFrames < 2 || refit()) {
+    return;
+  }
+  // doesn't fit with the rest (LEDs matched up wrong, or a reflection)
+  if(!Learned()) {
+    // nothing's been proven good yet, so it may as well be the others that are off: start over from this one
+    memmove(learnX[0], learnX[slot], sizeof(learnX[0]));
+    memmove(learnY[0], learnY[slot], sizeof(learnY[0]));
+    learnCX[0] = cx;
+    learnCY[0] = cy;
+    learnFrames = 1;
+  } else if(added) {
+    learnFrames--;
+  } else {
+    memcpy(learnX[slot], keepX, sizeof(keepX));
+    memcpy(learnY[slot], keepY, sizeof(keepY));
+    learnCX[slot] = keepCX;
+    learnCY[slot] = keepCY;
+  }
+}
+
+void OpenFIRE_Fusion::begin(const int* px0, const int* py0, unsigned int seen0,
+                            const int* px1, const int* py1, unsigned int seen1) {
+  // the first camera's LEDs keep their slots, and win wherever both cameras see an LED
+  for(uint8_t i = 0; i < 4; i++) {
+    positionX[i] = px0[i];
+    positionY[i] = py0[i];
+  }
+  seenFlags = seen0;
+  secondFlags = 0;
+
+  if(seen0 == 0x0F && seen1 == 0x0F) {
+    learn(px0, py0, px1, py1);
+  }
+  if(!Learned()) {
+    return;
+  }
+
+  for(uint8_t j = 0; j < 4; j++) {
+    if(!(seen1 & (1 << j))) {
+      continue;
+    }
+    int fx, fy;
+    OpenFIRE_Calibration::apply(extrinsics, CamResX, CamResY, px1[j], py1[j], fx, fy);
+
+    // already seen by the first camera?
+    bool matched = false;
+    for(uint8_t i = 0; i < 4 && !matched; i++) {
+      if(seen0 & (1 << i)) {
+        int dx = fx - px0[i], dy = fy - py0[i];
+        matched = dx * dx + dy * dy <= FUSION_MERGE_RADIUS * FUSION_MERGE_RADIUS;
+      }
+    }
+    if(matched) {
+      continue;
+    }
+
+    // only the second camera has it: into the first free slot
+    for(uint8_t i = 0; i < 4; i++) {
+      if(!(seenFlags & (1 << i))) {
+        positionX[i] = fx;
+        positionY[i] = fy;
+        seenFlags |= 1 << i;
+        secondFlags |= 1 << i;
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * @file OpenFIRE_Fusion.h
+ * @brief Fuses two IR cameras into one set of LED positions
+ * @n For guns with a second camera (angled, or a different lens) to cover more of the screen edges.
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ *
+ * Both cameras sit on the same gun, a few cm apart and looking at a screen meters away, so as far as
+ * the LEDs are concerned the second camera only differs by a rotation and a lens: its image maps onto
+ * the first camera's by one fixed homography. That's the second camera's extrinsics here, and it's
+ * learned on the fly from frames where both cameras see all four LEDs. The frames kept to fit it from
+ * are the most spread out ones seen so far, and it's refit whenever that set gets wider; each refit is
+ * one 8x8 solve in double (a few ms on an RP2040), so it's not something that happens every frame.
+ *
+ * Has no Arduino dependencies, so it can be built & checked on a host compiler.
+ */
+
+#ifndef OpenFIRE_Fusion_h
+#define OpenFIRE_Fusion_h
+
+#include <stdint.h>
+#include "OpenFIREConst.h"
+#include "OpenFIRE_Calibration.h"
+
+// frames, each with all four LEDs seen by both cameras, the extrinsics are fit from
+#define FUSION_LEARN_FRAMES (CALIBRATION_POINTS_MAX / 4)
+
+// least distance between those frames, in camera pixels (measured between the LEDs' middles);
+// samples from one spot don't pin down anything past it
+#define FUSION_LEARN_SPREAD 64
+
+// worst RMS error a learned fit can have and still be used, in camera pixels
+#define FUSION_LEARN_ERROR 3.0f
+
+// LEDs from both cameras closer than this are the same LED, in camera pixels
+#define FUSION_MERGE_RADIUS 12
+
+class OpenFIRE_Fusion {
+
+private:
+
+  OpenFIRE_Calibration learner;
+
+  // the frames the extrinsics are fit from, kept as far apart as they've been seen:
+  // each camera's four LEDs in matching order, and where their middle was in the first camera
+  int learnX[FUSION_LEARN_FRAMES][2][4];
+  int learnY[FUSION_LEARN_FRAMES][2][4];
+  float learnCX[FUSION_LEARN_FRAMES];
+  float learnCY[FUSION_LEARN_FRAMES];
+  uint8_t learnFrames = 0;
+
+  // second camera's image -> first camera's image
+  CalibrationFit_t extrinsics = {};
+
+  int positionX[4] = {0};
+  int positionY[4] = {0};
+  unsigned int seenFlags = 0;
+  unsigned int secondFlags = 0;
+
+  void learn(const int* px0, const int* py0, const int* px1, const int* py1);
+  bool refit();
+
+public:
+
+  /// @brief Forgets the extrinsics, to be learned again (e.g. after a camera's been swapped)
+  void reset();
+
+  /// @brief Second camera's image -> first camera's image, points == 0 until learned
+  const CalibrationFit_t &Extrinsics() const { return extrinsics; }
+
+  /// @brief Whether the second camera is being used yet
+  bool Learned() const { return extrinsics.points != 0; }
+
+  /// @brief Fuses a pair of frames, taken as close together as possible
+  /// @details Positions & seen flags as from DFRobotIRPositionEx. The result is in the first camera's
+  /// image, and can lie outside of it where only the second camera saw an LED.
+  void begin(const int* px0, const int* py0, unsigned int seen0,
+             const int* px1, const int* py1, unsigned int seen1);
+
+  const int* xPositions() const { return positionX; }
+  const int* yPositions() const { return positionY; }
+  int x(int index) const { return positionX[index]; }
+  int y(int index) const { return positionY[index]; }
+
+  /// @brief Bit mask of positions seen by either camera
+  unsigned int seen() const { return seenFlags; }
+
+  /// @brief Bit mask of positions that came from the second camera alone
+  unsigned int second() const { return secondFlags; }
+};
+
+#endif
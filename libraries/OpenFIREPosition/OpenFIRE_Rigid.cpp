@@ -0,0 +1,280 @@
+/*!
+ * @file OpenFIRE_Rigid.cpp
+ * @brief Light Gun library for 4 LED setup
+ * @n CPP file for the rigid-body square layout tracker
+ *
+ * @copyright That One Seong, 2024
+ * @copyright GNU Lesser General Public License
+ *
+ * @author [That One Seong](SeongsSeongs@gmail.com)
+ * @version V1.0
+ * @date 2024
+ */
+
+#include <math.h>
+#include "OpenFIRE_Rigid.h"
+
+// how much of last frame's motion is carried into the next frame's prediction
+constexpr float carry = 0.75f;
+
+// matchings past the best few by prior aren't worth a solve
+constexpr unsigned int candidates = 3;
+
+// every ordering of the 4 corners, in lexicographic order;
+// the first n entries of each row cover every way to match n LEDs, with repeats next to each other
+static const uint8_t orders[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 3, 2, 1},
+    {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 0, 2}, {1, 3, 2, 0},
+    {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0},
+    {3, 0, 1, 2}, {3, 0, 2, 1}, {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0}
+};
+
+void OpenFIRE_Rigid::init(const float* ox, const float* oy)
+{
+    // top two by Y, then left/right of each pair by X
+    uint8_t order[4] = {0, 1, 2, 3};
+    for(unsigned int i = 1; i < 4; i++) {
+        for(unsigned int j = i; j > 0 && oy[order[j]] < oy[order[j - 1]]; j--) {
+            uint8_t t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    }
+    for(unsigned int i = 0; i < 4; i += 2) {
+        uint8_t left = order[i], right = order[i + 1];
+        if(ox[right] < ox[left]) {
+            left = order[i + 1], right = order[i];
+        }
+        prevX[i] = ox[left], prevY[i] = oy[left];
+        prevX[i + 1] = ox[right], prevY[i + 1] = oy[right];
+    }
+    for(unsigned int i = 0; i < 4; i++) {
+        tmplX[i] = prevX[i], tmplY[i] = prevY[i];
+        velX[i] = 0.0f, velY[i] = 0.0f;
+    }
+    measure();
+    residual = 0.0f;
+    lostFrames = 0;
+    guessed = false;
+    tracking = true;
+}
+
+void OpenFIRE_Rigid::measure()
+{
+    // same as OpenFIRE_Square: top & bottom edges averaged for width, left & right for height
+    width = (hypotf(tmplX[1] - tmplX[0], tmplY[1] - tmplY[0]) + hypotf(tmplX[3] - tmplX[2], tmplY[3] - tmplY[2])) / 2.0f;
+    height = (hypotf(tmplX[2] - tmplX[0], tmplY[2] - tmplY[0]) + hypotf(tmplX[3] - tmplX[1], tmplY[3] - tmplY[1])) / 2.0f;
+}
+
+float OpenFIRE_Rigid::solve(const float* ox, const float* oy, const uint8_t* corner, uint8_t count,
+                            float &c, float &s, float &tx, float &ty)
+{
+    // centroids of the matched template corners and the seen LEDs
+    float mtX = 0.0f, mtY = 0.0f, moX = 0.0f, moY = 0.0f;
+    for(unsigned int j = 0; j < count; j++) {
+        mtX += tmplX[corner[j]], mtY += tmplY[corner[j]];
+        moX += ox[j], moY += oy[j];
+    }
+    mtX /= count, mtY /= count;
+    moX /= count, moY /= count;
+
+    // least squares for [c -s; s c] * template + t = seen, about the centroids
+    float a = 0.0f, b = 0.0f, n = 0.0f;
+    for(unsigned int j = 0; j < count; j++) {
+        float dtX = tmplX[corner[j]] - mtX, dtY = tmplY[corner[j]] - mtY;
+        float doX = ox[j] - moX, doY = oy[j] - moY;
+        a += dtX * doX + dtY * doY;
+        b += dtX * doY - dtY * doX;
+        n += dtX * dtX + dtY * dtY;
+    }
+    if(n <= 0.0f) {
+        return -1.0f;
+    }
+    c = a / n, s = b / n;
+
+    // a mismatch shows up as the quad flipping over or changing size wildly
+    float scale2 = c * c + s * s;
+    if(c <= 0.0f || scale2 < RIGID_SCALE_MIN * RIGID_SCALE_MIN || scale2 > RIGID_SCALE_MAX * RIGID_SCALE_MAX) {
+        return -1.0f;
+    }
+    tx = moX - (c * mtX - s * mtY);
+    ty = moY - (s * mtX + c * mtY);
+
+    float err = 0.0f;
+    for(unsigned int j = 0; j < count; j++) {
+        float eX = c * tmplX[corner[j]] - s * tmplY[corner[j]] + tx - ox[j];
+        float eY = s * tmplX[corner[j]] + c * tmplY[corner[j]] + ty - oy[j];
+        err += eX * eX + eY * eY;
+    }
+    return err;
+}
+
+void OpenFIRE_Rigid::begin(const int* px, const int* py, unsigned int seen)
+{
+    seenFlags = seen;
+
+    // seen LEDs only, packed, in the same mirrored space as OpenFIRE_Square
+    float ox[4], oy[4];
+    uint8_t count = 0;
+    for(unsigned int i = 0; i < 4; i++) {
+        if(seen & (1 << i)) {
+            ox[count] = MouseMaxX - (px[i] << CamToMouseShift);
+            oy[count] = py[i] << CamToMouseShift;
+            count++;
+        }
+    }
+
+    // Wait for all positions to be recognised before starting,
+    // and start over the same way after losing them for a while
+    bool stale = !tracking || lostFrames >= RIGID_LOST_FRAMES;
+    if(stale && count == 4) {
+        init(ox, oy);
+        output();
+        return;
+    }
+    if(!tracking || !count || (stale && count == 1)) {
+        // nothing to go on: hold the last corners
+        if(lostFrames < RIGID_LOST_FRAMES) {
+            lostFrames++;
+        }
+        return;
+    }
+
+    // where each corner should be this frame
+    float predX[4], predY[4];
+    for(unsigned int i = 0; i < 4; i++) {
+        predX[i] = prevX[i] + velX[i] * carry;
+        predY[i] = prevY[i] + velY[i] * carry;
+    }
+
+    // squared distance from each seen LED to each predicted corner
+    float dist[4][4];
+    float sumOX = 0.0f, sumOY = 0.0f;
+    for(unsigned int j = 0; j < count; j++) {
+        for(unsigned int i = 0; i < 4; i++) {
+            float dX = ox[j] - predX[i], dY = oy[j] - predY[i];
+            dist[j][i] = dX * dX + dY * dY;
+        }
+        sumOX += ox[j], sumOY += oy[j];
+    }
+
+    // rank matchings by how far they are from the prediction; when the prediction can't be trusted for
+    // position (stale, or only had one LED to go on) or isn't needed for it (all four seen),
+    // only the shape counts (the distance with the overall shift taken out)
+    bool shapeOnly = count > 1 && (stale || guessed || count == 4);
+    float bestPrior[candidates];
+    uint8_t bestRow[candidates];
+    uint8_t ranked = 0;
+    for(uint8_t r = 0; r < 24; r++) {
+        const uint8_t* corner = orders[r];
+        if(r && corner[0] == orders[r - 1][0] && (count < 2 || corner[1] == orders[r - 1][1]) &&
+                (count < 3 || corner[2] == orders[r - 1][2])) {
+            continue;
+        }
+        float prior = 0.0f;
+        for(unsigned int j = 0; j < count; j++) {
+            prior += dist[j][corner[j]];
+        }
+        if(shapeOnly) {
+            float shiftX = sumOX, shiftY = sumOY;
+            for(unsigned int j = 0; j < count; j++) {
+                shiftX -= predX[corner[j]], shiftY -= predY[corner[j]];
+            }
+            prior -= (shiftX * shiftX + shiftY * shiftY) / count;
+        }
+        uint8_t slot = ranked < candidates ? ranked++ : candidates;
+        while(slot > 0 && prior < bestPrior[slot - 1]) {
+            if(slot < candidates) {
+                bestPrior[slot] = bestPrior[slot - 1];
+                bestRow[slot] = bestRow[slot - 1];
+            }
+            slot--;
+        }
+        if(slot < candidates) {
+            bestPrior[slot] = prior;
+            bestRow[slot] = r;
+        }
+    }
+
+    float newX[4], newY[4];
+    const uint8_t* corner = orders[bestRow[0]];
+    if(count == 1) {
+        // one LED: the quad moves with it
+        float shiftX = ox[0] - predX[corner[0]], shiftY = oy[0] - predY[corner[0]];
+        for(unsigned int i = 0; i < 4; i++) {
+            newX[i] = predX[i] + shiftX;
+            newY[i] = predY[i] + shiftY;
+        }
+        residual = 0.0f;
+        guessed = true;
+    } else {
+        // pick the matching that best fits both the prediction and the template's shape
+        float bestCost = 0.0f, c = 1.0f, s = 0.0f, tx = 0.0f, ty = 0.0f;
+        int best = -1;
+        for(unsigned int k = 0; k < ranked; k++) {
+            float kc, ks, ktx, kty;
+            float err = solve(ox, oy, orders[bestRow[k]], count, kc, ks, ktx, kty);
+            if(err < 0.0f) {
+                continue;
+            }
+            float cost = bestPrior[k] + err;
+            if(best < 0 || cost < bestCost) {
+                best = k, bestCost = cost;
+                c = kc, s = ks, tx = ktx, ty = kty;
+                residual = err;
+            }
+        }
+        if(best < 0) {
+            // no sensible fit: hold the last corners
+            if(lostFrames < RIGID_LOST_FRAMES) {
+                lostFrames++;
+            }
+            return;
+        }
+        corner = orders[bestRow[best]];
+        guessed = false;
+        for(unsigned int i = 0; i < 4; i++) {
+            newX[i] = c * tmplX[i] - s * tmplY[i] + tx;
+            newY[i] = s * tmplX[i] + c * tmplY[i] + ty;
+        }
+    }
+
+    // seen corners go out as measured
+    for(unsigned int j = 0; j < count; j++) {
+        newX[corner[j]] = ox[j];
+        newY[corner[j]] = oy[j];
+    }
+
+    for(unsigned int i = 0; i < 4; i++) {
+        if(stale) {
+            velX[i] = 0.0f, velY[i] = 0.0f;
+        } else {
+            velX[i] = newX[i] - prevX[i];
+            velY[i] = newY[i] - prevY[i];
+        }
+        prevX[i] = newX[i];
+        prevY[i] = newY[i];
+        if(count == 4) {
+            tmplX[i] = newX[i];
+            tmplY[i] = newY[i];
+        }
+    }
+    if(count == 4) {
+        measure();
+    }
+    lostFrames = 0;
+    output();
+}
+
+void OpenFIRE_Rigid::output()
+{
+    for(unsigned int i = 0; i < 4; i++) {
+        FinalX[i] = lroundf(prevX[i]);
+        FinalY[i] = lroundf(prevY[i]);
+    }
+    medianY = (FinalY[0] + FinalY[1] + FinalY[2] + FinalY[3] + 2) / 4;
+    medianX = (FinalX[0] + FinalX[1] + FinalX[2] + FinalX[3] + 2) / 4;
+
+    // same tilt as OpenFIRE_Square: the top & bottom edges averaged
+    angle = (atan2f(FinalY[0] - FinalY[1], FinalX[1] - FinalX[0]) + atan2f(FinalY[2] - FinalY[3], FinalX[3] - FinalX[2])) / 2.0f;
+}
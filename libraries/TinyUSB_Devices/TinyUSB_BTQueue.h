@@ -0,0 +1,157 @@
+/*
+ * Report queue for the Bluetooth side of the HID devices.
+ *
+ * Over USB, every report gets its own poll; over Bluetooth Classic, each
+ * send has to wait for the link, and at the camera's 209Hz a moving cursor
+ * alone is more than a typical HID link carries - reports pile up in the
+ * stack, and the cursor trails further and further behind.
+ *
+ * So reports are staged here instead, and sent out no faster than the link
+ * interval. Between sends, only the newest report per ID is kept (deltas in
+ * relative mode are summed instead), so whatever goes out is always the
+ * latest. Reports carrying a button/key change are kept in order and go out
+ * ahead of everything else, so presses and releases aren't merged away.
+ *
+ * This header has no Arduino or Bluetooth dependencies, so it can be built &
+ * checked on a host compiler. It does no locking of its own.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef _TINYUSB_BTQUEUE_H_
+#define _TINYUSB_BTQUEUE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// report IDs 0-7
+#define BTQUEUE_IDS 8
+
+// longest report, in bytes (keyboard)
+#define BTQUEUE_REPORT_MAX 8
+
+// button/key changes that can be held in order; past that, they're merged like any other report
+#define BTQUEUE_EDGES 8
+
+// time between sends, in microseconds; 125Hz, about what a Bluetooth Classic HID link is good for
+#define BTQUEUE_INTERVAL_DEFAULT 8000
+
+class BTQueue_ {
+public:
+	/// @brief Stages a report
+	/// @param edge Whether it carries a button/key change, and so has to go out as-is, in order
+	/// @param additive Whether it's relative deltas (int16 pairs after the buttons byte), to be summed rather than replaced
+	void queue(uint8_t id, const void *data, uint8_t len, bool edge, bool additive = false) {
+		if(id >= BTQUEUE_IDS || len > BTQUEUE_REPORT_MAX) {
+			return;
+		}
+		Report_s &pending = _latest[id];
+		// no room to keep it in order: the end state still gets there
+		if(!edge || _edgeCount >= BTQUEUE_EDGES) {
+			if(additive && pending.len) {
+				pending.data[0] = ((const uint8_t*)data)[0];
+				add(pending, (const uint8_t*)data, len);
+			} else {
+				pending.id = id;
+				pending.len = len;
+				memcpy(pending.data, data, len);
+			}
+			return;
+		}
+
+		Report_s *slot = &_edges[(_edgeHead + _edgeCount++) % BTQUEUE_EDGES];
+		slot->id = id;
+		slot->len = len;
+		memcpy(slot->data, data, len);
+		if(additive && pending.len) {
+			// deltas still waiting go out with this one
+			add(*slot, pending.data, pending.len);
+		}
+		// this is newer than whatever was waiting
+		pending.len = 0;
+	}
+
+	/// @brief Takes the next report to send, if the link has room for one by now
+	/// @param data Room for BTQUEUE_REPORT_MAX bytes
+	/// @return true with id, data & len filled in
+	bool next(uint32_t now, uint8_t &id, uint8_t *data, uint8_t &len) {
+		if(_sentAny && now - _lastSend < _interval) {
+			return false;
+		}
+		const Report_s *out = nullptr;
+		if(_edgeCount) {
+			out = &_edges[_edgeHead];
+			_edgeHead = (_edgeHead + 1) % BTQUEUE_EDGES;
+			_edgeCount--;
+		} else {
+			// take turns between IDs, so a busy cursor can't starve anything else
+			for(uint8_t i = 1; i <= BTQUEUE_IDS && !out; i++) {
+				uint8_t n = (_turn + i) % BTQUEUE_IDS;
+				if(_latest[n].len) {
+					_turn = n;
+					out = &_latest[n];
+				}
+			}
+			if(!out) {
+				return false;
+			}
+		}
+		id = out->id;
+		len = out->len;
+		memcpy(data, out->data, len);
+		if(out == &_latest[id]) {
+			_latest[id].len = 0;
+		}
+		_lastSend = now;
+		_sentAny = true;
+		return true;
+	}
+
+	/// @brief Sets the least time between sends, in microseconds
+	void setInterval(uint32_t us) { _interval = us; }
+
+	/// @brief Drops everything staged, e.g. on reconnect
+	void clear() {
+		_edgeCount = 0;
+		for(uint8_t i = 0; i < BTQUEUE_IDS; i++) {
+			_latest[i].len = 0;
+		}
+		_sentAny = false;
+	}
+
+private:
+	typedef struct {
+		uint8_t id;
+		uint8_t len;          // 0 = nothing waiting
+		uint8_t data[BTQUEUE_REPORT_MAX];
+	} Report_s;
+
+	// sums relative deltas into a staged report, saturating; the buttons byte is left alone
+	static void add(Report_s &into, const uint8_t *data, uint8_t len) {
+		for(uint8_t i = 1; i + 1 < len && i + 1 < into.len; i += 2) {
+			int32_t sum = (int16_t)(into.data[i] | (into.data[i + 1] << 8)) + (int16_t)(data[i] | (data[i + 1] << 8));
+			sum = sum > 32767 ? 32767 : (sum < -32767 ? -32767 : sum);
+			into.data[i] = sum & 0xFF;
+			into.data[i + 1] = (sum >> 8) & 0xFF;
+		}
+	}
+
+	Report_s _edges[BTQUEUE_EDGES];
+	uint8_t _edgeHead = 0;
+	uint8_t _edgeCount = 0;
+	Report_s _latest[BTQUEUE_IDS] = {};
+	uint8_t _turn = 0;
+	uint32_t _interval = BTQUEUE_INTERVAL_DEFAULT;
+	uint32_t _lastSend = 0;
+	bool _sentAny = false;
+};
+
+#endif // _TINYUSB_BTQUEUE_H_
@@ -0,0 +1,159 @@
+/*
+ * Single composite report carrying the mouse, keyboard and gamepad state
+ * together, so a busy frame (e.g. a trigger pull mid-move, with start held)
+ * goes out as one USB transaction instead of one per device.
+ *
+ * Only standard HID usages are used, so any host or frontend that reads the
+ * collection can make sense of it; the separate mouse/keyboard/gamepad
+ * reports are still there for everything else.
+ *
+ * This header has no Arduino or TinyUSB dependencies, so the descriptor and
+ * the packing can be built & checked on a host compiler.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef _TINYUSB_COMPOSITE_H_
+#define _TINYUSB_COMPOSITE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define TUD_HID_REPORT_DESC_COMPOSITE(...) \
+	0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x08,        /* Usage (Multi-axis Controller) */ \
+	0xA1, 0x01,        /* Collection (Application) */ \
+	__VA_ARGS__ \
+	/* Mouse: 5 buttons, absolute 0-32767 cursor */ \
+	0x09, 0x01,        /*   Usage (Pointer) */ \
+	0xA1, 0x00,        /*   Collection (Physical) */ \
+	0x05, 0x09,        /*     Usage Page (Button) */ \
+	0x19, 0x01,        /*     Usage Minimum (0x01) */ \
+	0x29, 0x05,        /*     Usage Maximum (0x05) */ \
+	0x15, 0x00,        /*     Logical Minimum (0) */ \
+	0x25, 0x01,        /*     Logical Maximum (1) */ \
+	0x95, 0x05,        /*     Report Count (5) */ \
+	0x75, 0x01,        /*     Report Size (1) */ \
+	0x81, 0x02,        /*     Input (Data,Var,Abs) */ \
+	0x95, 0x01,        /*     Report Count (1) */ \
+	0x75, 0x03,        /*     Report Size (3) */ \
+	0x81, 0x03,        /*     Input (Const,Var,Abs) */ \
+	0x05, 0x01,        /*     Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x30,        /*     Usage (X) */ \
+	0x09, 0x31,        /*     Usage (Y) */ \
+	0x16, 0x00, 0x00,  /*     Logical Minimum (0) */ \
+	0x26, 0xFF, 0x7F,  /*     Logical Maximum (32767) */ \
+	0x75, 0x10,        /*     Report Size (16) */ \
+	0x95, 0x02,        /*     Report Count (2) */ \
+	0x81, 0x02,        /*     Input (Data,Var,Abs) */ \
+	0xC0,              /*   End Collection */ \
+	/* Keyboard: modifiers, reserved byte, 6 key array */ \
+	0x05, 0x07,        /*   Usage Page (Kbrd/Keypad) */ \
+	0x19, 0xE0,        /*   Usage Minimum (0xE0) */ \
+	0x29, 0xE7,        /*   Usage Maximum (0xE7) */ \
+	0x15, 0x00,        /*   Logical Minimum (0) */ \
+	0x25, 0x01,        /*   Logical Maximum (1) */ \
+	0x95, 0x08,        /*   Report Count (8) */ \
+	0x75, 0x01,        /*   Report Size (1) */ \
+	0x81, 0x02,        /*   Input (Data,Var,Abs) */ \
+	0x95, 0x01,        /*   Report Count (1) */ \
+	0x75, 0x08,        /*   Report Size (8) */ \
+	0x81, 0x03,        /*   Input (Const,Var,Abs) */ \
+	0x19, 0x00,        /*   Usage Minimum (0x00) */ \
+	0x29, 0xFF,        /*   Usage Maximum (0xFF) */ \
+	0x26, 0xFF, 0x00,  /*   Logical Maximum (255) */ \
+	0x95, 0x06,        /*   Report Count (6) */ \
+	0x75, 0x08,        /*   Report Size (8) */ \
+	0x81, 0x00,        /*   Input (Data,Array,Abs) */ \
+	/* Gamepad: 16-bit X, Y, Rx, Ry, hat, 16 buttons */ \
+	0x05, 0x01,        /*   Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x30,        /*   Usage (X) */ \
+	0x09, 0x31,        /*   Usage (Y) */ \
+	0x09, 0x33,        /*   Usage (Rx) */ \
+	0x09, 0x34,        /*   Usage (Ry) */ \
+	0x16, 0x01, 0x80,  /*   Logical Minimum (-32767) */ \
+	0x26, 0xFF, 0x7F,  /*   Logical Maximum (32767) */ \
+	0x95, 0x04,        /*   Report Count (4) */ \
+	0x75, 0x10,        /*   Report Size (16) */ \
+	0x81, 0x02,        /*   Input (Data,Var,Abs) */ \
+	0x09, 0x39,        /*   Usage (Hat switch) */ \
+	0x15, 0x01,        /*   Logical Minimum (1) */ \
+	0x25, 0x08,        /*   Logical Maximum (8) */ \
+	0x35, 0x00,        /*   Physical Minimum (0) */ \
+	0x46, 0x3B, 0x01,  /*   Physical Maximum (315) */ \
+	0x95, 0x01,        /*   Report Count (1) */ \
+	0x75, 0x08,        /*   Report Size (8) */ \
+	0x81, 0x42,        /*   Input (Data,Var,Abs,Null State) */ \
+	0x05, 0x09,        /*   Usage Page (Button) */ \
+	0x19, 0x01,        /*   Usage Minimum (0x01) */ \
+	0x29, 0x10,        /*   Usage Maximum (0x10) */ \
+	0x15, 0x00,        /*   Logical Minimum (0) */ \
+	0x25, 0x01,        /*   Logical Maximum (1) */ \
+	0x95, 0x10,        /*   Report Count (16) */ \
+	0x75, 0x01,        /*   Report Size (1) */ \
+	0x81, 0x02,        /*   Input (Data,Var,Abs) */ \
+	0xC0               /* End Collection */
+
+/// @brief Composite report layout, in the same order as the descriptor above
+typedef struct {
+	uint8_t mouseButtons;
+	uint16_t mouseX;
+	uint16_t mouseY;
+	uint8_t keyModifiers;
+	uint8_t keyReserved;
+	uint8_t keys[6];
+	int16_t padX;
+	int16_t padY;
+	int16_t padRx;
+	int16_t padRy;
+	uint8_t padHat;
+	uint16_t padButtons;
+} __attribute__ ((packed)) compositeReport_s;
+
+/// @brief Packs device state into the composite report, and decides whether it needs sending
+/// @details The report is built fresh from every device's current state right before it goes out,
+/// rather than each device staging its own copy - so with devices being updated from both cores,
+/// whatever's sent is always the latest, and nothing's lost to two updates landing at once.
+class Composite_ {
+public:
+	static void packMouse(compositeReport_s &r, uint8_t buttons, uint16_t x, uint16_t y) {
+		r.mouseButtons = buttons;
+		r.mouseX = x;
+		r.mouseY = y;
+	}
+
+	static void packKeys(compositeReport_s &r, uint8_t modifiers, const uint8_t *keys) {
+		r.keyModifiers = modifiers;
+		r.keyReserved = 0;
+		memcpy(r.keys, keys, sizeof(r.keys));
+	}
+
+	static void packPad(compositeReport_s &r, int16_t x, int16_t y, int16_t rx, int16_t ry, uint8_t hat, uint16_t buttons) {
+		r.padX = x, r.padY = y, r.padRx = rx, r.padRy = ry;
+		r.padHat = hat;
+		r.padButtons = buttons;
+	}
+
+	/// @brief Checks a freshly packed report against the last one sent
+	bool changed(const compositeReport_s &next) { return !_sent || memcmp(&next, &_last, sizeof(_last)); }
+
+	/// @brief Records a report as sent
+	void sent(const compositeReport_s &report) { _last = report, _sent = true; }
+
+	/// @brief Forgets the last report, so the next one goes out regardless
+	void reset() { _sent = false; }
+
+private:
+	compositeReport_s _last = {};
+	bool _sent = false;
+};
+
+#endif // _TINYUSB_COMPOSITE_H_
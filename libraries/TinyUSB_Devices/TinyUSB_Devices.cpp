@@ -15,6 +15,8 @@
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
 #include <HID_Bluetooth.h>
 #include <PicoBluetoothHID.h>
+#include <pico/critical_section.h>
+#include "TinyUSB_BTQueue.h"
 #endif // ARDUINO_RASPBERRY_PI_PICO_W
 
 /*****************************
@@ -25,13 +27,19 @@ Adafruit_USBD_HID usbHid;
 enum HID_RID_e{
     HID_RID_KEYBOARD = 1,
     HID_RID_MOUSE,
-    HID_RID_GAMEPAD
+    HID_RID_GAMEPAD,
+    HID_RID_RELMOUSE,
+    HID_RID_DIGITIZER,
+    HID_RID_COMPOSITE
 };
 
 uint8_t desc_hid_report[] = {
-    TUD_HID_REPORT_DESC_KEYBOARD(HID_REPORT_ID(1)),
-    TUD_HID_REPORT_DESC_ABSMOUSE5(HID_REPORT_ID(2)),
-    TUD_HID_REPORT_DESC_GAMEPAD16(HID_REPORT_ID(3))
+    TUD_HID_REPORT_DESC_KEYBOARD(HID_REPORT_ID(HID_RID_KEYBOARD)),
+    TUD_HID_REPORT_DESC_ABSMOUSE5(HID_REPORT_ID(HID_RID_MOUSE)),
+    TUD_HID_REPORT_DESC_GAMEPAD16(HID_REPORT_ID(HID_RID_GAMEPAD)),
+    TUD_HID_REPORT_DESC_RELMOUSE5(HID_REPORT_ID(HID_RID_RELMOUSE)),
+    TUD_HID_REPORT_DESC_DIGITIZER(HID_REPORT_ID(HID_RID_DIGITIZER)),
+    TUD_HID_REPORT_DESC_COMPOSITE(HID_REPORT_ID(HID_RID_COMPOSITE))
 };
 
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
@@ -39,14 +47,29 @@ enum HID_BT_e {
     HID_BT_KEYBOARD = 1,
     HID_BT_CONSUMER,
     HID_BT_MOUSE,
-    HID_BT_GAMEPAD
+    HID_BT_GAMEPAD,
+    HID_BT_RELMOUSE,
+    HID_BT_DIGITIZER
 };
 
 uint8_t desc_bt_report[] = {
     TUD_HID_REPORT_DESC_KEYBOARD(HID_REPORT_ID(HID_BT_KEYBOARD)),
-    TUD_HID_REPORT_DESC_ABSMOUSE5(HID_REPORT_ID(HID_BT_MOUSE))//,
-    //TUD_HID_REPORT_DESC_GAMEPAD16(HID_REPORT_ID(2))
+    TUD_HID_REPORT_DESC_ABSMOUSE5(HID_REPORT_ID(HID_BT_MOUSE)),
+    //TUD_HID_REPORT_DESC_GAMEPAD16(HID_REPORT_ID(2)),
+    TUD_HID_REPORT_DESC_RELMOUSE5(HID_REPORT_ID(HID_BT_RELMOUSE)),
+    TUD_HID_REPORT_DESC_DIGITIZER(HID_REPORT_ID(HID_BT_DIGITIZER))
 };
+
+// reports are staged here, and sent from flush() as the link allows;
+// devices are updated from both cores, hence the lock
+BTQueue_ btQueue;
+critical_section_t btLock;
+
+static void btSend(uint8_t id, const void *data, uint8_t len, bool edge, bool additive = false) {
+    critical_section_enter_blocking(&btLock);
+    btQueue.queue(id, data, len, edge, additive);
+    critical_section_exit(&btLock);
+}
 #endif // ARDUINO_RASPBERRY_PI_PICO_W
 
 TinyUSBDevices_::TinyUSBDevices_(void) {
@@ -59,18 +82,83 @@ void TinyUSBDevices_::begin(byte polRate) {
     onBattery = false;
 }
 
+bool TinyUSBDevices_::ready() {
+    // bluetooth queues reports itself
+    return onBattery || usbHid.ready();
+}
+
+void TinyUSBDevices_::setComposite(bool state) {
+    if(state == composite) {
+      return;
+    }
+    // release on the side we're leaving while it's still live, so nothing's left held on the host
+    AbsMouse5.releaseAll();
+    Keyboard.releaseAll();
+    Gamepad16.releaseAll();
+    if(state) {
+      composite = true;
+      Composite.reset();
+    } else {
+      // idle report goes out first, from the released state above
+      while(!usbHid.ready()) yield();
+      flush();
+      composite = false;
+    }
+}
+
+void TinyUSBDevices_::flush() {
+    #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
+    if(onBattery) {
+      uint8_t id, len;
+      uint8_t data[BTQUEUE_REPORT_MAX];
+      critical_section_enter_blocking(&btLock);
+      bool due = btQueue.next(micros(), id, data, len);
+      critical_section_exit(&btLock);
+      if(due) {
+        PicoBluetoothHID.send(id, data, len);
+      }
+      return;
+    }
+    #endif // ARDUINO_RASPBERRY_PI_PICO_W
+    // composite is USB only; bluetooth keeps getting the separate reports
+    if(!composite || onBattery || !usbHid.ready()) {
+      return;
+    }
+    compositeReport_s report;
+    AbsMouse5.packComposite(report);
+    Keyboard.packComposite(report);
+    Gamepad16.packComposite(report);
+    if(Composite.changed(report)) {
+      if ( USBDevice.suspended() )  {
+        USBDevice.remoteWakeup();
+      }
+      usbHid.sendReport(HID_RID_COMPOSITE, &report, sizeof(report));
+      Composite.sent(report);
+    }
+}
+
 #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
 void TinyUSBDevices_::beginBT(const char *localName, const char *hidName) {
     // third arg is the type of device that this is exposed as, i.e. the icon displayed on the PC.
     // for BLE: 0x03C2 is mouse, 0x03C1 is keyboard, 0x03C4 is gamepad, 0x03C0 is "generic" bluetooth icon
     // for BT: 0x2580 is mouse, 0x2540 is keyboard, 0x2508 is gamepad, 0x25C0 is "combo".
     // also bluetooth classic for some reason has a "subclass"?
+    if(!critical_section_is_initialized(&btLock)) {
+      critical_section_init(&btLock);
+    }
+    btQueue.clear();
     PicoBluetoothHID.startHID(localName, hidName, 0x2580, 33, desc_bt_report, sizeof(desc_bt_report));
     onBattery = true;
 }
+
+void TinyUSBDevices_::setBTInterval(uint32_t us) {
+    // a single word, no need to lock (and this can come before beginBT sets the lock up)
+    btQueue.setInterval(us);
+}
 #endif // ARDUINO_RASPBERRY_PI_PICO_W
 
 TinyUSBDevices_ TinyUSBDevices;
+Composite_ Composite;
   
 /*****************************
  *   MOUSE SECTION
@@ -125,27 +213,61 @@ void AbsMouse5_::init(bool autoReport)
 
 void AbsMouse5_::report(void)
 {
-	uint8_t buffer[5];
+#if defined(USE_TINYUSB)
+	if(TinyUSBDevices.composite && !TinyUSBDevices.onBattery) {
+		// goes out with everything else on the next flush
+		return;
+	}
+#endif // USE_TINYUSB
+	uint8_t buffer[POINTER_REPORT_LEN];
 	buffer[0] = _buttons;
-	buffer[1] = _x & 0xFF;
-	buffer[2] = (_x >> 8) & 0xFF;
-	buffer[3] = _y & 0xFF;
-	buffer[4] = (_y >> 8) & 0xFF;
+	switch(_mode) {
+	case Pointer_Relative:
+		// deltas are only sent once, a button change right after shouldn't move it again
+		buffer[1] = _dx & 0xFF;
+		buffer[2] = (_dx >> 8) & 0xFF;
+		buffer[3] = _dy & 0xFF;
+		buffer[4] = (_dy >> 8) & 0xFF;
+		_dx = 0, _dy = 0;
+		break;
+	case Pointer_Digitizer:
+	{
+		// stretch 0-32767 over the full 16-bit range, so both ends still line up
+		uint16_t x = (_x << 1) | (_x >> 14);
+		uint16_t y = (_y << 1) | (_y >> 14);
+		buffer[0] = (_buttons & (MOUSE_LEFT | MOUSE_RIGHT | MOUSE_MIDDLE)) | DIGITIZER_IN_RANGE;
+		buffer[1] = x & 0xFF;
+		buffer[2] = (x >> 8) & 0xFF;
+		buffer[3] = y & 0xFF;
+		buffer[4] = (y >> 8) & 0xFF;
+		break;
+	}
+	default:
+		buffer[1] = _x & 0xFF;
+		buffer[2] = (_x >> 8) & 0xFF;
+		buffer[3] = _y & 0xFF;
+		buffer[4] = (_y >> 8) & 0xFF;
+		break;
+	}
 
 #if defined(_USING_HID)
-	HID().SendReport(_reportId, buffer, 5);
+	HID().SendReport(_reportId, buffer, POINTER_REPORT_LEN);
 #endif // _USING_HID
 #if defined(USE_TINYUSB)
+    static const uint8_t usbIds[Pointer_Count] = { HID_RID_MOUSE, HID_RID_RELMOUSE, HID_RID_DIGITIZER };
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
+    static const uint8_t btIds[Pointer_Count] = { HID_BT_MOUSE, HID_BT_RELMOUSE, HID_BT_DIGITIZER };
     if(TinyUSBDevices.onBattery) {
-      PicoBluetoothHID.send(HID_BT_MOUSE, buffer, 5);
+      // position-only reports get merged, button changes go out first & in order
+      btSend(btIds[_mode], buffer, POINTER_REPORT_LEN, buffer[0] != _btButtons, _mode == Pointer_Relative);
+      _btButtons = buffer[0];
     } else {
       while(!usbHid.ready()) yield();
-      usbHid.sendReport(HID_RID_MOUSE, buffer, 5);
+      usbHid.sendReport(usbIds[_mode], buffer, POINTER_REPORT_LEN);
     }
     #else
     while(!usbHid.ready()) yield();
-    usbHid.sendReport(HID_RID_MOUSE, buffer, 5);
+    usbHid.sendReport(usbIds[_mode], buffer, POINTER_REPORT_LEN);
     #endif // ARDUINO_RASPBERRY_PI_PICO_W
 #endif // USE_TINYUSB
 }
@@ -155,12 +277,62 @@ void AbsMouse5_::move(uint16_t x, uint16_t y)
 	if(x != _x || y != _y) {
 		_x = x;
 		_y = y;
+		if(_mode == Pointer_Relative) {
+			// adds onto anything a report() hasn't taken yet, e.g. with autoReport off
+			_relX.stepInto(_dx, x);
+			_relY.stepInto(_dy, y);
+			// nothing whole to send yet, the rest is carried over to the next move
+			if(!_dx && !_dy) {
+				return;
+			}
+		}
 		if(_autoReport) {
 			report();
 		}
 	}
 }
 
+void AbsMouse5_::packComposite(compositeReport_s &r)
+{
+	// always absolute here, whatever the pointer mode
+	Composite_::packMouse(r, _buttons, _x, _y);
+}
+
+void AbsMouse5_::setMode(uint8_t mode)
+{
+#if defined(USE_TINYUSB)
+	if(mode >= Pointer_Count || mode == _mode) {
+		return;
+	}
+	_buttons = 0, _dx = 0, _dy = 0;
+	if(_mode == Pointer_Digitizer) {
+		// take the pen out of range, so the host lets go of the cursor
+		uint8_t buffer[POINTER_REPORT_LEN] = {0};
+		#if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
+		if(TinyUSBDevices.onBattery) {
+		  btSend(HID_BT_DIGITIZER, buffer, POINTER_REPORT_LEN, true);
+		  _btButtons = 0;
+		} else {
+		  while(!usbHid.ready()) yield();
+		  usbHid.sendReport(HID_RID_DIGITIZER, buffer, POINTER_REPORT_LEN);
+		}
+		#else
+		while(!usbHid.ready()) yield();
+		usbHid.sendReport(HID_RID_DIGITIZER, buffer, POINTER_REPORT_LEN);
+		#endif // ARDUINO_RASPBERRY_PI_PICO_W
+	} else {
+		report();
+	}
+	_mode = mode;
+	// relative mode starts counting from wherever the next move lands
+	_relX.reset();
+	_relY.reset();
+#else
+	// only the absolute mouse descriptor is registered with the Arduino HID stack
+	(void)mode;
+#endif // USE_TINYUSB
+}
+
 void AbsMouse5_::press(uint8_t button)
 {
 	_buttons |= button;
@@ -188,9 +360,12 @@ void AbsMouse5_::release(uint8_t button)
   
   void Keyboard_::sendReport(KeyReport* keys)
   {
+    if(TinyUSBDevices.composite && !TinyUSBDevices.onBattery) {
+      return;
+    }
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
     if(TinyUSBDevices.onBattery) {
-      PicoBluetoothHID.send(HID_BT_KEYBOARD, keys, sizeof(keys));
+      btSend(HID_BT_KEYBOARD, keys, sizeof(KeyReport), true);
     } else {
       if ( USBDevice.suspended() )  {
         USBDevice.remoteWakeup();
@@ -419,6 +594,11 @@ void AbsMouse5_::release(uint8_t button)
     return 1;
   }
   
+  void Keyboard_::packComposite(compositeReport_s &r)
+  {
+    Composite_::packKeys(r, _keyReport.modifiers, _keyReport.keys);
+  }
+
   void Keyboard_::releaseAll(void)
   {
     _keyReport.keys[0] = 0;
@@ -512,6 +692,9 @@ void AbsMouse5_::release(uint8_t button)
   }
 
   void Gamepad16_::report() {
+    if(TinyUSBDevices.composite && !TinyUSBDevices.onBattery) {
+      return;
+    }
     #if defined(ARDUINO_RASPBERRY_PI_PICO_W) && defined(ENABLE_CLASSIC)
     if(TinyUSBDevices.onBattery) {
       // this doesn't work for some reason :(
@@ -532,6 +715,11 @@ void AbsMouse5_::release(uint8_t button)
     #endif // ARDUINO_RASPBERRY_PI_PICO_W
   }
 
+  void Gamepad16_::packComposite(compositeReport_s &r) {
+    Composite_::packPad(r, gamepad16Report.X, gamepad16Report.Y, gamepad16Report.Rx, gamepad16Report.Ry,
+                        gamepad16Report.hat, gamepad16Report.buttons);
+  }
+
   void Gamepad16_::releaseAll() {
     gamepad16Report.buttons = 0;
     gamepad16Report.hat = 0;
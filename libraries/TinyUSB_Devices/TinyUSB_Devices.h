@@ -42,6 +42,7 @@
  */
 
 #include <Arduino.h>
+#include "TinyUSB_Composite.h"
 
 /*****************************
  *   GLOBAL SECTION
@@ -52,9 +53,22 @@ public:
   TinyUSBDevices_(void);
   void begin(byte polRate);
   void beginBT(const char *localName, const char *hidName);
+  // Least time between Bluetooth reports, in microseconds (default BTQUEUE_INTERVAL_DEFAULT);
+  // set it to the link's interval, so the cursor never gets further ahead than the link can carry
+  void setBTInterval(uint32_t us);
+  // Whether a report can go out right now without waiting on the endpoint
+  bool ready();
+  // Switches mouse/keyboard/gamepad over to (or back from) the single composite report,
+  // releasing everything first so nothing's left held on the host
+  void setComposite(bool state);
+  // In composite mode, sends the composite report if anything's changed and the endpoint's free;
+  // over Bluetooth, sends the next staged report if the link's due for one
+  void flush();
   bool onBattery = false;
+  bool composite = false;
 };
 extern TinyUSBDevices_ TinyUSBDevices;
+extern Composite_ Composite;
 
 /*****************************
  *   MOUSE SECTION
@@ -63,6 +77,7 @@ extern TinyUSBDevices_ TinyUSBDevices;
 #define _ABSMOUSE5_H_
 
 #include <stdint.h>
+#include "TinyUSB_Pointer.h"
 
 #define MOUSE_LEFT 0x01
 #define MOUSE_RIGHT 0x02
@@ -104,6 +119,7 @@ extern TinyUSBDevices_ TinyUSBDevices;
 #endif // USE_TINYUSB
 
 // 5 button absolute mouse
+// Can also be sent out as a relative mouse or a pen digitizer (TinyUSB only), see setMode().
 class AbsMouse5_
 {
 private:
@@ -112,15 +128,36 @@ private:
 	uint16_t _x;
 	uint16_t _y;
 	bool _autoReport;
+	uint8_t _mode = 0;
+	int16_t _dx = 0;
+	int16_t _dy = 0;
+	uint8_t _btButtons = 0;
+	RelativeAxis _relX;
+	RelativeAxis _relY;
 
 public:
+	enum PointerMode_e {
+		Pointer_Absolute = 0,
+		Pointer_Relative,
+		Pointer_Digitizer,
+		Pointer_Count
+	};
+
 	AbsMouse5_(uint8_t reportId = 1);
 	void init(bool autoReport = true);
 	void report(void);
+	// x & y are always absolute (0-32767), whatever mode is being sent
 	void move(uint16_t x, uint16_t y);
 	void press(uint8_t b = MOUSE_LEFT);
 	void release(uint8_t b = MOUSE_LEFT);
 	void releaseAll() { release(0x1f); }
+	// Switches which pointer device reports go out as, releasing everything on the old one first
+	void setMode(uint8_t mode);
+	uint8_t mode() { return _mode; }
+	// Counts a relative mouse moves for a full sweep across the screen
+	void setRelativeRange(uint16_t counts) { _relX.setRange(counts), _relY.setRange(counts); }
+	// Fills in the mouse part of the composite report
+	void packComposite(compositeReport_s &r);
 };
 
 // global singleton
@@ -208,6 +245,8 @@ extern AbsMouse5_ AbsMouse5;
     size_t press(uint8_t k);
     size_t release(uint8_t k);
     void releaseAll(void);
+    // Fills in the keyboard part of the composite report
+    void packComposite(compositeReport_s &r);
   };
 extern Keyboard_ Keyboard;
 
@@ -311,6 +350,8 @@ public:
   void report(void);
   void releaseAll(void);
   void setAutoreport(bool state) { _autoReport = state; }
+  // Fills in the gamepad part of the composite report
+  void packComposite(compositeReport_s &r);
   bool stickRight;
 };
 extern Gamepad16_ Gamepad16;
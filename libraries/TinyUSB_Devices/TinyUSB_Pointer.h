@@ -0,0 +1,146 @@
+/*
+ * Extra pointer devices for the AbsMouse5 interface: a relative mouse and a
+ * 16-bit absolute pen digitizer. All of them sit in the same HID report
+ * descriptor as the absolute mouse, so which one gets used can be switched
+ * at runtime without the host having to re-enumerate the device.
+ *
+ * This header has no Arduino or TinyUSB dependencies, so the descriptors and
+ * the relative accumulator can be built & checked on a host compiler.
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ */
+
+#ifndef _TINYUSB_POINTER_H_
+#define _TINYUSB_POINTER_H_
+
+#include <stdint.h>
+
+// Size of every pointer report after the report ID: 1 byte of buttons, then 16-bit X & Y.
+#define POINTER_REPORT_LEN 5
+
+// 5 button relative mouse, 16-bit X/Y deltas
+#define TUD_HID_REPORT_DESC_RELMOUSE5(...) \
+	0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x02,        /* Usage (Mouse) */ \
+	0xA1, 0x01,        /* Collection (Application) */ \
+	__VA_ARGS__ \
+	0x09, 0x01,        /*   Usage (Pointer) */ \
+	0xA1, 0x00,        /*   Collection (Physical) */ \
+	0x05, 0x09,        /*     Usage Page (Button) */ \
+	0x19, 0x01,        /*     Usage Minimum (0x01) */ \
+	0x29, 0x05,        /*     Usage Maximum (0x05) */ \
+	0x15, 0x00,        /*     Logical Minimum (0) */ \
+	0x25, 0x01,        /*     Logical Maximum (1) */ \
+	0x95, 0x05,        /*     Report Count (5) */ \
+	0x75, 0x01,        /*     Report Size (1) */ \
+	0x81, 0x02,        /*     Input (Data,Var,Abs) */ \
+	0x95, 0x01,        /*     Report Count (1) */ \
+	0x75, 0x03,        /*     Report Size (3) */ \
+	0x81, 0x03,        /*     Input (Const,Var,Abs) */ \
+	0x05, 0x01,        /*     Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x30,        /*     Usage (X) */ \
+	0x09, 0x31,        /*     Usage (Y) */ \
+	0x16, 0x01, 0x80,  /*     Logical Minimum (-32767) */ \
+	0x26, 0xFF, 0x7F,  /*     Logical Maximum (32767) */ \
+	0x75, 0x10,        /*     Report Size (16) */ \
+	0x95, 0x02,        /*     Report Count (2) */ \
+	0x81, 0x06,        /*     Input (Data,Var,Rel) */ \
+	0xC0,              /*   End Collection */ \
+	0xC0               /* End Collection */
+
+// Pen digitizer, 16-bit absolute X/Y
+// Physical size is nominal (10" square) - the host maps the pen to the display anyways.
+#define TUD_HID_REPORT_DESC_DIGITIZER(...) \
+	0x05, 0x0D,        /* Usage Page (Digitizer) */ \
+	0x09, 0x02,        /* Usage (Pen) */ \
+	0xA1, 0x01,        /* Collection (Application) */ \
+	__VA_ARGS__ \
+	0x09, 0x20,        /*   Usage (Stylus) */ \
+	0xA1, 0x00,        /*   Collection (Physical) */ \
+	0x09, 0x42,        /*     Usage (Tip Switch) */ \
+	0x09, 0x44,        /*     Usage (Barrel Switch) */ \
+	0x09, 0x5A,        /*     Usage (Secondary Barrel Switch) */ \
+	0x09, 0x32,        /*     Usage (In Range) */ \
+	0x15, 0x00,        /*     Logical Minimum (0) */ \
+	0x25, 0x01,        /*     Logical Maximum (1) */ \
+	0x75, 0x01,        /*     Report Size (1) */ \
+	0x95, 0x04,        /*     Report Count (4) */ \
+	0x81, 0x02,        /*     Input (Data,Var,Abs) */ \
+	0x95, 0x04,        /*     Report Count (4) */ \
+	0x81, 0x03,        /*     Input (Const,Var,Abs) */ \
+	0x05, 0x01,        /*     Usage Page (Generic Desktop Ctrls) */ \
+	0x09, 0x30,        /*     Usage (X) */ \
+	0x09, 0x31,        /*     Usage (Y) */ \
+	0x15, 0x00,        /*     Logical Minimum (0) */ \
+	0x27, 0xFF, 0xFF, 0x00, 0x00, /* Logical Maximum (65535) */ \
+	0x35, 0x00,        /*     Physical Minimum (0) */ \
+	0x46, 0xE8, 0x03,  /*     Physical Maximum (1000) */ \
+	0x55, 0x0E,        /*     Unit Exponent (-2) */ \
+	0x65, 0x13,        /*     Unit (Inch) */ \
+	0x75, 0x10,        /*     Report Size (16) */ \
+	0x95, 0x02,        /*     Report Count (2) */ \
+	0x81, 0x02,        /*     Input (Data,Var,Abs) */ \
+	0xC0,              /*   End Collection */ \
+	0xC0               /* End Collection */
+
+// Digitizer button bits; left/right/middle mouse map onto tip/barrel/secondary barrel as-is.
+#define DIGITIZER_IN_RANGE 0x08
+
+/// @brief Turns a stream of absolute positions into relative mouse counts.
+/// @details Anything that doesn't make a whole count is carried over to the next step,
+/// so slow movements still come out over time and nothing drifts.
+class RelativeAxis {
+public:
+  /// @brief Sets how many counts a full sweep of the absolute range (0-32767) moves
+  void setRange(uint16_t counts) { _num = counts; reset(); }
+
+  /// @brief Forgets the last position, e.g. when switching modes, so the next step doesn't jump
+  void reset() { _primed = false; _residue = 0; }
+
+  /// @brief Feeds in a new absolute position (0-32767)
+  /// @return Whole counts to move since the last step
+  int16_t step(uint16_t pos) {
+    if(!_primed) {
+      _last = pos;
+      _primed = true;
+      return 0;
+    }
+    int64_t scaled = (int64_t)((int32_t)pos - (int32_t)_last) * _num + _residue;
+    _last = pos;
+    int64_t out = scaled / _den;
+    // anything past what one report can carry stays in the residue, and goes out next time
+    if(out > 32767) {
+      out = 32767;
+    } else if(out < -32767) {
+      out = -32767;
+    }
+    _residue = scaled - out * _den;
+    return (int16_t)out;
+  }
+
+  /// @brief Like step(), but adds onto counts that haven't been sent yet
+  /// @details Whatever won't fit in one report goes back in the residue, and comes out on a later step.
+  void stepInto(int16_t &pending, uint16_t pos) {
+    int32_t total = (int32_t)pending + step(pos);
+    int32_t held = total > 32767 ? total - 32767 : (total < -32767 ? total + 32767 : 0);
+    _residue += (int64_t)held * _den;
+    pending = (int16_t)(total - held);
+  }
+
+private:
+  static const int32_t _den = 32767;
+  int32_t _num = 1920;
+  int64_t _residue = 0;
+  uint16_t _last = 0;
+  bool _primed = false;
+};
+
+#endif // _TINYUSB_POINTER_H_
@@ -0,0 +1,107 @@
+ /*!
+ * @file FlashSim.h
+ * @brief NOR flash model for the preferences log tests: erase counting & power cuts.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  FlashSim is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FLASHSIM_H_
+#define _FLASHSIM_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "OpenFIREPrefsLog.h"
+
+/// @brief Behaves like the RP2040's flash as far as the log can tell
+/// @details Erasing sets a sector to 0xFF; programming ANDs a page in, so bits only ever go from 1 to 0.
+/// Misaligned calls are counted as faults. A power cut can be set up after so many bytes of work
+/// (each byte programmed or erased counts as one): the byte it lands on is left with only some of its bits
+/// programmed, an erase is left partway, and nothing after it happens until Restore().
+class FlashSim : public PrefsFlash {
+public:
+    FlashSim() { memset(mem, 0xFF, sizeof(mem)); }
+
+    const uint8_t *Data() override { return mem; }
+
+    bool Erase(uint32_t offset) override {
+        if(offset % PREFS_SECTOR_SIZE || offset >= sizeof(mem)) {
+            faults++;
+            return false;
+        }
+        if(dead) {
+            return false;
+        }
+        erases[offset / PREFS_SECTOR_SIZE]++;
+        for(uint32_t i = 0; i < PREFS_SECTOR_SIZE; i++) {
+            if(!Work()) {
+                return false;
+            }
+            mem[offset + i] = 0xFF;
+        }
+        return true;
+    }
+
+    bool Program(uint32_t offset, const uint8_t *page) override {
+        if(offset % PREFS_PAGE_SIZE || offset >= sizeof(mem)) {
+            faults++;
+            return false;
+        }
+        if(dead) {
+            return false;
+        }
+        programs++;
+        for(uint32_t i = 0; i < PREFS_PAGE_SIZE; i++) {
+            if(!Work()) {
+                // the cell being programmed when the power went only got some of its bits
+                mem[offset + i] &= page[i] | 0xA5;
+                return false;
+            }
+            mem[offset + i] &= page[i];
+        }
+        return true;
+    }
+
+    /// @brief Cuts the power after this many bytes of work; -1 never does
+    void CutAfter(int32_t bytes) { budget = bytes; dead = false; }
+
+    /// @brief Power's back
+    void Restore() { budget = -1; dead = false; }
+
+    uint8_t mem[PREFS_SECTOR_SIZE * PREFS_LOG_SECTORS];
+    uint32_t erases[PREFS_LOG_SECTORS] = {};
+    uint32_t programs = 0;
+    uint32_t faults = 0;
+    uint32_t work = 0;              // bytes erased or programmed, power cut or not
+    bool dead = false;
+
+private:
+    bool Work() {
+        work++;
+        if(budget < 0) {
+            return true;
+        }
+        if(budget == 0) {
+            dead = true;
+            return false;
+        }
+        budget--;
+        return true;
+    }
+
+    int32_t budget = -1;
+};
+
+#endif // _FLASHSIM_H_
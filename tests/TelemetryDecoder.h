@@ -0,0 +1,105 @@
+ /*!
+ * @file TelemetryDecoder.h
+ * @brief Reference decoder for the binary telemetry stream, as the OpenFIRE App is expected to read it.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  TelemetryDecoder is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TELEMETRYDECODER_H_
+#define _TELEMETRYDECODER_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "OpenFIRETelemetry.h"
+
+/// @brief Byte-at-a-time decoder that follows the steps in TelemetryRecord_t's description
+/// @details Scans for the sync pair, checks version & length, verifies the checksum,
+/// and counts records that went missing by their seq. A bad record only costs its first byte:
+/// scanning picks back up right after the sync it was found at, so a record that starts
+/// inside a corrupted one is never lost.
+class TelemetryDecoder {
+public:
+    /// @brief Feeds one byte from the port
+    /// @return true when a whole, valid record has just been decoded into record
+    bool Feed(uint8_t byte)
+    {
+        buf[fill++] = byte;
+        while(fill) {
+            // 1. sync
+            if(buf[0] != TELEMETRY_SYNC0 || (fill > 1 && buf[1] != TELEMETRY_SYNC1)) {
+                Skip(1);
+                continue;
+            }
+            // 2. version & length, once they're in
+            if(fill > 3 && (buf[2] != TELEMETRY_VERSION || buf[3] != sizeof(TelemetryRecord_t))) {
+                mismatched++;
+                Skip(1);
+                continue;
+            }
+            if(fill < sizeof(TelemetryRecord_t)) {
+                return false;
+            }
+            // 3. checksum
+            uint8_t sum = 0;
+            for(unsigned int i = 0; i < sizeof(TelemetryRecord_t) - 1; i++) {
+                sum += buf[i];
+            }
+            if(sum != buf[sizeof(TelemetryRecord_t) - 1]) {
+                corrupt++;
+                Skip(1);
+                continue;
+            }
+            memcpy(&record, buf, sizeof(TelemetryRecord_t));
+            fill = 0;
+            // 4. gaps in seq
+            if(decoded && record.seq != lastSeq + 1) {
+                missing += record.seq - lastSeq - 1;
+            }
+            lastSeq = record.seq;
+            decoded++;
+            return true;
+        }
+        return false;
+    }
+
+    // The last record decoded
+    TelemetryRecord_t record;
+
+    // Records decoded
+    uint32_t decoded = 0;
+    // Records missing by seq, whether dropped by the firmware or lost on the way
+    uint32_t missing = 0;
+    // Candidate records thrown out for a bad checksum
+    uint32_t corrupt = 0;
+    // Candidate records thrown out for an unexpected version or length
+    uint32_t mismatched = 0;
+    // Bytes skipped while looking for a sync
+    uint32_t skipped = 0;
+
+private:
+    void Skip(unsigned int n)
+    {
+        memmove(buf, buf + n, fill - n);
+        fill -= n;
+        skipped += n;
+    }
+
+    uint8_t buf[sizeof(TelemetryRecord_t)];
+    unsigned int fill = 0;
+    uint32_t lastSeq = 0;
+};
+
+#endif // _TELEMETRYDECODER_H_
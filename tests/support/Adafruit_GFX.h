@@ -0,0 +1,92 @@
+ /*!
+ * @file Adafruit_GFX.h
+ * @brief Pixel-exact subset of Adafruit GFX for the host tests; text is accepted but not drawn.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_ADAFRUIT_GFX_H_
+#define _HOST_ADAFRUIT_GFX_H_
+
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        for(int16_t j = y; j < y + h; j++) {
+            for(int16_t i = x; i < x + w; i++) {
+                drawPixel(i, j, color);
+            }
+        }
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillRect(x, y, 1, h, color); }
+
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+    {
+        for(int16_t y = -r; y <= r; y++) {
+            for(int16_t x = -r; x <= r; x++) {
+                if(x * x + y * y <= r * r + r) {
+                    drawPixel(x0 + x, y0 + y, color);
+                }
+            }
+        }
+    }
+
+    /// @brief Same walk as Adafruit_GFX::drawBitmap(): row-major, MSB first, set bits only
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+        int16_t byteWidth = (w + 7) / 8;
+        uint8_t b = 0;
+        for(int16_t j = 0; j < h; j++, y++) {
+            for(int16_t i = 0; i < w; i++) {
+                if(i & 7) {
+                    b <<= 1;
+                } else {
+                    b = bitmap[j * byteWidth + i / 8];
+                }
+                if(b & 0x80) {
+                    writePixel(x + i, y, color);
+                }
+            }
+        }
+    }
+
+    void setCursor(int16_t x, int16_t y) { cursorX = x, cursorY = y; }
+    void setTextSize(uint8_t) {}
+    void setTextColor(uint16_t) {}
+    void setTextColor(uint16_t, uint16_t) {}
+    template<typename T> size_t print(const T &) { return 0; }
+    template<typename T> size_t println(const T &) { return 0; }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+protected:
+    int16_t _width, _height;
+    int16_t cursorX = 0, cursorY = 0;
+};
+
+#endif // _HOST_ADAFRUIT_GFX_H_
@@ -0,0 +1,87 @@
+ /*!
+ * @file Adafruit_SSD1306.h
+ * @brief SSD1306 driver stand-in for the host tests, with the same framebuffer layout & full-frame display().
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_ADAFRUIT_SSD1306_H_
+#define _HOST_ADAFRUIT_SSD1306_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Adafruit_GFX.h"
+
+#define BLACK 0
+#define WHITE 1
+#define INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t) : Adafruit_GFX(w, h), wire(twi)
+    {
+        buffer = new uint8_t[w * ((h + 7) / 8)]();
+    }
+    ~Adafruit_SSD1306() { delete[] buffer; }
+
+    bool begin(uint8_t, uint8_t addr) { address = addr; return true; }
+
+    void clearDisplay() { memset(buffer, 0, _width * ((_height + 7) / 8)); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override
+    {
+        if(x < 0 || x >= _width || y < 0 || y >= _height) {
+            return;
+        }
+        uint8_t &b = buffer[x + (y / 8) * _width];
+        switch(color) {
+          case WHITE:   b |= 1 << (y & 7); break;
+          case BLACK:   b &= ~(1 << (y & 7)); break;
+          case INVERSE: b ^= 1 << (y & 7); break;
+        }
+    }
+
+    /// @brief Whole framebuffer out, the way the real library does it (window, then 32 byte data runs)
+    void display()
+    {
+        wire->setClock(400000);
+        const uint8_t window[] = { 0x00, SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(_width - 1) };
+        wire->beginTransmission(address);
+        wire->write(window, sizeof(window));
+        wire->endTransmission();
+        size_t count = _width * ((_height + 7) / 8);
+        for(size_t i = 0; i < count; i += 31) {
+            wire->beginTransmission(address);
+            wire->write((uint8_t)0x40);
+            wire->write(buffer + i, count - i < 31 ? count - i : 31);
+            wire->endTransmission();
+        }
+        wire->setClock(100000);
+    }
+
+    uint8_t *getBuffer() { return buffer; }
+
+private:
+    TwoWire *wire;
+    uint8_t address = 0x3C;
+    uint8_t *buffer;
+};
+
+#endif // _HOST_ADAFRUIT_SSD1306_H_
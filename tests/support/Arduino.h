@@ -0,0 +1,74 @@
+ /*!
+ * @file Arduino.h
+ * @brief Just enough of the Arduino core for the host tests, with a clock the tests move by hand.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+// analog pins, GPIO26-29 as on every RP2040 board
+#define A0 26
+#define A1 27
+#define A2 28
+#define A3 29
+
+// Simulated time, in microseconds; tests set or advance this directly.
+inline uint32_t &HostMicros() { static uint32_t now = 0; return now; }
+inline unsigned long micros() { return HostMicros(); }
+inline unsigned long millis() { return HostMicros() / 1000; }
+inline void delay(unsigned long ms) { HostMicros() += ms * 1000; }
+
+template<typename T, typename L, typename H>
+inline T constrain(T x, L lo, H hi) { return x < (T)lo ? (T)lo : (x > (T)hi ? (T)hi : x); }
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+/// @brief CDC stand-in: everything written lands in a byte vector, with a settable free space
+class HostSerial {
+public:
+    int availableForWrite() { return room; }
+    size_t write(const uint8_t *data, size_t len)
+    {
+        out.insert(out.end(), data, data + len);
+        return len;
+    }
+    size_t write(uint8_t c) { return write(&c, 1); }
+
+    // Space left in the TX buffer, as reported to the firmware
+    int room = 4096;
+    std::vector<uint8_t> out;
+};
+
+inline HostSerial Serial;
+
+#endif // _HOST_ARDUINO_H_
@@ -0,0 +1,53 @@
+ /*!
+ * @file HostTest.h
+ * @brief Bare-bones checks for the host tests; each test is its own executable, run by ctest.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  HostTest is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOSTTEST_H_
+#define _HOSTTEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Failed checks so far; main() should return HOSTTEST_RESULT().
+inline int &HostTestFailures() { static int failures = 0; return failures; }
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        HostTestFailures()++; \
+    } } while(0)
+
+#define CHECK_EQ(a, b) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if(_a != _b) { \
+        printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+        HostTestFailures()++; \
+    } } while(0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+    double _a = (double)(a), _b = (double)(b); \
+    if(!(fabs(_a - _b) <= (double)(tol))) { \
+        printf("%s:%d: CHECK_NEAR(%s, %s, %s) failed: %g vs %g\n", __FILE__, __LINE__, #a, #b, #tol, _a, _b); \
+        HostTestFailures()++; \
+    } } while(0)
+
+#define HOSTTEST_RESULT() (HostTestFailures() ? (printf("%d check(s) failed\n", HostTestFailures()), 1) : 0)
+
+#endif // _HOSTTEST_H_
@@ -0,0 +1,68 @@
+ /*!
+ * @file SSD1306Panel.h
+ * @brief Replays logged I2C traffic into a model of the SSD1306's GDDRAM, for checking what a panel would show.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_SSD1306PANEL_H_
+#define _HOST_SSD1306PANEL_H_
+
+#include <Wire.h>
+
+/// @brief 128x64 panel in horizontal addressing mode; only the window commands are modelled
+class SSD1306Panel {
+public:
+    void Replay(const std::vector<TwoWire::Transaction_s> &log, uint8_t address)
+    {
+        for(const TwoWire::Transaction_s &t : log) {
+            if(t.address != address || t.bytes.empty()) {
+                continue;
+            }
+            if(t.bytes[0] == 0x00) {
+                for(size_t i = 1; i < t.bytes.size(); i++) {
+                    if(t.bytes[i] == 0x22 && i + 2 < t.bytes.size()) {
+                        pageStart = t.bytes[i + 1] & 7, pageEnd = t.bytes[i + 2] & 7;
+                        page = pageStart, col = colStart;
+                        i += 2;
+                    } else if(t.bytes[i] == 0x21 && i + 2 < t.bytes.size()) {
+                        colStart = t.bytes[i + 1] & 127, colEnd = t.bytes[i + 2] & 127;
+                        page = pageStart, col = colStart;
+                        i += 2;
+                    }
+                }
+            } else if(t.bytes[0] == 0x40) {
+                for(size_t i = 1; i < t.bytes.size(); i++) {
+                    ram[page][col] = t.bytes[i];
+                    if(++col > colEnd) {
+                        col = colStart;
+                        if(++page > pageEnd) {
+                            page = pageStart;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    uint8_t ram[8][128] = {};
+
+private:
+    uint8_t pageStart = 0, pageEnd = 7, colStart = 0, colEnd = 127;
+    uint8_t page = 0, col = 0;
+};
+
+#endif // _HOST_SSD1306PANEL_H_
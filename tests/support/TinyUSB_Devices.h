@@ -0,0 +1,31 @@
+ /*!
+ * @file TinyUSB_Devices.h
+ * @brief What the sketch's own classes read from TinyUSB_Devices, for the host tests.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_TINYUSB_DEVICES_H_
+#define _HOST_TINYUSB_DEVICES_H_
+
+class TinyUSBDevices_ {
+public:
+    bool onBattery = false;
+};
+
+inline TinyUSBDevices_ TinyUSBDevices;
+
+#endif // _HOST_TINYUSB_DEVICES_H_
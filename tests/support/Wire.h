@@ -0,0 +1,126 @@
+ /*!
+ * @file Wire.h
+ * @brief I2C stand-in for the host tests: keeps every transaction, and charges its bus time to the host clock.
+ *
+ * @copyright That One Seong, 2024
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HOST_WIRE_H_
+#define _HOST_WIRE_H_
+
+#include <Arduino.h>
+#include <vector>
+
+class TwoWire {
+public:
+    struct Transaction_s {
+        uint8_t address;
+        uint32_t clock;
+        uint32_t start;                 ///< HostMicros() when it went out
+        uint32_t duration;              ///< bus time, in microseconds
+        std::vector<uint8_t> bytes;     ///< everything after the address byte
+        bool acked;                     ///< false if the device NACKed its address, & the bytes never went out
+    };
+
+    void setSDA(int) {}
+    void setSCL(int) {}
+    void begin() {}
+    void setClock(uint32_t hz) { clock = hz; }
+
+    void beginTransmission(uint8_t address)
+    {
+        pending.address = address;
+        pending.bytes.clear();
+    }
+    size_t write(uint8_t c) { pending.bytes.push_back(c); return 1; }
+    size_t write(const uint8_t *data, size_t len)
+    {
+        pending.bytes.insert(pending.bytes.end(), data, data + len);
+        return len;
+    }
+
+    /// @brief Sends the transaction: the host clock moves on by the time it holds the bus
+    /// @details Start, address & every byte are 9 clocks (8 bits + ack), then a stop; no clock stretching.
+    /// While the device is busy from its last register write it NACKs its address (2) & the bytes never go out.
+    uint8_t endTransmission(bool = true)
+    {
+        pending.acked = HostMicros() >= busyUntil;
+        pending.clock = clock;
+        pending.start = HostMicros();
+        pending.duration = BusTime(pending.acked ? pending.bytes.size() : 0);
+        HostMicros() += pending.duration;
+        log.push_back(pending);
+        if(!pending.acked) {
+            nacks++;
+            return 2;
+        }
+        if(pending.bytes.size() > 1) {
+            busyUntil = HostMicros() + busyAfterWrite;
+        }
+        return 0;
+    }
+
+    /// @brief Reads up to `quantity` bytes of `reply` into the receive buffer, charging the bus time
+    size_t requestFrom(int, size_t quantity, bool = true)
+    {
+        size_t n = HostMicros() < busyUntil ? 0 : min(quantity, reply.size());
+        rx.assign(reply.begin(), reply.begin() + n);
+        rxPos = 0;
+        HostMicros() += BusTime(n);
+        return n;
+    }
+    int available() { return (int)(rx.size() - rxPos); }
+    int read() { return rxPos < rx.size() ? rx[rxPos++] : -1; }
+
+    /// @brief Data bytes (everything after the address) sent to an address since the log was last cleared
+    size_t BytesTo(uint8_t address) const
+    {
+        size_t total = 0;
+        for(const Transaction_s &t : log) {
+            if(t.address == address && t.acked) {
+                total += t.bytes.size();
+            }
+        }
+        return total;
+    }
+
+    uint32_t clock = 100000;
+    // CPU time per transaction on top of the bus time, in microseconds
+    uint32_t overhead = 0;
+    std::vector<Transaction_s> log;
+    // how long the device NACKs after a register write, in microseconds, and when it'll next ACK
+    uint32_t busyAfterWrite = 0;
+    uint32_t busyUntil = 0;
+    uint32_t nacks = 0;
+    // what the device answers every read with
+    std::vector<uint8_t> reply;
+
+private:
+    uint32_t BusTime(size_t bytes) const
+    {
+        uint32_t bits = 1 + (bytes + 1) * 9 + 1;
+        return (uint32_t)(((uint64_t)bits * 1000000 + clock - 1) / clock) + overhead;
+    }
+
+    Transaction_s pending;
+    std::vector<uint8_t> rx;
+    size_t rxPos = 0;
+};
+
+inline TwoWire Wire;
+inline TwoWire Wire1;
+
+#endif // _HOST_WIRE_H_
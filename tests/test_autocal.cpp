@@ -0,0 +1,187 @@
+// Replays AutoCalStep()'s feed at the camera rate through long sessions where the LED square's proportions
+// drift after calibration (a sagging bar, a bumped mount), with tracking noise, off-center aim & glitched frames,
+// and checks the anchors converge on what calibration would now give, in bounded steps, and stay put otherwise.
+#include <stdint.h>
+#include <math.h>
+#include <random>
+#include "HostTest.h"
+#include "OpenFIREAutoCal.h"
+
+static const int width = 1920 << 2;
+static const int height = 1080 << 2;
+static const long frameRate = 209;
+
+// Where calibration puts the left anchor for a given width/height ratio
+static float AnchorFor(float ratio)
+{
+    return width / 2 - ratio * height / 2;
+}
+
+typedef struct Session_s {
+    float tl, tr;               // anchors as the profile has them at the end
+    uint32_t moves;
+    float maxStep;
+    float maxAsymmetry;         // how far TR strayed from mirroring TL, against how calibration left them
+} Session_t;
+
+// Runs `seconds` of frames; truth(frame) gives the real ratio, usable(frame) whether AutoCalStep() would count it
+static Session_t Run(AutoCal &autocal, float tl, float tr, long seconds, float noise,
+                     float (*truth)(long), bool (*usable)(long), uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> jitter(0.0f, noise);
+    Session_t s = {tl, tr, 0, 0.0f, 0.0f};
+    const float skew = tl + tr;
+    for(long f = 0; f < seconds * frameRate; f++) {
+        // the square's tracked height wobbles with distance; only the ratio matters
+        float h = 700.0f + 50.0f * sinf(f * 0.001f);
+        float w = (truth(f) + jitter(rng)) * h;
+        // now and then a reflection's picked up as an LED, and the square comes out far too wide
+        if(f % 97 == 0) {
+            w = h * 4.0f;
+        }
+        float newTL, newTR;
+        if(autocal.Feed(s.tl, s.tr, w, h, usable(f), newTL, newTR)) {
+            s.maxStep = fmaxf(s.maxStep, fabsf(newTL - s.tl));
+            s.tl = newTL;
+            s.tr = newTR;
+            s.maxAsymmetry = fmaxf(s.maxAsymmetry, fabsf(s.tl + s.tr - skew));
+            s.moves++;
+        }
+    }
+    return s;
+}
+
+// the bar sags over the first two minutes, from 1.60 to 1.64
+static float Sag(long f) { return 1.60f + 0.04f * fminf(1.0f, f / (frameRate * 120.0f)); }
+static float Sagged(long) { return 1.64f; }
+static float Steady(long) { return 1.70f; }
+static float Bumped(long) { return 2.00f; }
+// aimed off-center a third of the time
+static bool MostFrames(long f) { return f % 3 != 0; }
+static bool AllFrames(long) { return true; }
+
+static void TestConvergence()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.60f);
+    float target = AnchorFor(1.64f);
+    // five minutes: the sag, and the windows catching up with it
+    Session_t s = Run(autocal, tl, width - tl, 300, 0.02f, Sag, MostFrames, 3);
+    printf("sag: TL %.1f -> %.1f after 5 minutes, target %.1f; %u moves, biggest %.1f; ratio %.4f\n",
+           tl, s.tl, target, s.moves, s.maxStep, autocal.ratio);
+    // the long-run ratio settles on the truth, and the anchors within a step of where it puts them
+    CHECK_NEAR(autocal.ratio, 1.64f, 0.002f);
+    CHECK_NEAR(s.tl, target, AUTOCAL_DEADBAND + AUTOCAL_STEP);
+    // a step a window at most, so it takes a while: never a jump a player would notice
+    CHECK(s.maxStep <= AUTOCAL_STEP);
+    CHECK(s.moves >= (uint32_t)((tl - target - AUTOCAL_DEADBAND) / AUTOCAL_STEP));
+    // TR mirrors TL, so calibration's asymmetry is kept
+    CHECK_NEAR(s.maxAsymmetry, 0.0f, 0.01f);
+    CHECK(autocal.Drifted());
+    autocal.Persisted();
+    CHECK(!autocal.Drifted());
+
+    // another five minutes at the new ratio: it finishes inside the deadband, and then stays put
+    Session_t more = Run(autocal, s.tl, s.tr, 300, 0.02f, Sagged, MostFrames, 13);
+    printf("      TL %.1f after 10 minutes, %u more moves\n", more.tl, more.moves);
+    CHECK_NEAR(more.tl, target, AUTOCAL_DEADBAND);
+    CHECK(more.moves <= 2);
+    CHECK(more.maxStep <= AUTOCAL_STEP);
+}
+
+// An asymmetric calibration (camera a bit off the screen's middle) keeps its offset between the anchors
+static void TestAsymmetric()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.60f) + 40.0f;
+    float tr = width - AnchorFor(1.60f) + 40.0f;
+    Session_t s = Run(autocal, tl, tr, 600, 0.02f, Sag, MostFrames, 4);
+    CHECK_NEAR(s.tl + s.tr, tl + tr, 0.01f);
+    CHECK_NEAR(s.tl, AnchorFor(1.64f), AUTOCAL_DEADBAND);
+}
+
+// With nothing really changing, even noisy tracking doesn't walk the anchors anywhere
+static void TestNoiseOnly()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.70f);
+    Session_t s = Run(autocal, tl, width - tl, 1800, 0.06f, Steady, AllFrames, 5);
+    printf("noise: %u moves over half an hour, ratio %.4f\n", s.moves, autocal.ratio);
+    CHECK_EQ(s.moves, 0);
+    CHECK_EQ(s.tl, tl);
+    CHECK(!autocal.Drifted());
+}
+
+// A bumped mount is past what it should follow: it stops at the limit and leaves the rest to a recalibration
+static void TestLimit()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.60f);
+    Session_t s = Run(autocal, tl, width - tl, 1200, 0.02f, Bumped, AllFrames, 6);
+    printf("bump: moved %.1f of the %.1f it'd take, limit %.0f\n", s.tl - tl, AnchorFor(2.0f) - tl, AUTOCAL_LIMIT);
+    CHECK_NEAR(s.tl, tl - AUTOCAL_LIMIT, 0.01f);
+    CHECK(s.maxStep <= AUTOCAL_STEP);
+}
+
+static void TestUnusableFrames()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.60f), tr = width - tl, newTL, newTR;
+    // off-center frames, a lost LED (zero height) & tracking glitches never count toward a window
+    for(long f = 0; f < AUTOCAL_WINDOW * 4; f++) {
+        CHECK(!autocal.Feed(tl, tr, 1.9f * 700.0f, 700.0f, false, newTL, newTR));
+        CHECK(!autocal.Feed(tl, tr, 1.9f * 700.0f, 0.0f, true, newTL, newTR));
+        CHECK(!autocal.Feed(tl, tr, AUTOCAL_RATIO_MAX * 1.1f * 700.0f, 700.0f, true, newTL, newTR));
+        CHECK(!autocal.Feed(tl, tr, AUTOCAL_RATIO_MIN * 0.9f * 700.0f, 700.0f, true, newTL, newTR));
+        if(HostTestFailures()) {
+            break;
+        }
+    }
+    CHECK_EQ(autocal.ratio, 0.0f);
+
+    // the first window only goes when it's full
+    for(long f = 0; f < AUTOCAL_WINDOW - 1; f++) {
+        CHECK(!autocal.Feed(tl, tr, 1.9f * 700.0f, 700.0f, true, newTL, newTR));
+    }
+    CHECK_EQ(autocal.ratio, 0.0f);
+    CHECK(autocal.Feed(tl, tr, 1.9f * 700.0f, 700.0f, true, newTL, newTR));
+    CHECK_NEAR(autocal.ratio, 1.9f, 0.0001f);
+    CHECK_NEAR(newTL, tl - AUTOCAL_STEP, 0.001f);
+    CHECK_NEAR(newTR, tr + AUTOCAL_STEP, 0.001f);
+}
+
+// Recalibrating or switching profiles mid-session starts it over from the new anchors
+static void TestRebase()
+{
+    AutoCal autocal(width, height);
+    float tl = AnchorFor(1.60f), tr = width - tl, newTL, newTR;
+    for(long f = 0; f < frameRate * 60; f++) {
+        if(autocal.Feed(tl, tr, 1.65f * 700.0f, 700.0f, true, newTL, newTR)) {
+            tl = newTL, tr = newTR;
+        }
+    }
+    CHECK(autocal.ratio > 0.0f);
+    CHECK(autocal.Drifted());
+
+    tl = AnchorFor(1.65f);
+    tr = width - tl;
+    CHECK(!autocal.Feed(tl, tr, 1.65f * 700.0f, 700.0f, false, newTL, newTR));
+    CHECK_EQ(autocal.ratio, 0.0f);
+    CHECK(!autocal.Drifted());
+
+    // and the limit counts from there
+    Session_t s = Run(autocal, tl, tr, 1200, 0.02f, Bumped, AllFrames, 7);
+    CHECK_NEAR(s.tl, tl - AUTOCAL_LIMIT, 0.01f);
+}
+
+int main()
+{
+    TestConvergence();
+    TestAsymmetric();
+    TestNoiseOnly();
+    TestLimit();
+    TestUnusableFrames();
+    TestRebase();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,162 @@
+// Run mode averaging with a grid fit on: FrameFilter() fits each frame's perspective output, then averages.
+// Fast sweeps across a distorted screen are run through it both ways, against the exact average of the exactly
+// fitted positions; averaging after the fit stays within 1 LSB of that (one unit of res_x/res_y space),
+// averaging before it doesn't.
+#include <stdint.h>
+#include <math.h>
+#include <initializer_list>
+#include "HostTest.h"
+#include "OpenFIRE_Average.h"
+#include "OpenFIRE_Calibration.h"
+
+// Perspective output space, as the sketch has it (resolution multiplied by 4)
+static const int width = 1920 << 2;
+static const int height = 1080 << 2;
+
+// A keystoned projector with some barrel bow
+static const CalibrationFit_t fit = {16, {1.05f, 0.03f, 0.02f, -0.02f, 0.97f, -0.01f, 0.04f, -0.03f}, 0.08f};
+
+// OpenFIRE_Calibration::apply() without the rounding
+static void Exact(int x, int y, double &outX, double &outY)
+{
+    double cx = width * 0.5, cy = height * 0.5, s = width * 0.5;
+    double nx = (x - cx) / s, ny = (y - cy) / s;
+    double r = 1.0 + fit.k1 * (nx * nx + ny * ny);
+    nx *= r;
+    ny *= r;
+    double d = fit.h[6] * nx + fit.h[7] * ny + 1.0;
+    outX = (fit.h[0] * nx + fit.h[1] * ny + fit.h[2]) / d * s + cx;
+    outY = (fit.h[3] * nx + fit.h[4] * ny + fit.h[5]) / d * s + cy;
+}
+
+enum Mode_e { Mode_Pair, Mode_Weighted };
+
+static void Average(OpenFIRE_Average &avg, Mode_e mode, int &x, int &y)
+{
+    if(mode == Mode_Pair) {
+        avg.pair(x, y);
+    } else {
+        avg.weighted(x, y);
+    }
+}
+
+// Worst distance from the reference, in output units, over a set of sweeps; fitFirst picks the order
+static double Sweep(Mode_e mode, bool fitFirst)
+{
+    OpenFIRE_Average avg;
+    // the last few exactly fitted positions, weighted the same way as the average under test
+    double refX[3] = {}, refY[3] = {};
+    int refIndex = 0;
+    double worst = 0.0;
+    uint32_t seed = 17;
+    auto rnd = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7FFF; };
+
+    double x1 = width / 2, y1 = height / 2;
+    for(int sweep = 0; sweep < 200; sweep++) {
+        // a flick on to another spot, at up to a screen width in a quarter second (209Hz frames)
+        double x0 = x1, y0 = y1;
+        x1 = rnd() % width;
+        y1 = rnd() % height;
+        int frames = 12 + rnd() % 40;
+        for(int f = 0; f <= frames; f++) {
+            int wx = (int)lround(x0 + (x1 - x0) * f / frames);
+            int wy = (int)lround(y0 + (y1 - y0) * f / frames);
+            double ex, ey;
+            Exact(wx, wy, ex, ey);
+
+            double meanX, meanY;
+            if(mode == Mode_Pair) {
+                refIndex = refIndex ? 0 : 1;
+                refX[refIndex] = ex;
+                refY[refIndex] = ey;
+                meanX = (refX[0] + refX[1]) / 2;
+                meanY = (refY[0] + refY[1]) / 2;
+            } else {
+                refIndex = refIndex < 2 ? refIndex + 1 : 0;
+                refX[refIndex] = ex;
+                refY[refIndex] = ey;
+                meanX = (ex + refX[0] + refX[1] + refX[2]) / 4;
+                meanY = (ey + refY[0] + refY[1] + refY[2]) / 4;
+            }
+            // the averages divide as ints, so the reference truncates the same way
+            meanX = trunc(meanX);
+            meanY = trunc(meanY);
+
+            int x = wx, y = wy;
+            if(fitFirst) {
+                OpenFIRE_Calibration::apply(fit, width, height, wx, wy, x, y);
+                Average(avg, mode, x, y);
+            } else {
+                Average(avg, mode, x, y);
+                OpenFIRE_Calibration::apply(fit, width, height, x, y, x, y);
+            }
+            // first frames are still filling the history
+            if(sweep || f >= 3) {
+                worst = fmax(worst, fmax(fabs(x - meanX), fabs(y - meanY)));
+            }
+        }
+    }
+    return worst;
+}
+
+static void TestFitThenAverage()
+{
+    for(Mode_e mode : {Mode_Pair, Mode_Weighted}) {
+        double after = Sweep(mode, true);
+        double before = Sweep(mode, false);
+        printf("%s: worst %.0f LSB averaging after the fit, %.0f LSB before it\n",
+               mode == Mode_Pair ? "2 frame average" : "weighted average", after, before);
+        CHECK(after <= 1.0);
+        CHECK(before > 1.0);
+    }
+}
+
+// Without a fit, the averaging is what it's always been
+static void TestAverages()
+{
+    OpenFIRE_Average avg;
+    int x = 100, y = 200;
+    avg.pair(x, y);
+    CHECK_EQ(x, 50);
+    CHECK_EQ(y, 100);
+    x = 300;
+    y = 400;
+    avg.pair(x, y);
+    CHECK_EQ(x, 200);
+    CHECK_EQ(y, 300);
+    x = -301;
+    y = 0;
+    avg.pair(x, y);
+    CHECK_EQ(x, 0);
+
+    // the current position counts twice, the 2 before it once each
+    OpenFIRE_Average weighted;
+    for(int i = 1; i <= 3; i++) {
+        x = i * 100;
+        y = -i * 100;
+        weighted.weighted(x, y);
+    }
+    CHECK_EQ(x, (300 + 100 + 200 + 300) / 4);
+    CHECK_EQ(y, -(300 + 100 + 200 + 300) / 4);
+    x = 1000;
+    y = 0;
+    weighted.weighted(x, y);
+    CHECK_EQ(x, (1000 + 1000 + 200 + 300) / 4);
+
+    // switching modes mid-run stays in the history
+    x = 10;
+    y = 10;
+    weighted.pair(x, y);
+    weighted.pair(x, y);
+    weighted.weighted(x, y);
+    weighted.weighted(x, y);
+    weighted.pair(x, y);
+    CHECK(x > 0 && x <= 1000);
+}
+
+int main()
+{
+    TestAverages();
+    TestFitThenAverage();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,132 @@
+// The fused output map from UpdateOutputMap() against the map() -> constrain() -> map() -> AR map() chain it
+// replaced, over random offsets with AR correction on & off, and inputs running off both edges. The fused map has
+// to be within 1 LSB of the exact composition; the old chain truncated towards zero at every stage, so it's off by
+// up to a screen unit's worth either way (and a bit more with AR), which is the deviation the fused map's meant to
+// have from it.
+#include <stdint.h>
+#include <math.h>
+#include <initializer_list>
+#include "HostTest.h"
+#include <Arduino.h>
+#include "OpenFIRE_AxisMap.h"
+
+// Perspective output space, as the sketch has it (resolution multiplied by 4)
+static const int res_x = 1920 << 2;
+static const int res_y = 1080 << 2;
+
+static uint32_t seed = 42;
+static int Random(int lo, int hi)
+{
+    seed = seed * 1103515245 + 12345;
+    return lo + (int)((seed >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+// As GetPosition() had it before the maps were folded
+static int32_t Chain(int in, int res, int lo, int hi, bool ar)
+{
+    int32_t v = map(in, 0, res, 0 - lo, res + hi);
+    v = constrain(v, 0, res);
+    v = map(v, 0, res, 0, 32767);
+    if(ar) {
+        v = map(v, 4147, 28697, 0, 32767);
+        v = constrain(v, 0, 32767);
+    }
+    return v;
+}
+
+// The same stages in double, rounded once at the end
+static int32_t Exact(int in, int res, int lo, int hi, bool ar)
+{
+    double v = (double)in * (res + lo + hi) / res - lo;
+    v = v * 32767.0 / res;
+    if(ar) {
+        v = (v - 4147.0) * 32767.0 / (28697 - 4147);
+    }
+    return constrain((int32_t)floor(v + 0.5), 0, 32767);
+}
+
+// As UpdateOutputMap() builds it & FrameOutput() applies it
+static OpenFIRE_AxisMap Fused(int res, int lo, int hi, bool ar)
+{
+    OpenFIRE_AxisMap m;
+    m.map(0, res, 0 - lo, res + hi);
+    m.map(0, res, 0, 32767);
+    if(ar) {
+        m.map(4147, 28697, 0, 32767);
+    }
+    m.bake();
+    return m;
+}
+
+static void TestAgainstChain()
+{
+    // X & Y, and X with AR correction (only ever on X)
+    const struct { int res; bool ar; const char *name; } axes[] = {
+        {res_x, false, "X"}, {res_x, true, "X with AR"}, {res_y, false, "Y"}
+    };
+    for(const auto &axis : axes) {
+        int32_t worstExact = 0, worstLow = 0, worstHigh = 0;
+        uint32_t samples = 0;
+        for(int trial = 0; trial < 200; trial++) {
+            int lo = Random(-600, 600), hi = Random(-600, 600);
+            OpenFIRE_AxisMap m = Fused(axis.res, lo, hi, axis.ar);
+            for(int i = 0; i < 5000; i++) {
+                int in = Random(-axis.res / 4, axis.res + axis.res / 4);
+                int32_t fused = constrain(m.apply(in), 0, 32767);
+                int32_t exact = Exact(in, axis.res, lo, hi, axis.ar);
+                int32_t chain = Chain(in, axis.res, lo, hi, axis.ar);
+                int32_t d = abs(fused - exact);
+                worstExact = d > worstExact ? d : worstExact;
+                worstLow = fused - chain > worstLow ? fused - chain : worstLow;
+                worstHigh = chain - fused > worstHigh ? chain - fused : worstHigh;
+                samples++;
+            }
+        }
+        // what the chain's truncations can add up to: under a screen unit out of the first map & under an LSB out
+        // of the second, both stretched by the AR map and then an LSB of its own, plus the fused map's rounding
+        double stretch = axis.ar ? 32767.0 / (28697 - 4147) : 1.0;
+        int32_t bound = (int32_t)((32767.0 / axis.res + 1.0) * stretch + (axis.ar ? 1.0 : 0.0) + 0.5);
+        printf("%s, %u samples: fused within %d LSB of exact; old chain reads up to %d LSB low & %d high "
+               "(bound %d)\n", axis.name, samples, worstExact, worstLow, worstHigh, bound);
+        CHECK(worstExact <= 1);
+        // low for positions on screen, high just off the edge where the first map's product is still negative
+        CHECK(worstLow <= bound);
+        CHECK(worstHigh <= bound);
+    }
+}
+
+// The ends of the screen land on the ends of the mouse range, whatever the offsets, and values past them clamp
+static void TestEdges()
+{
+    for(bool ar : {false, true}) {
+        for(int offset : {0, 120, -120}) {
+            OpenFIRE_AxisMap m = Fused(res_x, offset, offset, ar);
+            // where the first map puts the screen edges, exactly
+            double left = (double)offset * res_x / (res_x + 2 * offset);
+            double right = res_x - left;
+            double scale = 32767.0 / res_x * (res_x + 2 * offset) / res_x;
+            if(ar) {
+                CHECK_EQ(constrain(m.apply(lround(left)), 0, 32767), 0);
+                CHECK_EQ(constrain(m.apply(lround(right)), 0, 32767), 32767);
+            } else {
+                CHECK_NEAR(m.apply(lround(left)), (lround(left) - left) * scale, 1);
+                CHECK_NEAR(m.apply(lround(right)), 32767 + (lround(right) - right) * scale, 1);
+            }
+            CHECK_EQ(constrain(m.apply(-res_x), 0, 32767), 0);
+            CHECK_EQ(constrain(m.apply(2 * res_x), 0, 32767), 32767);
+        }
+    }
+    // with nothing in the chain it's a passthrough
+    OpenFIRE_AxisMap m;
+    m.bake();
+    for(int in : {-5, 0, 1, 4000, 32767}) {
+        CHECK_EQ(m.apply(in), in);
+    }
+}
+
+int main()
+{
+    TestAgainstChain();
+    TestEdges();
+    return HOSTTEST_RESULT();
+}
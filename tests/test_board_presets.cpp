@@ -0,0 +1,151 @@
+// BoardPresetFor() for every OPENFIRE_BOARD identifier OpenFIREBoard.h can give, plus one it can't: each should
+// land on its own board's layout (the Pico W on the Pico's, the VCC-GND YD & anything unknown on the generic one),
+// with no pin doing two jobs and somewhere for a second camera on the I2C channel the first isn't using.
+#include <stdint.h>
+#include <string.h>
+#include "HostTest.h"
+#include "SamcoBoardPresets.h"
+
+typedef struct Expect_s {
+    const char *board;          // as OPENFIRE_BOARD has it
+    const char *preset;         // entry it should get
+    int8_t trigger, camSDA, camSCL;
+    int8_t cam2SDA, cam2SCL;
+} Expect_t;
+
+static const Expect_t expected[] = {
+    {"adafruitItsyRP2040", "adafruitItsyRP2040", 6, 2, 3, 0, 1},
+    {"adafruitKB2040", "adafruitKB2040", A2, 2, 3, 12, 13},
+    {"arduinoNanoRP2040", "arduinoNanoRP2040", 15, 12, 13, A0, A1},
+    {"waveshareZero", "waveshareZero", 0, 14, 15, 8, 9},
+    {"vccgndYD", "generic", -1, 20, 21, A0, A1},
+    {"rpipico", "rpipico", 15, 20, 21, A0, A1},
+    {"rpipicow", "rpipico", 15, 20, 21, A0, A1},
+    {"generic", "generic", -1, 20, 21, A0, A1},
+    {"someOtherBoard", "generic", -1, 20, 21, A0, A1},
+    {"", "generic", -1, 20, 21, A0, A1},
+};
+
+static const SamcoPreferences::PinsMap_t *Entry(const char *name)
+{
+    for(const BoardPreset_t &preset : BoardPresets) {
+        if(!strcmp(preset.board, name)) {
+            return &preset.pins;
+        }
+    }
+    return nullptr;
+}
+
+static void TestLookup()
+{
+    for(const Expect_t &e : expected) {
+        const SamcoPreferences::PinsMap_t pins = BoardPresetFor(e.board);
+        const SamcoPreferences::PinsMap_t *entry = Entry(e.preset);
+        CHECK(entry != nullptr);
+        if(!entry) {
+            continue;
+        }
+        if(memcmp(&pins, entry, sizeof(pins))) {
+            printf("%s: didn't get the %s preset\n", e.board, e.preset);
+            CHECK(false);
+        }
+        CHECK_EQ(pins.bTrigger, e.trigger);
+        CHECK_EQ(pins.pCamSDA, e.camSDA);
+        CHECK_EQ(pins.pCamSCL, e.camSCL);
+        CHECK_EQ(pins.pCam2SDA, e.cam2SDA);
+        CHECK_EQ(pins.pCam2SCL, e.cam2SCL);
+        CHECK(BoardPresetPinsUnique(pins));
+        CHECK(BoardPresetCam2Usable(pins));
+    }
+    // the generic entry's the fallback, so it has to stay last
+    CHECK(!strcmp(BoardPresets[sizeof(BoardPresets) / sizeof(BoardPresets[0]) - 1].board, "generic"));
+    // and this build (no board defined) gets it too
+    CHECK(!strcmp(OPENFIRE_BOARD, "generic"));
+    CHECK(!memcmp(&BoardPreset, Entry("generic"), sizeof(BoardPreset)));
+}
+
+static void TestEntries()
+{
+    for(const BoardPreset_t &preset : BoardPresets) {
+        // every entry's reachable by its own name, and only mapped to GPIO the RP2040 has
+        const SamcoPreferences::PinsMap_t pins = BoardPresetFor(preset.board);
+        CHECK(!memcmp(&pins, &preset.pins, sizeof(pins)));
+        const int8_t *p = (const int8_t *)&preset.pins;
+        for(size_t i = 0; i < sizeof(preset.pins); i++) {
+            CHECK(p[i] >= -1 && p[i] <= 29);
+        }
+        // a camera needs both its lines
+        CHECK((preset.pins.pCamSDA < 0) == (preset.pins.pCamSCL < 0));
+        CHECK((preset.pins.pCam2SDA < 0) == (preset.pins.pCam2SCL < 0));
+    }
+    // names don't repeat
+    const size_t count = sizeof(BoardPresets) / sizeof(BoardPresets[0]);
+    for(size_t i = 0; i < count; i++) {
+        for(size_t j = i + 1; j < count; j++) {
+            CHECK(strcmp(BoardPresets[i].board, BoardPresets[j].board) != 0);
+        }
+    }
+}
+
+// The conflict check itself catches a doubled-up pin in any field
+static void TestConflicts()
+{
+    SamcoPreferences::PinsMap_t pins = BoardPresetFor("rpipico");
+    CHECK(BoardPresetPinsUnique(pins));
+    int8_t *p = (int8_t *)&pins;
+    for(size_t i = 0; i < sizeof(pins); i++) {
+        for(size_t j = 0; j < sizeof(pins); j++) {
+            if(i == j || p[j] < 0) {
+                continue;
+            }
+            int8_t was = p[i];
+            p[i] = p[j];
+            CHECK(!BoardPresetPinsUnique(pins));
+            p[i] = was;
+        }
+    }
+    // unmapped pins don't count as a clash
+    SamcoPreferences::PinsMap_t none{};
+    CHECK(BoardPresetPinsUnique(none));
+}
+
+// The second camera's pins have to be a pair on the other channel from the first camera & the peripherals
+static void TestCam2()
+{
+    SamcoPreferences::PinsMap_t pins = BoardPresetFor("rpipico");
+    CHECK(BoardPresetCam2Usable(pins));
+    // the old fixed 26/27 on the ItsyBitsy & KB2040: the right channel, but already buttons there
+    SamcoPreferences::PinsMap_t itsy = BoardPresetFor("adafruitItsyRP2040");
+    itsy.pCam2SDA = 26, itsy.pCam2SCL = 27;
+    CHECK(!BoardPresetPinsUnique(itsy));
+    SamcoPreferences::PinsMap_t kb = BoardPresetFor("adafruitKB2040");
+    kb.pCam2SDA = 26, kb.pCam2SCL = 27;
+    CHECK(!BoardPresetPinsUnique(kb));
+    // any pair on the other channel will do, but not one on the first camera's
+    pins.pCam2SDA = 18, pins.pCam2SCL = 19;
+    CHECK(BoardPresetCam2Usable(pins));
+    pins.pCam2SDA = 24, pins.pCam2SCL = 25;
+    CHECK(!BoardPresetCam2Usable(pins));
+    // SDA & SCL swapped, or split across channels
+    pins.pCam2SDA = 27, pins.pCam2SCL = 26;
+    CHECK(!BoardPresetCam2Usable(pins));
+    pins.pCam2SDA = 26, pins.pCam2SCL = 25;
+    CHECK(!BoardPresetCam2Usable(pins));
+    // the display on the channel it wanted
+    pins.pCam2SDA = A0, pins.pCam2SCL = A1;
+    pins.pPeriphSDA = 10, pins.pPeriphSCL = 11;
+    CHECK(!BoardPresetCam2Usable(pins));
+    // or not mapped at all
+    pins = BoardPresetFor("rpipico");
+    pins.pCam2SCL = -1;
+    CHECK(!BoardPresetCam2Usable(pins));
+}
+
+int main()
+{
+    TestLookup();
+    TestEntries();
+    TestConflicts();
+    TestCam2();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,321 @@
+// BTQueue_ against a model Bluetooth link that takes one report per slot, with a 209Hz cursor and a trigger pulled
+// every 300ms: sending every report straight to the stack against pacing them through the queue.
+// Then merging to the newest report per ID, button/key changes going out in order & first, what happens past
+// BTQUEUE_EDGES of them, relative deltas being summed, and IDs taking turns.
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include "HostTest.h"
+#include "TinyUSB_BTQueue.h"
+
+static const uint8_t mouseId = 3;
+static const uint8_t keyboardId = 1;
+static const uint8_t relativeId = 5;
+
+typedef struct Sent_s {
+    uint8_t id;
+    uint8_t data[BTQUEUE_REPORT_MAX];
+} Sent_t;
+
+typedef struct Link_s {
+    std::vector<double> cursorAge;  // ms from a cursor position being made to it arriving
+    std::vector<double> pressAge;   // ms from the trigger being pulled to the press arriving
+    uint32_t presses, releases;     // arrived
+    size_t backlog;                 // still in the stack at the end
+} Link_t;
+
+// Ten seconds in 100us steps; the stack takes whatever it's given into a FIFO, and the radio sends one per slot
+static Link_t RunLink(bool paced, uint32_t slot)
+{
+    std::deque<Sent_t> stack;
+    BTQueue_ queue;
+    queue.setInterval(slot);
+    Link_t link = {};
+    static uint32_t made[65536];    // when each cursor position was made
+    uint16_t pos = 0;
+    uint8_t buttons = 0, lastButtons = 0;
+    uint32_t pulled = 0, nextSlot = 0;
+
+    for(uint32_t t = 0; t < 10000000; t += 100) {
+        bool edge = false;
+        if(t % 300000 == 0) {
+            buttons = 1;
+            pulled = t;
+            edge = true;
+        } else if(t % 300000 == 60000) {
+            buttons = 0;
+            edge = true;
+        }
+        bool frame = t % 4785 < 100;
+        if(frame) {
+            made[++pos] = t;
+        }
+        if(frame || edge) {
+            uint8_t report[5] = {buttons, (uint8_t)pos, (uint8_t)(pos >> 8), 0, 0};
+            if(paced) {
+                queue.queue(mouseId, report, sizeof(report), edge);
+            } else {
+                Sent_t s = {mouseId, {}};
+                memcpy(s.data, report, sizeof(report));
+                stack.push_back(s);
+            }
+        }
+        // the sketch's flush() each loop
+        uint8_t id, len;
+        Sent_t s = {};
+        if(paced && queue.next(t, id, s.data, len)) {
+            s.id = id;
+            stack.push_back(s);
+        }
+
+        if(t >= nextSlot) {
+            nextSlot = t + slot;
+            if(!stack.empty()) {
+                Sent_t out = stack.front();
+                stack.pop_front();
+                uint16_t p = out.data[1] | (out.data[2] << 8);
+                if(p) {
+                    link.cursorAge.push_back((t - made[p]) / 1000.0);
+                }
+                if((out.data[0] & 1) && !(lastButtons & 1)) {
+                    link.presses++;
+                    link.pressAge.push_back((t - pulled) / 1000.0);
+                }
+                if(!(out.data[0] & 1) && (lastButtons & 1)) {
+                    link.releases++;
+                }
+                lastButtons = out.data[0];
+            }
+        }
+    }
+    link.backlog = stack.size();
+    return link;
+}
+
+static double Median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+static double Worst(const std::vector<double> &v)
+{
+    return v.empty() ? 0.0 : *std::max_element(v.begin(), v.end());
+}
+
+static void TestLink()
+{
+    // 7.5ms is the shortest interval a Bluetooth Classic HID link is likely to get
+    const uint32_t slot = 7500;
+    Link_t direct = RunLink(false, slot);
+    Link_t paced = RunLink(true, slot);
+    printf("direct: %zu reports backed up, cursor %.1fms old (median), presses %.1fms late, %u of 34 arrived\n",
+           direct.backlog, Median(direct.cursorAge), Median(direct.pressAge), direct.presses);
+    printf("queued: %zu backed up, cursor %.1fms old (median) %.1fms (worst), presses %.1fms late at worst\n",
+           paced.backlog, Median(paced.cursorAge), Worst(paced.cursorAge), Worst(paced.pressAge));
+    // straight to the stack, the cursor falls further and further behind
+    CHECK(direct.backlog > 500);
+    CHECK(Median(direct.cursorAge) > 1000.0);
+    // queued, the cursor's never more than a slot old, and every press & release goes out in the next slot
+    CHECK(paced.backlog <= 1);
+    CHECK(Worst(paced.cursorAge) <= slot / 1000.0);
+    CHECK_EQ(paced.presses, 34);
+    CHECK_EQ(paced.releases, 34);
+    CHECK(Worst(paced.pressAge) <= slot / 1000.0);
+}
+
+// Takes the next report, at a time the interval's well past
+static bool Next(BTQueue_ &queue, uint32_t &now, uint8_t &id, uint8_t *data, uint8_t &len)
+{
+    now += BTQUEUE_INTERVAL_DEFAULT;
+    return queue.next(now, id, data, len);
+}
+
+static void TestMerge()
+{
+    BTQueue_ queue;
+    uint32_t now = 0;
+    uint8_t id, len, data[BTQUEUE_REPORT_MAX];
+    for(uint8_t x = 1; x <= 20; x++) {
+        uint8_t report[5] = {0, x, 0, x, 0};
+        queue.queue(mouseId, report, sizeof(report), false);
+    }
+    // only the newest goes
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(id, mouseId);
+    CHECK_EQ(len, 5);
+    CHECK_EQ(data[1], 20);
+    CHECK_EQ(data[3], 20);
+    uint32_t sentAt = now;
+    CHECK(!Next(queue, now, id, data, len));
+
+    // no sooner than the interval after the last one sent
+    uint8_t report[5] = {0, 21, 0, 0, 0};
+    queue.queue(mouseId, report, sizeof(report), false);
+    CHECK(!queue.next(sentAt + BTQUEUE_INTERVAL_DEFAULT - 1, id, data, len));
+    now = sentAt + BTQUEUE_INTERVAL_DEFAULT;
+    CHECK(queue.next(now, id, data, len));
+    CHECK_EQ(data[1], 21);
+
+    // too big, or an ID out of range, is dropped
+    uint8_t big[BTQUEUE_REPORT_MAX + 1] = {};
+    queue.queue(mouseId, big, sizeof(big), false);
+    queue.queue(BTQUEUE_IDS, report, sizeof(report), false);
+    now += BTQUEUE_INTERVAL_DEFAULT;
+    CHECK(!Next(queue, now, id, data, len));
+
+    // clear() drops what's waiting, and the next one can go straight away
+    queue.queue(mouseId, report, sizeof(report), true);
+    queue.queue(keyboardId, report, sizeof(report), false);
+    queue.clear();
+    CHECK(!Next(queue, now, id, data, len));
+    queue.queue(mouseId, report, sizeof(report), false);
+    CHECK(queue.next(now, id, data, len));
+}
+
+// A quick press & release between sends both get there, in order, ahead of any cursor movement
+static void TestEdges()
+{
+    BTQueue_ queue;
+    uint32_t now = 0;
+    uint8_t id, len, data[BTQUEUE_REPORT_MAX];
+    uint8_t move1[5] = {0, 1, 0, 0, 0}, press[5] = {1, 2, 0, 0, 0}, move2[5] = {1, 3, 0, 0, 0};
+    uint8_t release[5] = {0, 4, 0, 0, 0}, move3[5] = {0, 5, 0, 0, 0};
+    uint8_t key[8] = {0, 0, 4, 0, 0, 0, 0, 0};
+    queue.queue(mouseId, move1, sizeof(move1), false);
+    queue.queue(mouseId, press, sizeof(press), true);
+    queue.queue(mouseId, move2, sizeof(move2), false);
+    queue.queue(keyboardId, key, sizeof(key), true);
+    queue.queue(mouseId, release, sizeof(release), true);
+    queue.queue(mouseId, move3, sizeof(move3), false);
+
+    // the changes in the order they came, then the last move; the moves before a change are older than it, so gone
+    const uint8_t expectId[4] = {mouseId, keyboardId, mouseId, mouseId};
+    const uint8_t expectX[4] = {2, 0, 4, 5};
+    for(int i = 0; i < 4; i++) {
+        CHECK(Next(queue, now, id, data, len));
+        CHECK_EQ(id, expectId[i]);
+        CHECK_EQ(data[1], expectX[i]);
+    }
+    CHECK_EQ(data[0], 0);
+    CHECK(!Next(queue, now, id, data, len));
+}
+
+// Past BTQUEUE_EDGES changes, the rest merge, but the buttons still end up as they were last left
+static void TestEdgeOverflow()
+{
+    BTQueue_ queue;
+    uint32_t now = 0;
+    uint8_t id, len, data[BTQUEUE_REPORT_MAX];
+    const int count = BTQUEUE_EDGES + 5;
+    for(int i = 0; i < count; i++) {
+        uint8_t report[5] = {(uint8_t)(i & 1), (uint8_t)i, 0, 0, 0};
+        queue.queue(mouseId, report, sizeof(report), true);
+    }
+    for(int i = 0; i < BTQUEUE_EDGES; i++) {
+        CHECK(Next(queue, now, id, data, len));
+        CHECK_EQ(data[1], i);
+        CHECK_EQ(data[0], i & 1);
+    }
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(data[1], count - 1);
+    CHECK_EQ(data[0], (count - 1) & 1);
+    CHECK(!Next(queue, now, id, data, len));
+
+    // and once they've drained, changes are held in order again
+    uint8_t press[5] = {1, 100, 0, 0, 0}, release[5] = {0, 101, 0, 0, 0};
+    queue.queue(mouseId, press, sizeof(press), true);
+    queue.queue(mouseId, release, sizeof(release), true);
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(data[1], 100);
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(data[1], 101);
+}
+
+static void Rel(uint8_t *report, uint8_t buttons, int16_t x, int16_t y)
+{
+    report[0] = buttons;
+    report[1] = x & 0xFF;
+    report[2] = (x >> 8) & 0xFF;
+    report[3] = y & 0xFF;
+    report[4] = (y >> 8) & 0xFF;
+}
+
+static int16_t RelX(const uint8_t *data) { return (int16_t)(data[1] | (data[2] << 8)); }
+static int16_t RelY(const uint8_t *data) { return (int16_t)(data[3] | (data[4] << 8)); }
+
+// Relative deltas add up rather than replace each other, so no movement's lost between sends
+static void TestRelative()
+{
+    BTQueue_ queue;
+    uint32_t now = 0;
+    uint8_t id, len, data[BTQUEUE_REPORT_MAX], report[5];
+    int16_t sumX = 0, sumY = 0;
+    for(int i = 0; i < 10; i++) {
+        Rel(report, 0, 7 - i * 3, i * 2 - 5);
+        sumX += 7 - i * 3;
+        sumY += i * 2 - 5;
+        queue.queue(relativeId, report, sizeof(report), false, true);
+    }
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(id, relativeId);
+    CHECK_EQ(RelX(data), sumX);
+    CHECK_EQ(RelY(data), sumY);
+
+    // deltas waiting when a button changes go out with it, then counting starts again
+    Rel(report, 0, 10, -10);
+    queue.queue(relativeId, report, sizeof(report), false, true);
+    Rel(report, 1, 5, 5);
+    queue.queue(relativeId, report, sizeof(report), true, true);
+    Rel(report, 1, 3, 4);
+    queue.queue(relativeId, report, sizeof(report), false, true);
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(data[0], 1);
+    CHECK_EQ(RelX(data), 15);
+    CHECK_EQ(RelY(data), -5);
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(RelX(data), 3);
+    CHECK_EQ(RelY(data), 4);
+
+    // the buttons byte is the newest one's, and the sums saturate rather than wrap
+    Rel(report, 0, 30000, -30000);
+    queue.queue(relativeId, report, sizeof(report), false, true);
+    Rel(report, 2, 30000, -30000);
+    queue.queue(relativeId, report, sizeof(report), false, true);
+    CHECK(Next(queue, now, id, data, len));
+    CHECK_EQ(data[0], 2);
+    CHECK_EQ(RelX(data), 32767);
+    CHECK_EQ(RelY(data), -32767);
+}
+
+// IDs take turns, so a cursor updated every frame can't keep the keyboard waiting
+static void TestTurns()
+{
+    BTQueue_ queue;
+    uint32_t now = 0;
+    uint8_t id, len, data[BTQUEUE_REPORT_MAX];
+    uint8_t key[8] = {0, 0, 4, 0, 0, 0, 0, 0}, move[5] = {};
+    queue.queue(keyboardId, key, sizeof(key), false);
+    uint32_t keyAfter = 0;
+    for(uint32_t sends = 1; sends <= 4 && !keyAfter; sends++) {
+        queue.queue(mouseId, move, sizeof(move), false);
+        CHECK(Next(queue, now, id, data, len));
+        if(id == keyboardId) {
+            keyAfter = sends;
+        }
+    }
+    CHECK(keyAfter >= 1 && keyAfter <= 2);
+}
+
+int main()
+{
+    TestLink();
+    TestMerge();
+    TestEdges();
+    TestEdgeOverflow();
+    TestRelative();
+    TestTurns();
+    return HOSTTEST_RESULT();
+}
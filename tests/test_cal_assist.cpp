@@ -0,0 +1,267 @@
+// CalGlide driven by a simulated USB endpoint, ticked far faster than its slots: one report per slot at most,
+// eased all the way from start to target without overshoot, and always ending on the target even with a busy
+// endpoint. CalSteady fed camera frames at 209Hz: steady aims, trigger-pull jolts, and aims too shaky to settle.
+#include <stdint.h>
+#include <stdlib.h>
+#include "HostTest.h"
+#include "OpenFIRECalAssist.h"
+
+typedef struct GlideRun_s {
+    uint32_t reports;
+    uint32_t tooSoon;           // reports less than a slot after the last
+    uint32_t backwards;         // steps against the direction of travel
+    uint32_t overshoot;         // positions outside the from/to box
+    uint32_t took;              // from Start() to the final report, in microseconds
+    uint32_t firstAt;           // first report, after Start()
+    uint16_t lastX, lastY;
+    uint32_t maxStep;           // largest jump between two reports, along either axis
+    uint32_t midStep;           // largest jump around the middle of the glide
+    uint32_t edgeStep;          // largest jump in the first & last tenth of the glide
+} GlideRun_t;
+
+// Ticks every `tick` us; the endpoint's busy whenever busy(t) says so
+static GlideRun_t Glide(uint16_t fromX, uint16_t fromY, uint16_t toX, uint16_t toY, uint32_t start,
+                        uint32_t tick, bool (*busy)(uint32_t))
+{
+    GlideRun_t run = {};
+    CalGlide glide;
+    glide.Start(fromX, fromY, toX, toY, start);
+    int dist = abs(toX - fromX) > abs(toY - fromY) ? abs(toX - fromX) : abs(toY - fromY);
+    uint32_t duration = dist * CALGLIDE_US_PER_UNIT;
+    if(duration < CALGLIDE_MIN) {
+        duration = CALGLIDE_MIN;
+    }
+    int dirX = toX > fromX ? 1 : -1, dirY = toY > fromY ? 1 : -1;
+    uint16_t lowX = fromX < toX ? fromX : toX, highX = fromX < toX ? toX : fromX;
+    uint16_t lowY = fromY < toY ? fromY : toY, highY = fromY < toY ? toY : fromY;
+    uint16_t prevX = fromX, prevY = fromY;
+    uint32_t prevStamp = 0;
+
+    for(uint32_t t = start; glide.Active() && t - start < duration * 2 + 1000000; t += tick) {
+        uint16_t x, y;
+        if(!glide.Tick(t, !busy(t - start), x, y)) {
+            continue;
+        }
+        uint32_t elapsed = t - start;
+        if(!run.reports) {
+            run.firstAt = elapsed;
+        } else if(t - prevStamp < CALGLIDE_SLOT) {
+            run.tooSoon++;
+        }
+        if((x - prevX) * dirX < 0 || (y - prevY) * dirY < 0) {
+            run.backwards++;
+        }
+        if(x < lowX || x > highX || y < lowY || y > highY) {
+            run.overshoot++;
+        }
+        uint32_t step = abs(x - prevX) > abs(y - prevY) ? abs(x - prevX) : abs(y - prevY);
+        if(step > run.maxStep) {
+            run.maxStep = step;
+        }
+        if(elapsed > duration * 45 / 100 && elapsed < duration * 55 / 100 && step > run.midStep) {
+            run.midStep = step;
+        }
+        if((elapsed < duration / 10 || elapsed > duration * 9 / 10) && step > run.edgeStep) {
+            run.edgeStep = step;
+        }
+        prevX = x, prevY = y;
+        prevStamp = t;
+        run.reports++;
+        run.lastX = x, run.lastY = y;
+        run.took = elapsed;
+    }
+    return run;
+}
+
+static bool NeverBusy(uint32_t) { return false; }
+// busy for a few hundred us out of every couple of ms, like an endpoint sharing the bus with keyboard/gamepad reports
+static bool OftenBusy(uint32_t t) { return (t % 2300) < 900; }
+// busy for the whole last stretch, so the final report has to wait
+static bool BusyAtEnd(uint32_t t) { return t > 200000 && t < 400000; }
+
+static void TestGlide()
+{
+    // half a screen up, ticked every 100us: one report per 1ms slot at most, eased in & out
+    GlideRun_t run = Glide(16384, 16384, 16384, 0, 1000000, 100, NeverBusy);
+    uint32_t duration = 16384 * CALGLIDE_US_PER_UNIT;
+    printf("half screen: %u reports over %uus, biggest step %u (%u mid-glide, %u at the ends)\n",
+           run.reports, run.took, run.maxStep, run.midStep, run.edgeStep);
+    CHECK_EQ(run.firstAt, 0);
+    CHECK_EQ(run.tooSoon, 0);
+    CHECK_EQ(run.backwards, 0);
+    CHECK_EQ(run.overshoot, 0);
+    CHECK_EQ(run.lastX, 16384);
+    CHECK_EQ(run.lastY, 0);
+    // the last step or two can already round to the target, so the final report may come a slot early
+    CHECK(run.took > duration - 2 * CALGLIDE_SLOT);
+    CHECK(run.took < duration + CALGLIDE_SLOT);
+    // about one report per slot, not hundreds of blocking ones
+    CHECK(run.reports <= duration / CALGLIDE_SLOT + 2);
+    CHECK(run.reports > duration / CALGLIDE_SLOT / 2);
+    // eased: fastest in the middle (1.5x the average speed for a smoothstep), slow at either end
+    CHECK_NEAR(run.midStep, 1.5 * 16384 / (duration / CALGLIDE_SLOT), 4);
+    CHECK(run.edgeStep < run.midStep / 2);
+
+    // diagonal, corner to corner, with a busy endpoint: slots get skipped, never doubled up, and it still lands
+    run = Glide(0, 32767, 32767, 0, 0, 50, OftenBusy);
+    CHECK_EQ(run.tooSoon, 0);
+    CHECK_EQ(run.backwards, 0);
+    CHECK_EQ(run.overshoot, 0);
+    CHECK_EQ(run.lastX, 32767);
+    CHECK_EQ(run.lastY, 0);
+    CHECK(run.took < 32767 * CALGLIDE_US_PER_UNIT + 2300);
+
+    // endpoint busy when it's due to finish: the final position goes out as soon as it can
+    run = Glide(20000, 20000, 4000, 8000, 0, 100, BusyAtEnd);
+    CHECK_EQ(run.lastX, 4000);
+    CHECK_EQ(run.lastY, 8000);
+    CHECK(run.took >= 400000);
+    CHECK(run.took < 400000 + CALGLIDE_SLOT);
+
+    // a small hop still takes the minimum time, so it can be seen
+    run = Glide(1000, 1000, 1100, 1000, 0, 100, NeverBusy);
+    CHECK_EQ(run.lastX, 1100);
+    CHECK(run.took >= CALGLIDE_MIN);
+    CHECK(run.took < CALGLIDE_MIN + CALGLIDE_SLOT);
+    // and repeats of the same position don't go out
+    CHECK(run.reports <= 101);
+
+    // micros() wrapping mid-glide
+    run = Glide(0, 0, 8000, 8000, 0xFFFFFFFFu - 50000, 100, NeverBusy);
+    CHECK_EQ(run.tooSoon, 0);
+    CHECK_EQ(run.backwards, 0);
+    CHECK_EQ(run.lastX, 8000);
+    CHECK_EQ(run.lastY, 8000);
+    CHECK(run.took >= 8000 * CALGLIDE_US_PER_UNIT);
+}
+
+static void TestGlideRestart()
+{
+    // a new target while one's gliding starts over from where it's told to
+    CalGlide glide;
+    uint16_t x, y;
+    CHECK(!glide.Active());
+    CHECK(!glide.Tick(0, true, x, y));
+    glide.Start(0, 0, 10000, 0, 0);
+    CHECK(glide.Tick(0, true, x, y));
+    CHECK_EQ(x, 0);
+    CHECK(!glide.Tick(500, true, x, y));
+    glide.Start(5000, 5000, 5000, 5000, 600);
+    CHECK(glide.Tick(600, true, x, y));
+    CHECK_EQ(x, 5000);
+    CHECK_EQ(y, 5000);
+    // staying put: no more reports, and it ends on time
+    uint32_t t = 600;
+    while(glide.Active()) {
+        t += 100;
+        CHECK(!glide.Tick(t, true, x, y));
+    }
+    CHECK(t - 600 >= CALGLIDE_MIN);
+}
+
+// Camera frame interval at 209Hz, in microseconds
+static const uint32_t frameMicros = 1000000 / 209;
+
+// Feeds frames from aim(frame) until a sample comes out; returns the frame it came out on, or -1
+static int Steady(CalSteady &steady, uint32_t &now, void (*aim)(int frame, int &x, int &y), int limit = 1000)
+{
+    for(int frame = 0; frame < limit; frame++) {
+        int x, y;
+        aim(frame, x, y);
+        now += frameMicros;
+        if(steady.Feed(x, y, now)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+static uint32_t seed = 11;
+static int Jitter(int range) { seed = seed * 1103515245 + 12345; return (int)((seed >> 16) % (2 * range + 1)) - range; }
+
+static void StillAim(int, int &x, int &y) { x = 3000 + Jitter(3); y = 2000 + Jitter(3); }
+// the trigger pull knocks the aim around for ~50ms, then it settles a little off from where it was
+static void JoltAim(int frame, int &x, int &y)
+{
+    if(frame < 10) {
+        x = 3000 + (frame & 1 ? 120 : -80) + frame * 15;
+        y = 2000 - frame * 20;
+    } else {
+        x = 3150 + Jitter(2);
+        y = 1800 + Jitter(2);
+    }
+}
+static void ShakyAim(int frame, int &x, int &y) { x = 3000 + (frame & 1 ? 40 : -40); y = 2000 + Jitter(20); }
+static void DriftAim(int frame, int &x, int &y) { x = 3000 + frame; y = 2000; }
+
+static void TestSteady()
+{
+    CalSteady steady;
+    uint32_t now = 0;
+    CHECK(!steady.Armed());
+    CHECK(!steady.Feed(1, 1, now));
+
+    // held still: sampled as soon as the window's full, averaging out the jitter
+    steady.Arm(now);
+    CHECK(steady.Armed());
+    CHECK_EQ(Steady(steady, now, StillAim), CALSTEADY_FRAMES - 1);
+    CHECK(!steady.Armed());
+    CHECK(!steady.timedOut);
+    CHECK_NEAR(steady.x, 3000, 3);
+    CHECK_NEAR(steady.y, 2000, 3);
+
+    // a jolt on the trigger pull: nothing's taken until every jolted frame's out of the window
+    steady.Arm(now);
+    int frame = Steady(steady, now, JoltAim);
+    printf("jolt: sampled on frame %d at (%d, %d)\n", frame, steady.x, steady.y);
+    CHECK_EQ(frame, 10 + CALSTEADY_FRAMES - 1);
+    CHECK(!steady.timedOut);
+    CHECK_NEAR(steady.x, 3150, 2);
+    CHECK_NEAR(steady.y, 1800, 2);
+
+    // too shaky to ever settle: it takes the last frames' average once it's waited long enough
+    steady.Arm(now);
+    uint32_t armed = now;
+    frame = Steady(steady, now, ShakyAim);
+    printf("shaky: sampled on frame %d, %uus after arming\n", frame, now - armed);
+    CHECK(steady.timedOut);
+    CHECK(now - armed >= CALSTEADY_TIMEOUT);
+    CHECK(now - armed < CALSTEADY_TIMEOUT + frameMicros);
+    CHECK_NEAR(steady.x, 3000, 1);
+    CHECK_NEAR(steady.y, 2000, 20);
+
+    // a slow drift stays within the spread, so it counts as steady
+    steady.Arm(now);
+    CHECK_EQ(Steady(steady, now, DriftAim), CALSTEADY_FRAMES - 1);
+    CHECK_EQ(steady.x, 3000 + (CALSTEADY_FRAMES - 1) / 2);
+
+    // spread right at the limit counts, one past it doesn't
+    steady.Arm(now);
+    for(int i = 0; i < CALSTEADY_FRAMES - 1; i++) {
+        CHECK(!steady.Feed(500 + (i & 1) * CALSTEADY_SPREAD, 500, now));
+    }
+    CHECK(steady.Feed(500, 500, now));
+    steady.Arm(now);
+    for(int i = 0; i < CALSTEADY_FRAMES; i++) {
+        CHECK(!steady.Feed(500, 500 + (i & 1) * (CALSTEADY_SPREAD + 1), now));
+    }
+
+    // re-arming starts the window over: frames from before don't count toward the next sample
+    steady.Arm(now);
+    for(int i = 0; i < CALSTEADY_FRAMES - 1; i++) {
+        steady.Feed(100, 100, now);
+    }
+    steady.Arm(now);
+    CHECK(!steady.Feed(100, 100, now));
+    now = 0xFFFFFFFFu - 100000;
+    steady.Arm(now);
+    CHECK_EQ(Steady(steady, now, ShakyAim), (int)(CALSTEADY_TIMEOUT / frameMicros));
+}
+
+int main()
+{
+    TestGlide();
+    TestGlideRestart();
+    TestSteady();
+    return HOSTTEST_RESULT();
+}
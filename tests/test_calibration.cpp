@@ -0,0 +1,202 @@
+// Grid calibration fit against a synthetic screen: a known homography & radial bow distort where each grid target
+// is seen, the aimed samples are fed through add() as the calibration would, and fit() has to recover the
+// coefficients it was made with, with a residual down at the rounding of the samples.
+#include <stdint.h>
+#include <math.h>
+#include "HostTest.h"
+#include "OpenFIRE_Calibration.h"
+
+// Perspective output space, as the sketch has it (resolution multiplied by 4)
+static const int width = 1920 << 2;
+static const int height = 1080 << 2;
+
+// The fit's own model, in doubles: normalized sample -> normalized target
+static void Forward(const CalibrationFit_t &fit, double x, double y, double &outX, double &outY)
+{
+    double r = 1.0 + fit.k1 * (x * x + y * y);
+    x *= r;
+    y *= r;
+    double d = fit.h[6] * x + fit.h[7] * y + 1.0;
+    outX = (fit.h[0] * x + fit.h[1] * y + fit.h[2]) / d;
+    outY = (fit.h[3] * x + fit.h[4] * y + fit.h[5]) / d;
+}
+
+// Where the gun's perspective output has to be for the fit to put it on a target: Newton's method on Forward()
+static bool Sample(const CalibrationFit_t &truth, int targetX, int targetY, double &x, double &y)
+{
+    const double cx = width * 0.5, cy = height * 0.5, s = width * 0.5;
+    double tx = (targetX - cx) / s, ty = (targetY - cy) / s;
+    double nx = tx, ny = ty;
+    for(int i = 0; i < 30; i++) {
+        double fx, fy, ax, ay, bx, by;
+        const double e = 1e-7;
+        Forward(truth, nx, ny, fx, fy);
+        Forward(truth, nx + e, ny, ax, ay);
+        Forward(truth, nx, ny + e, bx, by);
+        double j00 = (ax - fx) / e, j01 = (bx - fx) / e, j10 = (ay - fy) / e, j11 = (by - fy) / e;
+        double det = j00 * j11 - j01 * j10;
+        double ex = tx - fx, ey = ty - fy;
+        nx += (j11 * ex - j01 * ey) / det;
+        ny += (j00 * ey - j10 * ex) / det;
+    }
+    x = nx * s + cx;
+    y = ny * s + cy;
+    double fx, fy;
+    Forward(truth, nx, ny, fx, fy);
+    return hypot(fx - tx, fy - ty) < 1e-9;
+}
+
+// Largest distance between where the truth & the fit put any point on the screen, in output units
+static double ScreenError(const CalibrationFit_t &truth, const CalibrationFit_t &fit)
+{
+    double worst = 0.0;
+    for(int x = 0; x <= width; x += width / 32) {
+        for(int y = 0; y <= height; y += height / 18) {
+            int ax, ay, bx, by;
+            OpenFIRE_Calibration::apply(truth, width, height, x, y, ax, ay);
+            OpenFIRE_Calibration::apply(fit, width, height, x, y, bx, by);
+            worst = fmax(worst, hypot(ax - bx, ay - by));
+        }
+    }
+    return worst;
+}
+
+// A keystoned projector with a bit of barrel bow, and a curved panel's pincushion
+static const CalibrationFit_t screens[] = {
+    {16, {1.05f, 0.03f, 0.02f, -0.02f, 0.97f, -0.01f, 0.04f, -0.03f}, 0.08f},
+    {16, {0.94f, -0.02f, -0.015f, 0.01f, 1.03f, 0.02f, -0.03f, 0.02f}, -0.06f},
+};
+
+static void TestRecovery()
+{
+    for(const CalibrationFit_t &truth : screens) {
+        for(uint8_t side = 3; side <= 4; side++) {
+            OpenFIRE_Calibration cal;
+            cal.begin(width, height);
+            for(uint8_t i = 0; i < side * side; i++) {
+                int tx, ty;
+                double sx, sy;
+                OpenFIRE_Calibration::target(side, i, width, height, tx, ty);
+                CHECK(Sample(truth, tx, ty, sx, sy));
+                CHECK(cal.add((int)lround(sx), (int)lround(sy), tx, ty));
+            }
+            CalibrationFit_t fit;
+            CHECK(cal.fit(fit));
+            CHECK_EQ(fit.points, side * side);
+            CHECK(OpenFIRE_Calibration::valid(fit));
+            double screenErr = ScreenError(truth, fit);
+            printf("%dx%d, k1 %+.2f: got k1 %+.4f, residual %.3f, worst over the screen %.2f\n",
+                   side, side, truth.k1, fit.k1, cal.residual(), screenErr);
+
+            // samples are whole output units, so the residual's no more than their rounding
+            CHECK(cal.residual() < 1.0f);
+            CHECK_NEAR(fit.k1, truth.k1, 0.01);
+            for(uint8_t k = 0; k < 6; k++) {
+                CHECK_NEAR(fit.h[k], truth.h[k], 0.005);
+            }
+            CHECK_NEAR(fit.h[6], truth.h[6], 0.005);
+            CHECK_NEAR(fit.h[7], truth.h[7], 0.005);
+            // and it holds between & past the grid points too, to within a couple of units
+            CHECK(screenErr < 4.0);
+
+            // a homography alone can't take the bow out
+            OpenFIRE_Calibration flat = cal;
+            CalibrationFit_t flatFit;
+            CHECK(flat.fit(flatFit, false));
+            CHECK_EQ(flatFit.k1, 0.0f);
+            CHECK(flat.residual() > 10.0f * cal.residual());
+        }
+    }
+}
+
+// Aim's never that exact: jitter each sample by up to a few units, and the residual should come out about that
+static void TestNoisySamples()
+{
+    const CalibrationFit_t &truth = screens[0];
+    uint32_t seed = 9;
+    auto jitter = [&seed]() { seed = seed * 1103515245 + 12345; return (int)((seed >> 16) % 17) - 8; };
+
+    OpenFIRE_Calibration cal;
+    cal.begin(width, height);
+    for(uint8_t i = 0; i < 16; i++) {
+        int tx, ty;
+        double sx, sy;
+        OpenFIRE_Calibration::target(4, i, width, height, tx, ty);
+        Sample(truth, tx, ty, sx, sy);
+        cal.add((int)lround(sx) + jitter(), (int)lround(sy) + jitter(), tx, ty);
+    }
+    CalibrationFit_t fit;
+    CHECK(cal.fit(fit));
+    double screenErr = ScreenError(truth, fit);
+    printf("jittered 4x4: k1 %+.4f, residual %.3f, worst over the screen %.2f\n", fit.k1, cal.residual(), screenErr);
+    CHECK(cal.residual() > 0.5f);
+    CHECK(cal.residual() < 8.0f);
+    CHECK_NEAR(fit.k1, truth.k1, 0.03);
+    // a fraction of a percent of the screen, at worst
+    CHECK(screenErr < width * 0.005);
+}
+
+static void TestDegenerate()
+{
+    OpenFIRE_Calibration cal;
+    CalibrationFit_t fit = {};
+    fit.points = 0;
+
+    // too few
+    cal.begin(width, height);
+    for(uint8_t i = 0; i < 4; i++) {
+        cal.add(i * 100, i * 50, i * 100, i * 50);
+    }
+    CHECK(!cal.fit(fit));
+    CHECK_EQ(fit.points, 0);
+
+    // all in one spot
+    cal.begin(width, height);
+    for(uint8_t i = 0; i < 9; i++) {
+        cal.add(100, 100, 100, 100);
+    }
+    CHECK(!cal.fit(fit));
+    CHECK_EQ(fit.points, 0);
+
+    // no room past a 4x4 grid
+    cal.begin(width, height);
+    for(uint8_t i = 0; i < CALIBRATION_POINTS_MAX; i++) {
+        CHECK(cal.add(i, i, i, i));
+    }
+    CHECK(!cal.add(0, 0, 0, 0));
+
+    // an untouched screen fits as the identity
+    cal.begin(width, height);
+    for(uint8_t i = 0; i < 9; i++) {
+        int tx, ty;
+        OpenFIRE_Calibration::target(3, i, width, height, tx, ty);
+        cal.add(tx, ty, tx, ty);
+    }
+    CHECK(cal.fit(fit));
+    CHECK_NEAR(cal.residual(), 0.0f, 0.01);
+    CHECK_NEAR(fit.k1, 0.0f, 0.001);
+    CHECK_NEAR(fit.h[0], 1.0f, 0.001);
+    CHECK_NEAR(fit.h[4], 1.0f, 0.001);
+
+    // stored fits that can't be used
+    CalibrationFit_t bad = screens[0];
+    CHECK(OpenFIRE_Calibration::valid(bad));
+    bad.k1 = 2.0f;
+    CHECK(!OpenFIRE_Calibration::valid(bad));
+    bad = screens[0];
+    bad.h[3] = NAN;
+    CHECK(!OpenFIRE_Calibration::valid(bad));
+    bad = screens[0];
+    bad.points = 4;
+    CHECK(!OpenFIRE_Calibration::valid(bad));
+    bad.points = 0;
+    CHECK(OpenFIRE_Calibration::valid(bad));
+}
+
+int main()
+{
+    TestRecovery();
+    TestNoisySamples();
+    TestDegenerate();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,141 @@
+// The camera's bring-up against a modelled sensor on the host's Wire: one that ACKs straight away, one that NACKs
+// for a while after each register write, and one that never comes back. Checks the register writes keep at least
+// the settle time apart without waiting past the old fixed delay, then reads frames at 209Hz from the end of
+// begin() and times the first one accepted against the 150ms first report target. A model of the bus, not a
+// measurement on hardware.
+#include <stdint.h>
+#include <vector>
+#include <initializer_list>
+#include "HostTest.h"
+#include <Wire.h>
+#include "DFRobotIRPositionEx.h"
+
+// As DFRobotIRPositionEx.cpp has them, in microseconds
+static const uint32_t settle = 5000;
+static const uint32_t bound = 10000;
+static const uint32_t startDelay = 100000;
+
+static const uint32_t frame = 1000000 / 209;
+static const uint8_t address = 0xB0 >> 1;
+
+// The register writes begin() tried, in order, whether the sensor took them or not
+static std::vector<TwoWire::Transaction_s> Writes(const TwoWire &wire)
+{
+    std::vector<TwoWire::Transaction_s> writes;
+    for(const TwoWire::Transaction_s &t : wire.log) {
+        if(t.address == address && t.bytes.size() == 2) {
+            writes.push_back(t);
+        }
+    }
+    return writes;
+}
+
+typedef struct Boot_s {
+    uint32_t begin;             // us begin() took
+    uint32_t minGap, maxGap;    // us between one register write finishing & the next starting
+    uint32_t firstFrame;        // us from begin() starting to the first frame accepted, 0 if none in a second
+    uint32_t nacks;
+    uint32_t lost;              // register writes the sensor NACKed
+} Boot_t;
+
+static Boot_t Boot(uint32_t busy)
+{
+    TwoWire wire;
+    wire.busyAfterWrite = busy;
+    // header, one point at (512, 384) & the rest not seen
+    wire.reply = {0x00, 0x00, 0x80, 0x6C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    DFRobotIRPositionEx camera(wire);
+    Boot_t boot = {0, 0xFFFFFFFF, 0, 0, 0, 0};
+
+    HostMicros() = 1000000;
+    uint32_t start = HostMicros();
+    camera.begin(400000, DFRobotIRPositionEx::DataFormat_Basic, DFRobotIRPositionEx::Sensitivity_Default);
+    boot.begin = HostMicros() - start;
+
+    std::vector<TwoWire::Transaction_s> writes = Writes(wire);
+    CHECK_EQ(writes.size(), 6);
+    if(writes.size() == 6) {
+        const uint8_t regs[6] = {0x30, 0x06, 0x08, 0x1A, 0x33, 0x30};
+        for(size_t i = 0; i < 6; i++) {
+            CHECK_EQ(writes[i].bytes[0], regs[i]);
+        }
+        CHECK_EQ(writes[0].bytes[1], 0x01);
+        CHECK_EQ(writes[5].bytes[1], 0x08);
+    }
+    for(size_t i = 1; i < writes.size(); i++) {
+        uint32_t gap = writes[i].start - (writes[i - 1].start + writes[i - 1].duration);
+        boot.minGap = gap < boot.minGap ? gap : boot.minGap;
+        boot.maxGap = gap > boot.maxGap ? gap : boot.maxGap;
+    }
+    for(const TwoWire::Transaction_s &t : writes) {
+        boot.lost += !t.acked;
+    }
+    boot.nacks = wire.nacks;
+
+    // then the run loop's reads, a frame at a time
+    for(uint32_t at = HostMicros(); at - start < 1000000; at += frame) {
+        HostMicros() = at;
+        if(camera.basicAtomic(DFRobotIRPositionEx::Retry_2) == DFRobotIRPositionEx::Error_Success) {
+            boot.firstFrame = HostMicros() - start;
+            CHECK_EQ(camera.xPositions()[0], 512);
+            CHECK_EQ(camera.yPositions()[0], 384);
+            CHECK_EQ(camera.seen(), 0x01);
+            break;
+        }
+    }
+    return boot;
+}
+
+// A sensor that's ready again as soon as the write's done still gets the settle time between writes
+static void TestQuickSensor()
+{
+    Boot_t boot = Boot(0);
+    printf("quick sensor: begin() %.1fms, writes %.1f-%.1fms apart, first frame at %.1fms\n", boot.begin / 1000.0,
+           boot.minGap / 1000.0, boot.maxGap / 1000.0, boot.firstFrame / 1000.0);
+    CHECK(boot.minGap >= settle);
+    CHECK(boot.maxGap <= settle + 1000);
+    CHECK_EQ(boot.nacks, 0);
+    CHECK_EQ(boot.lost, 0);
+    // no frame's taken before the camera's had its start delay, and the first one after is
+    CHECK(boot.firstFrame >= boot.begin + startDelay);
+    CHECK(boot.firstFrame <= boot.begin + startDelay + frame + 1000);
+    CHECK(boot.firstFrame < 150000);
+}
+
+// One that NACKs for longer than the settle time is polled until it ACKs, but no longer than the old delay
+static void TestBusySensor()
+{
+    for(uint32_t busy : {7000u, 8000u}) {
+        Boot_t boot = Boot(busy);
+        printf("sensor busy %.1fms after a write: begin() %.1fms, writes %.1f-%.1fms apart, %u NACKs, first frame "
+               "at %.1fms\n", busy / 1000.0, boot.begin / 1000.0, boot.minGap / 1000.0, boot.maxGap / 1000.0,
+               boot.nacks, boot.firstFrame / 1000.0);
+        CHECK(boot.minGap >= busy);
+        CHECK(boot.maxGap <= busy + 100);
+        CHECK(boot.nacks > 0);
+        CHECK_EQ(boot.lost, 0);
+        CHECK(boot.firstFrame > 0);
+        CHECK(boot.firstFrame < 150000);
+    }
+}
+
+// One that never answers again holds each write up for the old delay at most, a millis() tick either way
+static void TestDeadSensor()
+{
+    Boot_t boot = Boot(1000000);
+    printf("dead sensor: begin() %.1fms, writes tried %.1f-%.1fms apart\n", boot.begin / 1000.0, boot.minGap / 1000.0,
+           boot.maxGap / 1000.0);
+    CHECK(boot.minGap >= bound - 1000);
+    CHECK(boot.maxGap <= bound + 1000);
+    CHECK_EQ(boot.lost, 5);
+    CHECK(boot.begin <= 5 * (bound + 1000) + 1000);
+    CHECK_EQ(boot.firstFrame, 0);
+}
+
+int main()
+{
+    TestQuickSensor();
+    TestBusySensor();
+    TestDeadSensor();
+    return HOSTTEST_RESULT();
+}
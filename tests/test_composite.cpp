@@ -0,0 +1,270 @@
+// Parses the composite HID report descriptor the way a host's HID parser would, and checks every field it
+// describes lands exactly where compositeReport_s packs it, with the right size, range & sign.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "HostTest.h"
+#include "TinyUSB_Composite.h"
+
+#define HID_REPORT_ID(x) 0x85, x,
+
+static const uint8_t descriptor[] = { TUD_HID_REPORT_DESC_COMPOSITE(HID_REPORT_ID(4)) };
+
+// One Input item's worth of report fields
+struct Field {
+    uint16_t page;
+    std::vector<uint16_t> usages;   // as listed; empty for constants
+    uint16_t usageMin, usageMax;
+    uint32_t bitOffset;
+    uint8_t size;
+    uint8_t count;
+    int32_t logicalMin, logicalMax;
+    uint8_t flags;                  // Input item data: bit 0 constant, bit 1 variable, bit 6 null state
+};
+
+struct Parsed {
+    std::vector<Field> fields;
+    uint8_t reportId = 0;
+    uint32_t bits = 0;
+    int depth = 0, maxDepth = 0;
+    bool ok = true;
+};
+
+// Short items only, which is all a boot-style descriptor like this one uses
+static Parsed Parse(const uint8_t *d, size_t length)
+{
+    Parsed p;
+    uint16_t page = 0;
+    int32_t logicalMin = 0, logicalMax = 0;
+    uint8_t size = 0, count = 0;
+    std::vector<uint16_t> usages;
+    uint16_t usageMin = 0, usageMax = 0;
+
+    size_t i = 0;
+    while(i < length) {
+        uint8_t prefix = d[i++];
+        uint8_t n = prefix & 3;
+        if(n == 3) {
+            n = 4;
+        }
+        if(i + n > length) {
+            p.ok = false;
+            break;
+        }
+        uint32_t u = 0;
+        for(uint8_t b = 0; b < n; b++) {
+            u |= (uint32_t)d[i + b] << (8 * b);
+        }
+        // signed view, for logical/physical minimums
+        int32_t s = n == 1 ? (int8_t)u : n == 2 ? (int16_t)u : (int32_t)u;
+        i += n;
+
+        switch(prefix & 0xFC) {
+        case 0x04: page = u; break;                         // Usage Page
+        case 0x14: logicalMin = s; break;                   // Logical Minimum
+        case 0x24: logicalMax = (logicalMin < 0) ? s : (int32_t)u; break;  // Logical Maximum
+        case 0x74: size = u; break;                         // Report Size
+        case 0x94: count = u; break;                        // Report Count
+        case 0x84: p.reportId = u; break;                   // Report ID
+        case 0x34: case 0x44: break;                        // Physical Min/Max
+        case 0x08: usages.push_back(u); break;              // Usage
+        case 0x18: usageMin = u; break;                     // Usage Minimum
+        case 0x28: usageMax = u; break;                     // Usage Maximum
+        case 0xA0:                                          // Collection
+            p.maxDepth = ++p.depth > p.maxDepth ? p.depth : p.maxDepth;
+            usages.clear();
+            break;
+        case 0xC0:                                          // End Collection
+            if(--p.depth < 0) {
+                p.ok = false;
+            }
+            break;
+        case 0x80:                                          // Input
+        {
+            Field f;
+            f.page = page;
+            f.usages = usages;
+            f.usageMin = usageMin;
+            f.usageMax = usageMax;
+            f.bitOffset = p.bits;
+            f.size = size;
+            f.count = count;
+            f.logicalMin = logicalMin;
+            f.logicalMax = logicalMax;
+            f.flags = u;
+            p.fields.push_back(f);
+            p.bits += (uint32_t)size * count;
+            // locals don't carry over to the next main item
+            usages.clear();
+            usageMin = usageMax = 0;
+            break;
+        }
+        default:
+            p.ok = false;
+            break;
+        }
+    }
+    return p;
+}
+
+// Pulls a little-endian bit field out of a report, the way the host would
+static uint32_t Extract(const uint8_t *report, uint32_t bitOffset, uint8_t size)
+{
+    uint32_t v = 0;
+    for(uint8_t b = 0; b < size; b++) {
+        uint32_t bit = bitOffset + b;
+        v |= (uint32_t)((report[bit / 8] >> (bit % 8)) & 1) << b;
+    }
+    return v;
+}
+
+static void TestDescriptor()
+{
+    Parsed p = Parse(descriptor, sizeof(descriptor));
+    CHECK(p.ok);
+    CHECK_EQ(p.depth, 0);
+    CHECK_EQ(p.maxDepth, 2);
+    CHECK_EQ(p.reportId, 4);
+    // the report ID goes right after the application collection opens
+    CHECK_EQ(descriptor[6], 0x85);
+    // the descriptor describes exactly the struct, bit for bit
+    CHECK_EQ(p.bits, sizeof(compositeReport_s) * 8);
+    CHECK_EQ(sizeof(compositeReport_s), 24);
+
+    // mouse buttons, padding, absolute X/Y
+    CHECK_EQ(p.fields.size(), 9);
+    const Field &buttons = p.fields[0];
+    CHECK_EQ(buttons.page, 0x09);
+    CHECK_EQ(buttons.usageMin, 1);
+    CHECK_EQ(buttons.usageMax, 5);
+    CHECK_EQ(buttons.bitOffset, offsetof(compositeReport_s, mouseButtons) * 8);
+    CHECK_EQ(buttons.size * buttons.count, 5);
+    CHECK_EQ(p.fields[1].flags & 1, 1);
+    CHECK_EQ(p.fields[1].size * p.fields[1].count, 3);
+
+    const Field &mouse = p.fields[2];
+    CHECK_EQ(mouse.page, 0x01);
+    CHECK_EQ(mouse.usages.size(), 2);
+    CHECK_EQ(mouse.usages[0], 0x30);
+    CHECK_EQ(mouse.usages[1], 0x31);
+    CHECK_EQ(mouse.bitOffset, offsetof(compositeReport_s, mouseX) * 8);
+    CHECK_EQ(mouse.size, 16);
+    CHECK_EQ(mouse.count, 2);
+    CHECK_EQ(mouse.logicalMin, 0);
+    CHECK_EQ(mouse.logicalMax, 32767);
+
+    // keyboard modifiers, reserved, 6-key array
+    CHECK_EQ(p.fields[3].page, 0x07);
+    CHECK_EQ(p.fields[3].usageMin, 0xE0);
+    CHECK_EQ(p.fields[3].bitOffset, offsetof(compositeReport_s, keyModifiers) * 8);
+    CHECK_EQ(p.fields[4].bitOffset, offsetof(compositeReport_s, keyReserved) * 8);
+    CHECK_EQ(p.fields[4].flags & 1, 1);
+    const Field &keys = p.fields[5];
+    CHECK_EQ(keys.bitOffset, offsetof(compositeReport_s, keys) * 8);
+    CHECK_EQ(keys.count, 6);
+    CHECK_EQ(keys.flags & 2, 0);    // array, not variable
+    CHECK_EQ(keys.logicalMax, 255);
+
+    // gamepad axes, hat, buttons
+    const Field &axes = p.fields[6];
+    CHECK_EQ(axes.bitOffset, offsetof(compositeReport_s, padX) * 8);
+    CHECK_EQ(axes.usages.size(), 4);
+    CHECK_EQ(axes.usages[2], 0x33);
+    CHECK_EQ(axes.usages[3], 0x34);
+    CHECK_EQ(axes.logicalMin, -32767);
+    CHECK_EQ(axes.logicalMax, 32767);
+    const Field &hat = p.fields[7];
+    CHECK_EQ(hat.bitOffset, offsetof(compositeReport_s, padHat) * 8);
+    CHECK_EQ(hat.usages[0], 0x39);
+    CHECK_EQ(hat.logicalMin, 1);
+    CHECK_EQ(hat.logicalMax, 8);
+    CHECK(hat.flags & 0x40);
+    const Field &padButtons = p.fields[8];
+    CHECK_EQ(padButtons.bitOffset, offsetof(compositeReport_s, padButtons) * 8);
+    CHECK_EQ(padButtons.usageMax, 16);
+    CHECK_EQ(padButtons.size * padButtons.count, 16);
+}
+
+// Packs a set of values, then reads every field back out through the descriptor
+static void TestPacking()
+{
+    Parsed p = Parse(descriptor, sizeof(descriptor));
+    uint32_t seed = 3;
+    auto rnd = [&seed]() { seed = seed * 1103515245 + 12345; return seed >> 8; };
+
+    for(int round = 0; round < 1000; round++) {
+        uint8_t mouseButtons = rnd() & 0x1F;
+        uint16_t x = rnd() % 32768, y = rnd() % 32768;
+        uint8_t modifiers = rnd();
+        uint8_t keys[6];
+        for(uint8_t &k : keys) {
+            k = rnd();
+        }
+        int16_t axes[4];
+        for(int16_t &a : axes) {
+            a = (int16_t)(rnd() % 65535) - 32767;
+        }
+        uint8_t hat = rnd() % 9;
+        uint16_t padButtons = rnd();
+
+        compositeReport_s r;
+        memset(&r, 0xAA, sizeof(r));
+        Composite_::packMouse(r, mouseButtons, x, y);
+        Composite_::packKeys(r, modifiers, keys);
+        Composite_::packPad(r, axes[0], axes[1], axes[2], axes[3], hat, padButtons);
+        const uint8_t *bytes = (const uint8_t*)&r;
+
+        CHECK_EQ(Extract(bytes, p.fields[0].bitOffset, 5), mouseButtons);
+        CHECK_EQ(Extract(bytes, p.fields[2].bitOffset, 16), x);
+        CHECK_EQ(Extract(bytes, p.fields[2].bitOffset + 16, 16), y);
+        CHECK_EQ(Extract(bytes, p.fields[3].bitOffset, 8), modifiers);
+        CHECK_EQ(Extract(bytes, p.fields[4].bitOffset, 8), 0);
+        for(int k = 0; k < 6; k++) {
+            CHECK_EQ(Extract(bytes, p.fields[5].bitOffset + k * 8, 8), keys[k]);
+        }
+        for(int a = 0; a < 4; a++) {
+            CHECK_EQ((int16_t)Extract(bytes, p.fields[6].bitOffset + a * 16, 16), axes[a]);
+        }
+        CHECK_EQ(Extract(bytes, p.fields[7].bitOffset, 8), hat);
+        CHECK_EQ(Extract(bytes, p.fields[8].bitOffset, 16), padButtons);
+        if(HostTestFailures()) {
+            break;
+        }
+    }
+}
+
+static void TestChanged()
+{
+    Composite_ composite;
+    compositeReport_s r = {};
+    uint8_t keys[6] = {};
+    Composite_::packMouse(r, 0, 100, 200);
+    Composite_::packKeys(r, 0, keys);
+    Composite_::packPad(r, 0, 0, 0, 0, 0, 0);
+
+    // the first report always goes out, then only changes do
+    CHECK(composite.changed(r));
+    composite.sent(r);
+    CHECK(!composite.changed(r));
+    compositeReport_s next = r;
+    Composite_::packMouse(next, 1, 100, 200);
+    CHECK(composite.changed(next));
+    composite.sent(next);
+    CHECK(!composite.changed(next));
+    next.padButtons ^= 0x8000;
+    CHECK(composite.changed(next));
+
+    // after a reset (e.g. switching composite back on), the same report goes out again
+    composite.sent(next);
+    composite.reset();
+    CHECK(composite.changed(next));
+}
+
+int main()
+{
+    TestDescriptor();
+    TestPacking();
+    TestChanged();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,302 @@
+// The second core's loop run on Dispatcher through simulated button traffic: bouncing trigger presses, long idle
+// stretches & the core being held up, with one button modelled the way LightgunButtons debounces it (32 sample
+// FIFO, 15ms lockout after a change). Checks no change is missed or late against polling flat out, the tick stays
+// on 1ms without bursting, and how much less often the core's woken. The calls made are then replayed back to back
+// through Next() to time it per event.
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include "HostTest.h"
+#include "OpenFIREDispatch.h"
+
+// Rough costs on the RP2040 at 133MHz, in microseconds: waking from __wfe, a button poll, the tick's timed work
+static const uint32_t costWake = 1;
+static const uint32_t costPoll = 4;
+static const uint32_t costTick = 12;
+
+// One pin, debounced as LightgunButtons::Poll() does it
+typedef struct Button_s {
+    uint32_t fifo = 0xFFFFFFFF;
+    uint32_t lockout = 0;       // ms left before the pin's read again
+    uint32_t lastMs = 0;
+    bool pressed = false;
+
+    bool Settled() const { return fifo == 0 || fifo == 0xFFFFFFFF; }
+
+    // true if the debounced state changed
+    bool Poll(uint32_t now, bool pin)
+    {
+        uint32_t ms = now / 1000, ticks = ms - lastMs;
+        lastMs = ms;
+        if(lockout) {
+            lockout = ticks < lockout ? lockout - ticks : 0;
+            if(lockout) {
+                return false;
+            }
+        }
+        fifo = (fifo << 1) | pin;
+        if(!Settled() || (fifo == 0) == pressed) {
+            return false;
+        }
+        pressed = fifo == 0;
+        lockout = 15;
+        return true;
+    }
+} Button_t;
+
+typedef struct Edge_s {
+    uint32_t at;                // us
+    bool level;                 // pin level after; low is pressed
+    bool first;                 // the start of a press or release, rather than bounce
+} Edge_t;
+
+// A trigger pulled every 100ms & held 40ms, with contact bounce on the press & the release
+static std::vector<Edge_t> BouncyTrigger(uint32_t until)
+{
+    std::vector<Edge_t> edges;
+    for(uint32_t t = 10000; t + 100000 <= until; t += 100000) {
+        for(uint32_t b = 0; b < 6; b++) {
+            edges.push_back({t + b * 300, (b & 1) != 0, b == 0});
+        }
+        edges.push_back({t + 1800, false, false});
+        for(uint32_t b = 0; b < 4; b++) {
+            edges.push_back({t + 40000 + b * 300, (b & 1) == 0, b == 0});
+        }
+        edges.push_back({t + 41200, true, false});
+    }
+    return edges;
+}
+
+// What Next() was called with, to replay
+typedef struct Call_s {
+    uint32_t now;
+    uint32_t edges;
+    bool settled;
+    uint8_t work;
+} Call_t;
+
+typedef struct Run_s {
+    uint32_t passes, polls, ticks, sleeps;
+    uint32_t busy;              // us the core spent working, at the costs above
+    uint32_t changes;           // debounced presses & releases
+    double meanLag, worstLag;   // ms from a press or release starting to it being debounced
+    uint32_t worstTickGap;      // us between ticks
+    std::vector<Call_t> calls;
+} Run_t;
+
+// Runs the loop for `until` us; `stall` holds the core up (a flash write, say) for a while at a time
+static Run_t RunLoop(const std::vector<Edge_t> &edges, uint32_t until, uint32_t stallAt = 0, uint32_t stall = 0)
+{
+    Dispatcher dispatch;
+    Button_t button;
+    Run_t run = {};
+    bool pin = true;
+    size_t next = 0;
+    uint32_t pending = 0, now = 0, lastTick = 0, started = 0;
+    double lagSum = 0.0;
+    dispatch.Reset(0);
+
+    while(now < until) {
+        while(next < edges.size() && edges[next].at <= now) {
+            if(pin != edges[next].level) {
+                pin = edges[next].level;
+                // the pin's interrupt
+                pending++;
+            }
+            if(edges[next].first) {
+                started = edges[next].at;
+            }
+            next++;
+        }
+        if(stall && now >= stallAt) {
+            now += stall;
+            stall = 0;
+            continue;
+        }
+
+        uint8_t work = dispatch.Next(now, pending, button.Settled());
+        run.calls.push_back({now, pending, button.Settled(), work});
+        pending = 0;
+        if(!work) {
+            // sleep until the pin's interrupt or the tick
+            uint32_t wake = now + dispatch.Remaining(now);
+            if(next < edges.size() && edges[next].at < wake) {
+                wake = edges[next].at;
+            }
+            now = (wake > now ? wake : now) + costWake;
+            run.sleeps++;
+            run.busy += costWake;
+            continue;
+        }
+
+        run.passes++;
+        uint32_t cost = 0;
+        if(work & Dispatcher::Work_Buttons) {
+            run.polls++;
+            cost += costPoll;
+            if(button.Poll(now, pin)) {
+                double lag = (now - started) / 1000.0;
+                lagSum += lag;
+                run.worstLag = lag > run.worstLag ? lag : run.worstLag;
+                run.changes++;
+            }
+        }
+        if(work & Dispatcher::Work_Tick) {
+            if(run.ticks) {
+                run.worstTickGap = now - lastTick > run.worstTickGap ? now - lastTick : run.worstTickGap;
+            }
+            lastTick = now;
+            run.ticks++;
+            cost += costTick;
+        }
+        run.busy += cost;
+        now += cost;
+    }
+    run.meanLag = run.changes ? lagSum / run.changes : 0.0;
+    return run;
+}
+
+// The loop as it was: poll the buttons & do the timed work back to back, as fast as the core goes
+static Run_t RunFlatOut(const std::vector<Edge_t> &edges, uint32_t until)
+{
+    Button_t button;
+    Run_t run = {};
+    bool pin = true;
+    size_t next = 0;
+    uint32_t started = 0;
+    double lagSum = 0.0;
+    for(uint32_t now = 0; now < until; now += costPoll + 3) {
+        while(next < edges.size() && edges[next].at <= now) {
+            pin = edges[next].level;
+            if(edges[next].first) {
+                started = edges[next].at;
+            }
+            next++;
+        }
+        run.passes++;
+        if(button.Poll(now, pin)) {
+            double lag = (now - started) / 1000.0;
+            lagSum += lag;
+            run.worstLag = lag > run.worstLag ? lag : run.worstLag;
+            run.changes++;
+        }
+    }
+    run.busy = until;
+    run.meanLag = run.changes ? lagSum / run.changes : 0.0;
+    return run;
+}
+
+static void TestBouncyTrigger()
+{
+    const uint32_t until = 2000000;
+    std::vector<Edge_t> edges = BouncyTrigger(until);
+    Run_t run = RunLoop(edges, until);
+    Run_t flat = RunFlatOut(edges, until);
+    printf("events: %u passes (%u polls, %u ticks), %u sleeps, core busy %.1f%%; debounced %.2fms late (mean), "
+           "%.2fms (worst)\n", run.passes, run.polls, run.ticks, run.sleeps, run.busy * 100.0 / until,
+           run.meanLag, run.worstLag);
+    printf("flat out: %u passes, core busy 100%%; debounced %.2fms late (mean), %.2fms (worst)\n",
+           flat.passes, flat.meanLag, flat.worstLag);
+
+    // every press & release gets through, no later than polling flat out would have it, give or take a poll
+    CHECK_EQ(run.changes, 2 * (until / 100000 - 1));
+    CHECK_EQ(run.changes, flat.changes);
+    CHECK(run.worstLag <= flat.worstLag + 0.1);
+    // a tick every ms, none skipped & none doubled up
+    CHECK_NEAR(run.ticks, until / DISPATCH_TICK, 1);
+    CHECK(run.worstTickGap <= DISPATCH_TICK + costTick + costPoll);
+    // and nearly all of the time asleep
+    CHECK(run.passes * 20 < flat.passes);
+    CHECK(run.busy * 20 < until);
+}
+
+// Nothing happening: one pass a tick, and nothing in between
+static void TestIdle()
+{
+    Run_t run = RunLoop({}, 1000000);
+    CHECK_NEAR(run.ticks, 1000, 1);
+    CHECK_EQ(run.passes, run.ticks);
+    CHECK_EQ(run.polls, run.ticks);
+    CHECK_EQ(run.changes, 0);
+}
+
+// Held up for a while, it picks up with one tick rather than a burst to catch up, then keeps to 1ms again
+static void TestStall()
+{
+    Run_t run = RunLoop({}, 100000, 50000, 7300);
+    uint32_t burst = 0, after = 0, lastTick = 0;
+    for(const Call_t &c : run.calls) {
+        if(!(c.work & Dispatcher::Work_Tick)) {
+            continue;
+        }
+        if(c.now >= 57300 && c.now < 57300 + DISPATCH_TICK) {
+            burst++;
+        }
+        if(c.now > 57300 + DISPATCH_TICK) {
+            uint32_t gap = c.now - lastTick;
+            after = gap > after ? gap : after;
+        }
+        lastTick = c.now;
+    }
+    CHECK_EQ(burst, 1);
+    CHECK(after <= DISPATCH_TICK + costWake + costTick);
+    CHECK_NEAR(run.ticks, 100 - 7, 1);
+}
+
+static void TestNext()
+{
+    Dispatcher dispatch;
+    dispatch.Reset(5000);
+    CHECK_EQ(dispatch.Remaining(5000), DISPATCH_TICK);
+    CHECK_EQ(dispatch.Next(5000, 0, true), 0);
+    // an edge or a button mid-change gets the buttons polled right away, without the timed work
+    CHECK_EQ(dispatch.Next(5100, 1, true), Dispatcher::Work_Buttons);
+    CHECK_EQ(dispatch.Next(5200, 0, false), Dispatcher::Work_Buttons);
+    CHECK_EQ(dispatch.Remaining(5200), 800);
+    // the tick polls the buttons too
+    CHECK_EQ(dispatch.Next(6000, 0, true), Dispatcher::Work_Tick | Dispatcher::Work_Buttons);
+    CHECK_EQ(dispatch.Remaining(6000), DISPATCH_TICK);
+    // a tick that's a bit late doesn't push the next one back
+    CHECK_EQ(dispatch.Next(7300, 0, true), Dispatcher::Work_Tick | Dispatcher::Work_Buttons);
+    CHECK_EQ(dispatch.Remaining(7300), 700);
+    CHECK_EQ(dispatch.Next(7999, 0, true), 0);
+    // micros() wrapping around
+    dispatch.Reset(0xFFFFFFFF - 200);
+    CHECK_EQ(dispatch.Next(0xFFFFFFFF, 0, true), 0);
+    CHECK_EQ(dispatch.Remaining(0xFFFFFFFF), DISPATCH_TICK - 200);
+    CHECK_EQ(dispatch.Next(DISPATCH_TICK - 201, 0, true), Dispatcher::Work_Tick | Dispatcher::Work_Buttons);
+}
+
+// The bouncy trigger's calls, replayed through a fresh Dispatcher as fast as it'll take them
+static void TestReplayCost()
+{
+    Run_t run = RunLoop(BouncyTrigger(2000000), 2000000);
+    const int repeats = 200;
+    uint32_t mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < repeats; r++) {
+        Dispatcher dispatch;
+        dispatch.Reset(0);
+        for(const Call_t &c : run.calls) {
+            uint8_t work = dispatch.Next(c.now, c.edges, c.settled);
+            mismatches += work != c.work;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double perCall = ns / ((double)repeats * run.calls.size());
+    printf("replay: %zu calls, %.1fns each on this host\n", run.calls.size(), perCall);
+    // the same calls get the same answers
+    CHECK_EQ(mismatches, 0);
+    // it's a few compares; anything near a microsecond would be a problem on the RP2040's 1ms tick
+    CHECK(perCall < 1000.0);
+}
+
+int main()
+{
+    TestNext();
+    TestBouncyTrigger();
+    TestIdle();
+    TestStall();
+    TestReplayCost();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,157 @@
+// Checks the page-format glyph atlas draws exactly what the GFX drawBitmap() path did:
+// glyph by glyph at every row alignment & clipped at the edges, then whole HUD layouts
+// against the drawBitmap() sequences PrintAmmo()/PrintLife() used before the atlas.
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "HostTest.h"
+// the glyphs & BlitGlyph() are private; SamcoDisplay.cpp itself is built as-is
+#define private public
+#include "SamcoDisplay.h"
+#undef private
+#include "SamcoPreferences.h"
+
+SamcoPreferences::PinsMap_t SamcoPreferences::pins;
+extern Adafruit_SSD1306 *display;
+
+static Adafruit_SSD1306 ref(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+static const size_t bufferSize = SCREEN_WIDTH * SCREEN_HEIGHT / 8;
+
+static const uint8_t *numberBitmaps[10] = {
+    ExtDisplay::number_0, ExtDisplay::number_1, ExtDisplay::number_2, ExtDisplay::number_3, ExtDisplay::number_4,
+    ExtDisplay::number_5, ExtDisplay::number_6, ExtDisplay::number_7, ExtDisplay::number_8, ExtDisplay::number_9
+};
+
+static bool SameAsRef() { return !memcmp(display->getBuffer(), ref.getBuffer(), bufferSize); }
+static void SyncRef() { memcpy(ref.getBuffer(), display->getBuffer(), bufferSize); }
+
+static void TestGlyphs(ExtDisplay &oled)
+{
+    // every row alignment, plus clipping off each edge
+    const int16_t xs[] = { -7, 0, 3, 50, 118 };
+    const int16_t ys[] = { -9, 0, 1, 2, 3, 4, 5, 6, 7, 13, 22, 41, 55 };
+    int mismatches = 0;
+    for(int16_t x : xs) {
+        for(int16_t y : ys) {
+            for(int n = 0; n < 10; n++) {
+                // over a busy background, since both paths OR set bits in & leave the rest alone
+                memset(display->getBuffer(), 0xA5, bufferSize);
+                SyncRef();
+                oled.BlitGlyph(x, y, &ExtDisplay::numberAtlas[n].data[0][0], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT);
+                ref.drawBitmap(x, y, numberBitmaps[n], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
+                mismatches += !SameAsRef();
+            }
+            memset(display->getBuffer(), 0, bufferSize);
+            SyncRef();
+            oled.BlitGlyph(x, y, &ExtDisplay::lifeIcoSmallPage.data[0][0], HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT);
+            oled.BlitGlyph(x + 5, y + 3, &ExtDisplay::lifeIcoLargePage.data[0][0], HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT);
+            ref.drawBitmap(x, y, ExtDisplay::lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
+            ref.drawBitmap(x + 5, y + 3, ExtDisplay::lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
+            mismatches += !SameAsRef();
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// PrintAmmo() before the atlas
+static void RefAmmo(uint8_t ammo, int16_t ammoX)
+{
+    uint8_t left = ammo / 10, right = ammo % 10;
+    ref.fillRect(ammoX, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
+    if(left < 10) {
+        ref.drawBitmap(ammoX, 22, numberBitmaps[left], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
+    }
+    ref.fillRect(ammoX + NUMBER_GLYPH_WIDTH + 6, 22, NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, BLACK);
+    ref.drawBitmap(ammoX + NUMBER_GLYPH_WIDTH + 6, 22, numberBitmaps[right], NUMBER_GLYPH_WIDTH, NUMBER_GLYPH_HEIGHT, WHITE);
+}
+
+static void RefHearts(int16_t x, int16_t y, int count, int spacing, bool large)
+{
+    for(int i = 0; i < count; i++) {
+        if(large) {
+            ref.drawBitmap(x + spacing * i, y, ExtDisplay::lifeIcoLarge, HEART_LARGE_WIDTH, HEART_LARGE_HEIGHT, WHITE);
+        } else {
+            ref.drawBitmap(x + spacing * i, y, ExtDisplay::lifeIcoSmall, HEART_SMALL_WIDTH, HEART_SMALL_HEIGHT, WHITE);
+        }
+    }
+}
+
+// PrintLife() hearts before the atlas, with the per-count x positions it had spelled out case by case
+static void RefLife(uint8_t life, bool dual)
+{
+    if(!dual) {
+        const int16_t bottomX[10] = { 0, 56, 48, 39, 30, 22, 56, 48, 39, 30 };
+        ref.fillRect(22, 19, HEART_LARGE_WIDTH * 5 + 4, HEART_LARGE_HEIGHT + 22 + HEART_LARGE_HEIGHT, BLACK);
+        if(life >= 10) {
+            RefHearts(22, 19, 5, HEART_LARGE_WIDTH + 1, true);
+            RefHearts(22, 41, 5, HEART_LARGE_WIDTH + 1, true);
+        } else if(life > 5) {
+            RefHearts(22, 19, 5, HEART_LARGE_WIDTH + 1, true);
+            RefHearts(bottomX[life], 41, life - 5, HEART_LARGE_WIDTH + 1, true);
+        } else if(life == 5) {
+            RefHearts(22, 30, 5, HEART_LARGE_WIDTH, true);
+        } else if(life) {
+            RefHearts(bottomX[life], 30, life, HEART_LARGE_WIDTH + 1, true);
+        }
+    } else {
+        const int16_t bottomX[10] = { 0, 25, 19, 13, 7, 1, 25, 19, 13, 7 };
+        ref.fillRect(1, 22, HEART_SMALL_WIDTH * 5, HEART_SMALL_HEIGHT + 20 + HEART_SMALL_HEIGHT, BLACK);
+        if(life >= 10) {
+            RefHearts(1, 22, 5, HEART_SMALL_WIDTH, false);
+            RefHearts(1, 42, 5, HEART_SMALL_WIDTH, false);
+        } else if(life > 5) {
+            RefHearts(1, 22, 5, HEART_SMALL_WIDTH, false);
+            RefHearts(bottomX[life], 42, life - 5, HEART_SMALL_WIDTH, false);
+        } else if(life) {
+            RefHearts(bottomX[life], 32, life, HEART_SMALL_WIDTH, false);
+        }
+    }
+}
+
+static void TestLayouts(ExtDisplay &oled)
+{
+    int mismatches = 0;
+
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Ammo;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Single);
+    for(int ammo = 0; ammo <= 255; ammo++) {
+        SyncRef();
+        oled.PrintAmmo(ammo);
+        RefAmmo(ammo, 40);
+        mismatches += !SameAsRef();
+    }
+
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Life;
+    oled.lifeBar = false;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Single);
+    for(int life = 0; life <= 12; life++) {
+        SyncRef();
+        oled.PrintLife(life);
+        RefLife(life, false);
+        mismatches += !SameAsRef();
+    }
+
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Both;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Dual);
+    for(int n = 0; n <= 120; n++) {
+        SyncRef();
+        oled.PrintAmmo(n);
+        oled.PrintLife(n % 13);
+        RefAmmo(n, 72);
+        RefLife(n % 13, true);
+        mismatches += !SameAsRef();
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+int main()
+{
+    SamcoPreferences::pins.pPeriphSDA = 4;
+    SamcoPreferences::pins.pPeriphSCL = 5;
+    ExtDisplay oled;
+    CHECK(oled.Begin());
+
+    TestGlyphs(oled);
+    TestLayouts(oled);
+
+    return HOSTTEST_RESULT();
+}
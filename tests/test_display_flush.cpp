@@ -0,0 +1,100 @@
+// Counts the bytes ExtDisplay pushes to the panel for partial HUD updates, against a full-frame display(),
+// and replays the traffic into a panel model to check it ends up showing the framebuffer.
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "HostTest.h"
+#include "SSD1306Panel.h"
+#include "SamcoDisplay.h"
+#include "SamcoPreferences.h"
+
+SamcoPreferences::PinsMap_t SamcoPreferences::pins;
+extern Adafruit_SSD1306 *display;
+
+// GDDRAM bytes (data transactions, less their control byte) in the log
+static size_t DataBytes()
+{
+    size_t total = 0;
+    for(const TwoWire::Transaction_s &t : Wire.log) {
+        if(t.address == DISPLAY_ADDRESS && !t.bytes.empty() && t.bytes[0] == 0x40) {
+            total += t.bytes.size() - 1;
+        }
+    }
+    return total;
+}
+
+static bool PanelMatches(SSD1306Panel &panel)
+{
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+    return !memcmp(panel.ram, display->getBuffer(), sizeof(panel.ram));
+}
+
+static void FlushAll(ExtDisplay &oled)
+{
+    while(oled.FlushStep(0xFFFF)) {}
+}
+
+int main()
+{
+    // I2C0 on GP4/GP5
+    SamcoPreferences::pins.pPeriphSDA = 4;
+    SamcoPreferences::pins.pPeriphSCL = 5;
+
+    ExtDisplay oled;
+    SSD1306Panel panel;
+    // panel RAM is junk at power on, so the first flush covers all of it
+    memset(panel.ram, 0x5A, sizeof(panel.ram));
+    CHECK(oled.Begin());
+    CHECK_EQ(DataBytes(), SCREEN_WIDTH * SCREEN_HEIGHT / 8);
+    CHECK(PanelMatches(panel));
+
+    // entering a Mamehook layout redraws everything under the top bar: pages 2-7
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Ammo;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Single);
+    CHECK_EQ(DataBytes(), SCREEN_WIDTH * 6);
+    CHECK(PanelMatches(panel));
+
+    // an ammo change only touches the two digit cells: x 40-87, y 22-57 (pages 2-7)
+    oled.UpdateHUD(12, 0);
+    FlushAll(oled);
+    const size_t ammoBytes = (NUMBER_GLYPH_WIDTH * 2 + 6) * 6;
+    CHECK_EQ(DataBytes(), ammoBytes);
+    CHECK(PanelMatches(panel));
+
+    // the same count again sends nothing at all
+    oled.UpdateHUD(12, 0);
+    FlushAll(oled);
+    CHECK_EQ(Wire.log.size(), 0);
+
+    // a life change while the layout only shows ammo isn't drawn either
+    oled.UpdateHUD(12, 3);
+    FlushAll(oled);
+    CHECK_EQ(Wire.log.size(), 0);
+
+    // dual layout: small hearts at x 1-60, y 22-57
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Both;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Dual);
+    CHECK(PanelMatches(panel));
+    oled.UpdateHUD(12, 7);
+    FlushAll(oled);
+    const size_t lifeBytes = HEART_SMALL_WIDTH * 5 * 6;
+    CHECK_EQ(DataBytes(), lifeBytes);
+    CHECK(PanelMatches(panel));
+
+    // against what the stock full-frame display() sends for the same change
+    oled.UpdateHUD(13, 7);
+    FlushAll(oled);
+    size_t partial = DataBytes();
+    size_t partialWire = Wire.BytesTo(DISPLAY_ADDRESS);
+    CHECK(PanelMatches(panel));
+    display->display();
+    size_t full = DataBytes();
+    size_t fullWire = Wire.BytesTo(DISPLAY_ADDRESS);
+    CHECK(PanelMatches(panel));
+    CHECK_EQ(full, SCREEN_WIDTH * SCREEN_HEIGHT / 8);
+    printf("ammo change: %zu GDDRAM bytes (%zu on the wire) vs %zu (%zu) for display(); %.0f%% less\n",
+           partial, partialWire, full, fullWire, 100.0 - partialWire * 100.0 / fullWire);
+    CHECK(partialWire * 3 < fullWire);
+
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,101 @@
+// Drives bursts of Mamehook ammo/life updates through PostHUD()/HUDStep() as the two cores would,
+// and checks how many redraws they cost & that the panel ends up on the last counts.
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "HostTest.h"
+#include "SSD1306Panel.h"
+#include "SamcoDisplay.h"
+#include "SamcoPreferences.h"
+
+SamcoPreferences::PinsMap_t SamcoPreferences::pins;
+extern Adafruit_SSD1306 *display;
+
+static const size_t bufferSize = SCREEN_WIDTH * SCREEN_HEIGHT / 8;
+
+// Flushes everything, without charging the bus time to the clock (that's test_display_timeline's job)
+static void FlushAll(ExtDisplay &oled)
+{
+    uint32_t now = HostMicros();
+    while(oled.FlushStep(0xFFFF)) {}
+    HostMicros() = now;
+}
+
+// Runs the main loop's side for a while: a HUD step every millisecond, flushing as it goes
+static uint32_t RunFor(ExtDisplay &oled, uint32_t ms)
+{
+    uint32_t redraws = 0;
+    for(uint32_t i = 0; i < ms; i++) {
+        redraws += oled.HUDStep(millis());
+        FlushAll(oled);
+        HostMicros() += 1000;
+    }
+    return redraws;
+}
+
+// Whether what's on screen is what a direct draw of these counts would give
+static bool Shows(ExtDisplay &oled, uint8_t ammo, uint8_t life)
+{
+    uint8_t before[bufferSize];
+    memcpy(before, display->getBuffer(), bufferSize);
+    oled.PrintAmmo(ammo);
+    oled.PrintLife(life);
+    bool same = !memcmp(before, display->getBuffer(), bufferSize);
+    FlushAll(oled);
+    return same;
+}
+
+int main()
+{
+    SamcoPreferences::pins.pPeriphSDA = 4;
+    SamcoPreferences::pins.pPeriphSCL = 5;
+    ExtDisplay oled;
+    SSD1306Panel panel;
+    CHECK(oled.Begin());
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Both;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Dual);
+    HostMicros() = 1000000;
+
+    // nothing posted, nothing drawn
+    CHECK_EQ(RunFor(oled, 200), 0);
+
+    // a game spamming a new count every millisecond for a second: one redraw per interval at most
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+    uint32_t redraws = 0;
+    for(uint32_t i = 0; i < 1000; i++) {
+        oled.PostHUD(99 - i % 100, i % 11);
+        redraws += RunFor(oled, 1);
+    }
+    // and the last of the burst shows up one interval later at the latest
+    redraws += RunFor(oled, HUD_REDRAW_INTERVAL);
+    printf("1000 updates over 1 s: %u redraws, %zu bytes to the panel\n", redraws, Wire.BytesTo(DISPLAY_ADDRESS));
+    CHECK(redraws <= 1000 / HUD_REDRAW_INTERVAL + 2);
+    CHECK(redraws >= 1000 / HUD_REDRAW_INTERVAL - 1);
+    CHECK(Shows(oled, 99 - 999 % 100, 999 % 11));
+
+    // the same counts over & over: HUDStep() runs, but nothing's drawn or sent
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+    for(uint32_t i = 0; i < 500; i++) {
+        oled.PostHUD(99 - 999 % 100, 999 % 11);
+        RunFor(oled, 1);
+    }
+    CHECK_EQ(Wire.log.size(), 0);
+
+    // a count posted right after a redraw isn't lost: it goes out as soon as the interval's up
+    RunFor(oled, HUD_REDRAW_INTERVAL * 2);
+    oled.PostHUD(42, 3);
+    CHECK(oled.HUDStep(millis()));
+    oled.PostHUD(43, 3);
+    CHECK(!oled.HUDStep(millis()));
+    CHECK_EQ(RunFor(oled, HUD_REDRAW_INTERVAL), 0);
+    CHECK_EQ(RunFor(oled, 1), 1);
+    CHECK(Shows(oled, 43, 3));
+
+    // and the panel itself matches
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+    CHECK(!memcmp(panel.ram, display->getBuffer(), bufferSize));
+
+    return HOSTTEST_RESULT();
+}
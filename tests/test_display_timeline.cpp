@@ -0,0 +1,140 @@
+// Runs ExtDisplay::FlushStep() on a simulated bus timeline at the camera's frame rate:
+// every flush has to end before the next camera read is due, and HUD changes still have to land.
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include "HostTest.h"
+#include "SSD1306Panel.h"
+#include "SamcoDisplay.h"
+#include "SamcoPreferences.h"
+
+SamcoPreferences::PinsMap_t SamcoPreferences::pins;
+extern Adafruit_SSD1306 *display;
+
+#define CAMERA_HZ 209
+#define FRAME_PERIOD (1000000 / CAMERA_HZ)
+
+// Wire's own time per transaction on the RP2040, on top of the bus, in microseconds
+#define WIRE_CPU_OVERHEAD 15
+
+static uint32_t rng = 12345;
+static uint32_t Random(uint32_t range)
+{
+    rng = rng * 1103515245 + 12345;
+    return (rng >> 16) % range;
+}
+
+static void TestBudget()
+{
+    CHECK_EQ(ExtDisplay::FlushBudget(1000, 1000 + FRAME_PERIOD), FRAME_PERIOD - DISPLAY_FLUSH_MARGIN);
+    CHECK_EQ(ExtDisplay::FlushBudget(1000, 1000 + DISPLAY_FLUSH_MARGIN), 0);
+    // frame already overran
+    CHECK_EQ(ExtDisplay::FlushBudget(5000, 1000), 0);
+    // across the micros() wrap
+    CHECK_EQ(ExtDisplay::FlushBudget(0xFFFFFF00, 0x00000F00), 0x1000 - DISPLAY_FLUSH_MARGIN);
+}
+
+int main()
+{
+    TestBudget();
+
+    SamcoPreferences::pins.pPeriphSDA = 4;
+    SamcoPreferences::pins.pPeriphSCL = 5;
+    Wire.overhead = WIRE_CPU_OVERHEAD;
+
+    ExtDisplay oled;
+    SSD1306Panel panel;
+    CHECK(oled.Begin());
+    oled.serialDisplayType = ExtDisplay::ScreenSerial_Both;
+    oled.ScreenModeChange(ExtDisplay::Screen_Mamehook_Dual);
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+
+    // too little time for even a minimum run sends nothing, and keeps it for later
+    oled.UpdateHUD(99, 10);
+    const uint32_t tooShort = DisplayWireMicros(7) + DisplayWireMicros(DISPLAY_MIN_CHUNK + 1) - 1;
+    CHECK(oled.FlushStep(tooShort));
+    CHECK_EQ(Wire.log.size(), 0);
+    CHECK(oled.FlushStep(tooShort + 1));
+    CHECK_EQ(Wire.log.size(), 2);
+
+    // 5 s of frames: the camera read & solve take 0.6-2.8 ms, the game changes ammo & life every 30-80 ms
+    HostMicros() = 0;
+    uint32_t nextChange = 0, changedAt = 0;
+    bool waiting = false;
+    int32_t slackMin = INT32_MAX;
+    uint32_t latencyMax = 0, frames = 0, busyFrames = 0, overruns = 0;
+    uint8_t ammo = 30, life = 9;
+    for(uint32_t tick = 0; tick < 5000000; tick += FRAME_PERIOD, frames++) {
+        HostMicros() = tick;
+        HostMicros() += 600 + Random(2200);
+        uint32_t nextTick = tick + FRAME_PERIOD;
+
+        if(HostMicros() >= nextChange) {
+            ammo = ammo ? ammo - 1 : 30;
+            life = (life + 3) % 10;
+            oled.UpdateHUD(ammo, life);
+            nextChange = HostMicros() + 30000 + Random(50000);
+            if(!waiting) {
+                changedAt = HostMicros();
+                waiting = true;
+            }
+        }
+
+        size_t before = Wire.log.size();
+        bool more = oled.FlushStep(ExtDisplay::FlushBudget(HostMicros(), nextTick));
+        if(Wire.log.size() != before) {
+            busyFrames++;
+        }
+        int32_t slack = nextTick - HostMicros();
+        if(slack < slackMin) {
+            slackMin = slack;
+        }
+        if(slack < DISPLAY_FLUSH_MARGIN) {
+            overruns++;
+        }
+        if(!more && waiting) {
+            latencyMax = max(latencyMax, HostMicros() - changedAt);
+            waiting = false;
+        }
+    }
+    // then one full change at a time, with typical & slow frames: how many frames does it take to get out?
+    uint32_t tick = frames * FRAME_PERIOD;
+    auto drain = [&](uint32_t work) {
+        ammo = ammo == 88 ? 11 : 88;
+        life = life == 10 ? 4 : 10;
+        oled.UpdateHUD(ammo, life);
+        for(uint32_t n = 1; ; n++, tick += FRAME_PERIOD) {
+            HostMicros() = tick + work;
+            bool more = oled.FlushStep(ExtDisplay::FlushBudget(HostMicros(), tick + FRAME_PERIOD));
+            CHECK(HostMicros() <= tick + FRAME_PERIOD - DISPLAY_FLUSH_MARGIN);
+            if(!more) {
+                tick += FRAME_PERIOD;
+                return n;
+            }
+        }
+    };
+    uint32_t drainTypical = drain(800);
+    uint32_t drainSlow = drain(2800);
+    panel.Replay(Wire.log, DISPLAY_ADDRESS);
+    Wire.log.clear();
+    CHECK(!memcmp(panel.ram, display->getBuffer(), sizeof(panel.ram)));
+
+    const uint32_t wholePage = DisplayWireMicros(7) + DisplayWireMicros(SCREEN_WIDTH + 1);
+    printf("%u frames, %u with display traffic; least slack before the next camera read %ld us\n",
+           frames, busyFrames, (long)slackMin);
+    printf("longest the panel lagged the HUD: %.1f ms; a full redraw takes %u frames behind 0.8 ms of work, %u behind 2.8 ms\n",
+           latencyMax / 1000.0, drainTypical, drainSlow);
+    printf("a whole page in one go would hold the core %u us\n", wholePage);
+    CHECK_EQ(overruns, 0);
+    CHECK(slackMin >= DISPLAY_FLUSH_MARGIN);
+    // a full 2-digit & 10-heart redraw goes out within the HUD's own redraw interval (33 ms) on typical frames,
+    // and within a few of them when the camera side's slow
+    CHECK(drainTypical * FRAME_PERIOD < 33000);
+    CHECK(drainSlow * FRAME_PERIOD < 100000);
+    // and back to back redraws never leave it more than a few redraws behind
+    CHECK(latencyMax < 150000);
+    // and the old page-at-a-time step wouldn't have fit behind the slower frames
+    CHECK(wholePage > FRAME_PERIOD - 2800 - DISPLAY_FLUSH_MARGIN);
+
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,243 @@
+// OpenFIRE_Fusion with two simulated cameras on one gun: the second angled 11 degrees off and with a wider lens,
+// a cm to the side. The gun swings so the LEDs run off the first camera's view and into the second's.
+// Checks the extrinsics are learned from the frames both see all four in, that LEDs only the second camera sees
+// land where the first camera would've seen them, every LED either camera sees comes out once and only once,
+// and the first camera's LEDs are passed through untouched.
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include <initializer_list>
+#include "HostTest.h"
+#include "OpenFIRE_Fusion.h"
+
+typedef struct Vec_s {
+    double x, y, z;
+} Vec_t;
+
+// Screen LEDs, in meters on the screen plane (z = 0): a ~50" screen's corners
+static const Vec_t leds[4] = {{-0.55, -0.32, 0}, {0.55, -0.32, 0}, {-0.55, 0.32, 0}, {0.55, 0.32, 0}};
+
+typedef struct Cam_s {
+    double focal;               // in pixels
+    double yaw;                 // relative to the gun
+    double offset;              // from the gun's axis, sideways, in meters
+    int slot[4];                // which slot it reports each LED in
+} Cam_t;
+
+static const Cam_t cam0 = {1300.0, 0.0, 0.0, {0, 1, 2, 3}};
+static const Cam_t cam1 = {1000.0, -0.2, 0.01, {3, 1, 0, 2}};
+
+static uint32_t seed = 2;
+static int Noise() { seed = seed * 1103515245 + 12345; return (int)((seed >> 16) % 3) - 1; }
+
+// Pinhole projection of an LED for a gun at `gun`, turned by `yaw` & tilted by `pitch`; returns whether it's in view
+static bool Project(const Cam_t &cam, const Vec_t &led, const Vec_t &gun, double yaw, double pitch,
+                    double &u, double &v)
+{
+    double x = led.x - (gun.x + cam.offset), y = led.y - gun.y, z = led.z - gun.z;
+    double cp = cos(pitch), sp = sin(pitch);
+    double yp = cp * y - sp * z, zp = sp * y + cp * z;
+    double c = cos(yaw + cam.yaw), s = sin(yaw + cam.yaw);
+    double xc = c * x - s * zp, zc = s * x + c * zp;
+    u = cam.focal * xc / zc + CamResX / 2;
+    v = cam.focal * yp / zc + CamResY / 2;
+    return zc > 0 && u >= 0 && u <= CamResX - 1 && v >= 0 && v <= CamResY - 1;
+}
+
+typedef struct Frame_s {
+    int px[2][4], py[2][4];
+    unsigned int seen[2];
+    double trueX[4], trueY[4];  // where each LED is in the first camera's image, in view or not
+    bool inView[2][4];          // per LED, not per slot
+} Frame_t;
+
+static Frame_t Shoot(const Vec_t &gun, double yaw, double pitch, bool noise)
+{
+    Frame_t f = {};
+    const Cam_t *cams[2] = {&cam0, &cam1};
+    for(int c = 0; c < 2; c++) {
+        for(int i = 0; i < 4; i++) {
+            double u, v;
+            bool vis = Project(*cams[c], leds[i], gun, yaw, pitch, u, v);
+            int slot = cams[c]->slot[i];
+            f.px[c][slot] = (int)lround(u) + (noise ? Noise() : 0);
+            f.py[c][slot] = (int)lround(v) + (noise ? Noise() : 0);
+            f.inView[c][i] = vis;
+            if(vis) {
+                f.seen[c] |= 1 << slot;
+            }
+            if(c == 0) {
+                f.trueX[i] = u;
+                f.trueY[i] = v;
+            }
+        }
+    }
+    return f;
+}
+
+static int Bits(unsigned int mask)
+{
+    int n = 0;
+    for(; mask; mask >>= 1) {
+        n += mask & 1;
+    }
+    return n;
+}
+
+// A gun 2m back, swinging side to side at about a tenth of a Hz, over a minute
+static void TestSwing()
+{
+    OpenFIRE_Fusion fusion;
+    fusion.reset();
+    long learnedAt = -1;
+    uint32_t missingSingle = 0, missingFused = 0, fills = 0, duplicates = 0, lost = 0, touched = 0;
+    double worst = 0.0, sum = 0.0;
+
+    for(long n = 0; n < 12000; n++) {
+        double t = n / 209.0;
+        Vec_t gun = {0.05 * sin(t * 0.13), 0.03 * sin(t * 0.4), -2.0};
+        double yaw = 0.1 + 0.35 * sin(t * 0.6);
+        double pitch = 0.1 * sin(t * 0.9);
+        Frame_t f = Shoot(gun, yaw, pitch, true);
+        fusion.begin(f.px[0], f.py[0], f.seen[0], f.px[1], f.py[1], f.seen[1]);
+
+        // the first camera's LEDs always go through as they were, in their slots
+        for(int i = 0; i < 4; i++) {
+            if((f.seen[0] & (1 << i)) &&
+               (fusion.x(i) != f.px[0][i] || fusion.y(i) != f.py[0][i] || (fusion.second() & (1 << i)))) {
+                touched++;
+            }
+        }
+        CHECK_EQ(fusion.seen() & f.seen[0], f.seen[0]);
+
+        if(!fusion.Learned()) {
+            CHECK_EQ(fusion.seen(), f.seen[0]);
+            CHECK_EQ(fusion.second(), 0);
+            continue;
+        }
+        if(learnedAt < 0) {
+            learnedAt = n;
+        }
+
+        int inView0 = 0, inEither = 0;
+        for(int i = 0; i < 4; i++) {
+            inView0 += f.inView[0][i];
+            inEither += f.inView[0][i] || f.inView[1][i];
+        }
+        missingSingle += 4 - inView0;
+        missingFused += 4 - Bits(fusion.seen());
+        // every LED either camera sees, once: none dropped, none doubled up
+        if(Bits(fusion.seen()) < inEither) {
+            lost++;
+        }
+        if(Bits(fusion.seen()) > inEither) {
+            duplicates++;
+        }
+
+        // LEDs from the second camera land on where the first would've seen them, and aren't ones it did see
+        for(int i = 0; i < 4; i++) {
+            if(!(fusion.second() & (1 << i))) {
+                continue;
+            }
+            int nearest = 0;
+            double best = INFINITY;
+            for(int k = 0; k < 4; k++) {
+                double d = hypot(fusion.x(i) - f.trueX[k], fusion.y(i) - f.trueY[k]);
+                if(d < best) {
+                    best = d, nearest = k;
+                }
+            }
+            if(f.inView[0][nearest]) {
+                duplicates++;
+            }
+            worst = fmax(worst, best);
+            sum += best;
+            fills++;
+        }
+    }
+
+    printf("learned after %ld frames from %d points; LED-frames out of the first camera's view %u, "
+           "out of both %u; %u filled by the second camera, %.2f px mean error, %.2f px worst\n",
+           learnedAt, fusion.Extrinsics().points, missingSingle, missingFused, fills, sum / fills, worst);
+    CHECK(learnedAt >= 0);
+    CHECK(learnedAt < 209 * 15);
+    CHECK_EQ(fusion.Extrinsics().points, FUSION_LEARN_FRAMES * 4);
+    CHECK_EQ(touched, 0);
+    CHECK_EQ(duplicates, 0);
+    CHECK_EQ(lost, 0);
+    CHECK(fills > 1000);
+    // the second camera makes up for over a third of the LEDs the first one loses (it only looks off to one side)
+    CHECK(missingFused * 3 < missingSingle * 2);
+    // one fixed homography is only exact for cameras at the same spot: the 1cm between them, the pixel noise &
+    // reaching well past where it was learned add up to a few pixels, against hundreds for a wrong match
+    CHECK(sum / fills < 4.0);
+    CHECK(worst < 12.0);
+}
+
+// A frame with a reflection in place of an LED doesn't spoil what's been learned
+static void TestBadFrames()
+{
+    OpenFIRE_Fusion fusion;
+    fusion.reset();
+    const Vec_t gun = {0.0, 0.0, -2.0};
+    // learn from the corners of where both cameras see all four
+    const double spots[4][2] = {{0.0, -0.08}, {0.08, -0.08}, {0.0, 0.08}, {0.08, 0.08}};
+    for(const double *spot : spots) {
+        Frame_t f = Shoot(gun, spot[0], spot[1], false);
+        CHECK(f.seen[0] == 0x0F && f.seen[1] == 0x0F);
+        fusion.begin(f.px[0], f.py[0], f.seen[0], f.px[1], f.py[1], f.seen[1]);
+    }
+    CHECK(fusion.Learned());
+    CHECK_EQ(fusion.Extrinsics().points, 16);
+    CalibrationFit_t learned = fusion.Extrinsics();
+
+    // the second camera takes a reflection for one of the LEDs, in a frame that would otherwise widen the set
+    Frame_t bad = Shoot(gun, 0.04, 0.0, false);
+    CHECK(bad.seen[0] == 0x0F && bad.seen[1] == 0x0F);
+    bad.px[1][0] += 150;
+    bad.py[1][0] -= 90;
+    fusion.begin(bad.px[0], bad.py[0], bad.seen[0], bad.px[1], bad.py[1], bad.seen[1]);
+    CHECK_EQ(memcmp(&learned, &fusion.Extrinsics(), sizeof(learned)), 0);
+
+    // still fills in correctly afterwards
+    Frame_t f = Shoot(gun, 0.4, 0.0, false);
+    fusion.begin(f.px[0], f.py[0], f.seen[0], f.px[1], f.py[1], f.seen[1]);
+    CHECK(fusion.second() != 0);
+    for(int i = 0; i < 4; i++) {
+        if(!(fusion.second() & (1 << i))) {
+            continue;
+        }
+        double best = INFINITY;
+        for(int k = 0; k < 4; k++) {
+            best = fmin(best, hypot(fusion.x(i) - f.trueX[k], fusion.y(i) - f.trueY[k]));
+        }
+        CHECK(best < 8.0);
+    }
+
+    // and reset() goes back to the first camera alone
+    fusion.reset();
+    CHECK(!fusion.Learned());
+    fusion.begin(f.px[0], f.py[0], f.seen[0], f.px[1], f.py[1], f.seen[1]);
+    CHECK_EQ(fusion.seen(), f.seen[0]);
+    CHECK_EQ(fusion.second(), 0);
+}
+
+// Frames from one spot don't pin anything down past it, so they don't get it learned
+static void TestOneSpot()
+{
+    OpenFIRE_Fusion fusion;
+    fusion.reset();
+    for(int n = 0; n < 2000; n++) {
+        Frame_t f = Shoot({0.0, 0.0, -2.0}, 0.05, 0.0, true);
+        fusion.begin(f.px[0], f.py[0], f.seen[0], f.px[1], f.py[1], f.seen[1]);
+    }
+    CHECK(!fusion.Learned());
+}
+
+int main()
+{
+    TestSwing();
+    TestBadFrames();
+    TestOneSpot();
+    return HOSTTEST_RESULT();
+}
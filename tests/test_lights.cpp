@@ -0,0 +1,181 @@
+// Checks the LED effects' timing millisecond by millisecond, that Render() only asks for a show() when the frame
+// changes, and the second core's handoff: colors posted from Mamehook's pulse ramp, picked up by the main loop.
+#include <stdint.h>
+#include "HostTest.h"
+#include "OpenFIRELights.h"
+#include "SamcoColours.h"
+
+static void TestBlinkTiming()
+{
+    Lights lights;
+    lights.Set(0x102030);
+    CHECK(lights.Render(0));
+    CHECK_EQ(lights.color, 0x102030);
+
+    // 3 blinks of 100ms on, 50ms off, starting at 1000
+    const uint32_t color = 0xFF0000;
+    lights.Blink(color, 3, 100, 50, 1000);
+    uint32_t shows = 0;
+    for(unsigned long now = 1000; now < 1600; now++) {
+        shows += lights.Render(now);
+        unsigned long elapsed = now - 1000;
+        uint32_t expected = elapsed >= 450 ? 0x102030 : (elapsed % 150 < 100 ? color : 0);
+        if(lights.color != expected) {
+            printf("blink at +%lums: %06x, expected %06x\n", elapsed, lights.color, expected);
+            HostTestFailures()++;
+            break;
+        }
+    }
+    // on, off, on, off, on, off, then back to the solid color: one show each
+    CHECK_EQ(shows, 7);
+    CHECK(!lights.Render(5000));
+
+    // a Set() cuts a blink short
+    lights.Blink(color, 5, 100, 100, 6000);
+    CHECK(lights.Render(6000));
+    CHECK_EQ(lights.color, color);
+    lights.Set(0x000011);
+    CHECK(lights.Render(6001));
+    CHECK_EQ(lights.color, 0x000011);
+    CHECK(!lights.Render(6150));
+}
+
+static void TestPulseTiming()
+{
+    Lights lights;
+    const uint32_t color = 0x00FF00;
+    lights.Pulse(color, 1000, 0);
+    uint8_t last = 0;
+    for(unsigned long now = 0; now < 3000; now++) {
+        lights.Render(now);
+        uint8_t g = (lights.color >> 8) & 0xFF;
+        unsigned long phase = now % 1000;
+        // dark at the start of each period, full at the middle, and only ever going the one way in between
+        if(phase == 0) {
+            CHECK_EQ(g, 0);
+        } else if(phase == 500) {
+            CHECK_EQ(g, 255);
+        } else if(phase < 500) {
+            CHECK(g >= last);
+        } else {
+            CHECK(g <= last);
+        }
+        // symmetric about the middle
+        if(phase > 0 && phase < 500) {
+            Lights mirror;
+            mirror.Pulse(color, 1000, 0);
+            mirror.Render(1000 - phase);
+            CHECK_NEAR(g, (mirror.color >> 8) & 0xFF, 1);
+        }
+        last = g;
+    }
+}
+
+static void TestGauge()
+{
+    Lights lights;
+    lights.Set(0xFFFFFF);
+    lights.Render(0);
+    CHECK_EQ(lights.gaugeLit, LIGHTS_GAUGE_OFF);
+    lights.Gauge(5);
+    CHECK(lights.Render(1));
+    CHECK_EQ(lights.gaugeLit, 5);
+    CHECK(!lights.Render(2));
+
+    // the whole strip again, along with the color
+    lights.Set(0, Lights::Set_Whole);
+    CHECK(lights.Render(3));
+    CHECK_EQ(lights.gaugeLit, LIGHTS_GAUGE_OFF);
+    CHECK_EQ(lights.color, 0);
+
+    // Refresh() forces a frame out even when nothing changed
+    CHECK(!lights.Render(4));
+    lights.Refresh();
+    CHECK(lights.Render(5));
+}
+
+static void TestHandoff()
+{
+    Lights lights;
+    lights.Set(0x0000FF);
+    lights.Render(0);
+
+    // posts don't touch the effect state until the main core takes them
+    lights.Post(0x00FF00);
+    CHECK(!lights.Render(1));
+    CHECK_EQ(lights.color, 0x0000FF);
+    CHECK(lights.Take());
+    CHECK(!lights.Take());
+    CHECK(lights.Render(2));
+    CHECK_EQ(lights.color, 0x00FF00);
+
+    // only the latest of several counts
+    lights.Post(0x111111);
+    lights.Post(0x222222);
+    lights.Post(0x333333);
+    CHECK(lights.Take());
+    lights.Render(3);
+    CHECK_EQ(lights.color, 0x333333);
+
+    // a post replaces a blink the main core started, same as a Set() would
+    lights.Blink(0xFF0000, 10, 100, 100, 10);
+    lights.Post(0x123456, Lights::Set_Whole);
+    lights.Gauge(3);
+    lights.Take();
+    lights.Render(20);
+    CHECK_EQ(lights.color, 0x123456);
+    CHECK_EQ(lights.gaugeLit, LIGHTS_GAUGE_OFF);
+}
+
+// Mamehook's pulse ramp, as SerialHandling() runs it on the second core: +3 every 2ms up to full, then back down,
+// posted as it goes; the main loop takes & renders once every camera frame (209Hz), plus some jitter.
+// Every frame shown has to be the latest ramp value as of that frame, so it's never more than a frame behind.
+static void TestRampTiming()
+{
+    Lights lights;
+    lights.Set(0);
+    lights.Render(0);
+
+    uint8_t level = 0;
+    bool rising = true;
+    uint32_t nextStep = 0, nextFrame = 0;
+    uint32_t shows = 0, posts = 0, stale = 0;
+    uint32_t seed = 5;
+    for(uint32_t us = 0; us < 2000000; us++) {
+        if(us == nextStep) {
+            level = rising ? level + 3 : level - 3;
+            if(level == 255 || level == 0) {
+                rising = !rising;
+            }
+            lights.Post((uint32_t)level << 16);
+            posts++;
+            nextStep += 2000;
+        }
+        if(us == nextFrame) {
+            lights.Take();
+            if(lights.Render(us / 1000)) {
+                shows++;
+            }
+            if(lights.color != (uint32_t)level << 16) {
+                stale++;
+            }
+            seed = seed * 1103515245 + 12345;
+            nextFrame += 4785 - 400 + (seed >> 16) % 800;
+        }
+    }
+    printf("ramp: %u posts, %u frames shown, %u stale\n", posts, shows, stale);
+    CHECK_EQ(stale, 0);
+    // frames come slower than ramp steps, so some steps are skipped over rather than queued up
+    CHECK(shows > 400);
+    CHECK(shows < posts);
+}
+
+int main()
+{
+    TestBlinkTiming();
+    TestPulseTiming();
+    TestGauge();
+    TestHandoff();
+    TestRampTiming();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,143 @@
+// Feeds shot events in as the feedback code publishes them (solenoid pulses & Mamehook commands, on the second core)
+// and runs the main loop's side of LedService() against them: one Subscriber, taken once per pass.
+// Checks each shot's flash shows up within a pass, fades over its length, and that bursts restart it.
+#include <stdint.h>
+#include <vector>
+#include "HostTest.h"
+#include "OpenFIREEvents.h"
+#include "OpenFIRELights.h"
+#include "SamcoColours.h"
+
+static const uint32_t flashColor = WikiColor::Ghost_white;
+static const uint16_t flashLength = 60;
+
+// LedService()'s muzzle flash step
+static bool Service(Lights &lights, Events::Subscriber &shots, unsigned long now)
+{
+    if(shots.Take(Events::Event_Shot) + shots.Take(Events::Event_SerialShot)) {
+        lights.Flash(flashColor, flashLength, now);
+    }
+    return lights.Render(now);
+}
+
+static uint8_t Level(uint32_t color)
+{
+    // brightest channel, as the flash is mixed in per channel
+    uint8_t r = color >> 16, g = color >> 8, b = color;
+    return r > g ? (r > b ? r : b) : (g > b ? g : b);
+}
+
+static void TestBeforeSubscribing()
+{
+    // shots from before the listener started aren't flashed for
+    Events::Publish(Events::Event_Shot);
+    Events::Subscriber shots;
+    Lights lights;
+    lights.Set(0);
+    lights.Render(0);
+    CHECK(!Service(lights, shots, 1));
+    CHECK_EQ(lights.color, 0);
+
+    // and neither are any dropped with Clear()
+    Events::Publish(Events::Event_SerialShot);
+    shots.Clear();
+    CHECK(!Service(lights, shots, 2));
+}
+
+// Shots at a 15Hz autofire for a while, then a few single ones, then a Mamehook burst
+static void TestShotStream()
+{
+    Events::Subscriber shots;
+    Lights lights;
+    lights.Set(0x000020);
+    lights.Render(0);
+
+    std::vector<uint32_t> shotTimes;    // in microseconds
+    for(uint32_t t = 100000; t < 1100000; t += 66667) {
+        shotTimes.push_back(t);
+    }
+    shotTimes.push_back(1500000);
+    shotTimes.push_back(1800000);
+    for(uint32_t t = 2200000; t < 2210000; t += 1000) {
+        shotTimes.push_back(t);
+    }
+
+    // main loop passes at the 209Hz camera rate
+    const uint32_t pass = 1000000 / 209;
+    size_t next = 0;
+    uint32_t lastShot = 0;
+    bool shotSeen = true;
+    uint32_t lateMax = 0, flashes = 0, fadeErrors = 0;
+    uint32_t prevColor = lights.color;
+    for(uint32_t us = 0; us < 2500000; us += pass) {
+        bool published = false;
+        while(next < shotTimes.size() && shotTimes[next] <= us) {
+            Events::Publish((next & 1) ? Events::Event_SerialShot : Events::Event_Shot);
+            lastShot = shotTimes[next++];
+            published = true;
+        }
+        unsigned long now = us / 1000;
+        Service(lights, shots, now);
+
+        if(published) {
+            // full brightness on the first pass after the shot
+            if(Level(lights.color) != Level(flashColor)) {
+                fadeErrors++;
+            }
+            flashes++;
+            if(us - lastShot > lateMax) {
+                lateMax = us - lastShot;
+            }
+            shotSeen = true;
+        } else if(shotSeen) {
+            // fading, never brightening, until it's gone
+            uint32_t since = now - lastShot / 1000;
+            if(since >= flashLength + pass / 1000 + 1) {
+                if(lights.color != 0x000020) {
+                    fadeErrors++;
+                }
+            } else if(Level(lights.color) > Level(prevColor)) {
+                fadeErrors++;
+            }
+        }
+        prevColor = lights.color;
+    }
+    printf("%zu shots, %u flashes, latest flash %uus after its shot\n", shotTimes.size(), flashes, lateMax);
+    CHECK_EQ(fadeErrors, 0);
+    CHECK(lateMax < pass);
+    // each autofire & single shot gets its own flash; the burst's 10 shots fall into 3 passes
+    CHECK_EQ(flashes, 15 + 2 + 3);
+}
+
+// Fade shape: linear from full to nothing over the flash length, whatever it's over
+static void TestFade()
+{
+    Events::Subscriber shots;
+    Lights lights;
+    lights.Set(0);
+    lights.Render(0);
+    Events::Publish(Events::Event_Shot);
+    Service(lights, shots, 1000);
+    for(unsigned long t = 1000; t < 1000 + flashLength; t++) {
+        Service(lights, shots, t);
+        uint8_t expected = 255 - (t - 1000) * 255 / flashLength;
+        CHECK_NEAR(Level(lights.color), Level(COLOR_BRI_ADJ_RGB(expected, flashColor)), 1);
+    }
+    Service(lights, shots, 1000 + flashLength);
+    CHECK_EQ(lights.color, 0);
+
+    // a flash over a lit color keeps whichever channel's brighter
+    lights.Set(0xFF0000);
+    Events::Publish(Events::Event_SerialShot);
+    Service(lights, shots, 2000);
+    CHECK_EQ((lights.color >> 16) & 0xFF, 0xFF);
+    CHECK_EQ(lights.color & 0xFF, flashColor & 0xFF);
+}
+
+int main()
+{
+    TestBeforeSubscribing();
+    TestShotStream();
+    TestFade();
+    return HOSTTEST_RESULT();
+}
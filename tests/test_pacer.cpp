@@ -0,0 +1,247 @@
+// Pacer driven the way the run mode loop drives it: camera samples at 209Hz handed over half a millisecond after
+// they're taken, and Tick() from a loop turning every 250us or every 1ms. Checks there's never more than one report
+// a slot, nothing's sent when nothing moved, a busy endpoint counts as dropped & the retry carries the newest
+// position, a stalled loop picks up without a burst, prediction stops a frame ahead, and the stats cover a second.
+#include <stdint.h>
+#include <vector>
+#include <initializer_list>
+#include "HostTest.h"
+#include "OpenFIREPacer.h"
+
+static const uint32_t frame = 1000000 / 209;
+static const uint32_t latency = 500;
+
+typedef struct Report_s {
+    uint32_t at;                // us
+    uint16_t x, y;
+} Report_t;
+
+typedef struct Run_s {
+    std::vector<Report_t> reports;
+    uint32_t ticks;
+    uint32_t lastSample;        // us the newest sample handed over was taken
+    uint16_t lastX;
+} Run_t;
+
+// Where the pointer is at a time, in us: sweeping right at 10 counts a millisecond, or sat still
+static uint16_t Target(uint32_t us, bool moving)
+{
+    return moving ? 1000 + us / 100 : 16000;
+}
+
+// Runs until `until` us; the endpoint's busy from `busyFrom` to `busyTo`, and the loop's held up from `stallAt`
+// for `stall`
+static Run_t Run(Pacer &pacer, uint32_t until, uint32_t loop, bool moving, uint32_t busyFrom = 0,
+                 uint32_t busyTo = 0, uint32_t stallAt = 0, uint32_t stall = 0)
+{
+    Run_t run = {{}, 0, 0, 0};
+    uint32_t nextFrame = 0;
+    for(uint32_t now = 0; now < until; now += loop) {
+        if(stall && now >= stallAt) {
+            now += stall;
+            stall = 0;
+        }
+        while(nextFrame + latency <= now) {
+            run.lastSample = nextFrame;
+            run.lastX = Target(nextFrame, moving);
+            pacer.Sample(run.lastX, 12000, nextFrame);
+            nextFrame += frame;
+        }
+        uint16_t x, y;
+        run.ticks++;
+        if(pacer.Tick(now, now < busyFrom || now >= busyTo, x, y)) {
+            run.reports.push_back({now, x, y});
+        }
+    }
+    return run;
+}
+
+// Most reports in any one slot, counting slots from the first tick
+static uint32_t MostPerSlot(const Run_t &run)
+{
+    uint32_t most = 0, count = 0, slot = 0xFFFFFFFF;
+    for(const Report_t &r : run.reports) {
+        if(r.at / PACER_SLOT != slot) {
+            slot = r.at / PACER_SLOT;
+            count = 0;
+        }
+        count++;
+        most = count > most ? count : most;
+    }
+    return most;
+}
+
+static void TestOnePerSlot()
+{
+    for(uint32_t loop : {250u, 1000u}) {
+        for(bool predict : {false, true}) {
+            Pacer pacer;
+            pacer.predict = predict;
+            Run_t run = Run(pacer, 1000000, loop, true);
+            printf("loop every %uus, prediction %s: %zu reports a second from %u ticks\n", loop,
+                   predict ? "on" : "off", run.reports.size(), run.ticks);
+            CHECK_EQ(MostPerSlot(run), 1);
+            uint32_t closest = 0xFFFFFFFF;
+            for(size_t i = 1; i < run.reports.size(); i++) {
+                uint32_t gap = run.reports[i].at - run.reports[i - 1].at;
+                closest = gap < closest ? gap : closest;
+            }
+            CHECK(closest >= PACER_SLOT);
+            if(predict) {
+                // a report every slot once there are two samples to go on
+                CHECK(run.reports.size() >= 1000000 / PACER_SLOT - 10);
+            } else {
+                // one for each camera frame
+                CHECK_NEAR(run.reports.size(), 209, 1);
+            }
+        }
+    }
+}
+
+// Sat still: the first sample goes out, then nothing at all, predicting or not
+static void TestNoChange()
+{
+    for(bool predict : {false, true}) {
+        Pacer pacer;
+        pacer.predict = predict;
+        Run_t run = Run(pacer, 500000, 250, false);
+        CHECK_EQ(run.reports.size(), 1);
+        if(!run.reports.empty()) {
+            CHECK_EQ(run.reports[0].x, 16000);
+        }
+    }
+}
+
+// A busy endpoint skips slots and counts them; the first slot it's free again sends the newest sample, not the one
+// that was held up
+static void TestDropped()
+{
+    Pacer pacer;
+    Run_t run = Run(pacer, 106000, 1000, true, 100000, 106000);
+    uint32_t during = 0;
+    for(const Report_t &r : run.reports) {
+        during += r.at >= 100000;
+    }
+    CHECK_EQ(during, 0);
+    // carries on from the same loop time, now free
+    uint16_t x, y;
+    CHECK(pacer.Tick(106000, true, x, y));
+    CHECK_EQ(x, run.lastX);
+    CHECK(run.lastSample > run.reports.back().at);
+
+    // predicting, there's something new every slot, so each busy one's a drop; they show up once the second's out
+    Pacer counted;
+    counted.predict = true;
+    Run_t busy = Run(counted, 1000000 + PACER_SLOT, 1000, true, 100000, 106000);
+    printf("endpoint busy 6ms: %u slots dropped, %u reports in the second\n", counted.stats.dropped,
+           counted.stats.reports);
+    CHECK_EQ(counted.stats.dropped, 6);
+    CHECK_EQ(counted.stats.reports, busy.reports.size() - 1);
+}
+
+// A loop held up for 7.3ms gets one report when it's back, then the next slot's a whole slot later
+static void TestStall()
+{
+    Pacer pacer;
+    pacer.predict = true;
+    Run_t run = Run(pacer, 300000, 250, true, 0, 0, 200000, 7300);
+    uint32_t burst = 0, afterStall = 0xFFFFFFFF, nextAfter = 0;
+    for(const Report_t &r : run.reports) {
+        if(r.at >= 207300 && r.at < 207300 + PACER_SLOT) {
+            burst++;
+        }
+        if(r.at >= 207300 && afterStall == 0xFFFFFFFF) {
+            afterStall = r.at;
+        } else if(afterStall != 0xFFFFFFFF && !nextAfter) {
+            nextAfter = r.at;
+        }
+    }
+    printf("stalled 7.3ms: first report %uus after, next %uus after that\n", afterStall - 207300,
+           nextAfter - afterStall);
+    CHECK_EQ(burst, 1);
+    CHECK_EQ(afterStall, 207300);
+    CHECK_EQ(nextAfter - afterStall, PACER_SLOT);
+    CHECK_EQ(MostPerSlot(run), 1);
+}
+
+// Prediction runs a frame ahead of the newest sample at most, holds still across long gaps, and stays in range
+static void TestPredictCap()
+{
+    Pacer pacer;
+    pacer.predict = true;
+    uint16_t x, y;
+    pacer.Sample(1000, 5000, 0);
+    pacer.Sample(2000, 4000, frame);
+    CHECK(pacer.Tick(frame, true, x, y));
+    CHECK_EQ(x, 2000);
+    CHECK_EQ(y, 4000);
+    // half a frame on, half the last frame's movement on
+    CHECK(pacer.Tick(frame + frame / 2, true, x, y));
+    CHECK_NEAR(x, 2500, 1);
+    CHECK_NEAR(y, 3500, 1);
+    // no further than a whole frame's, however late it gets
+    CHECK(pacer.Tick(frame * 2, true, x, y));
+    CHECK_EQ(x, 3000);
+    CHECK_EQ(y, 3000);
+    CHECK(!pacer.Tick(frame * 2 + 10 * PACER_SLOT, true, x, y));
+    CHECK(!pacer.Tick(frame * 10, true, x, y));
+
+    // a gap longer than PACER_PREDICT_MAX just repeats the newest sample
+    pacer.Sample(4000, 3000, frame + PACER_PREDICT_MAX + 1);
+    CHECK(pacer.Tick(frame + PACER_PREDICT_MAX + 1 + frame, true, x, y));
+    CHECK_EQ(x, 4000);
+    CHECK_EQ(y, 3000);
+
+    // running off either edge stops at the edge
+    Pacer edge;
+    edge.predict = true;
+    edge.Sample(32000, 600, 0);
+    edge.Sample(32700, 100, frame);
+    CHECK(edge.Tick(frame * 2, true, x, y));
+    CHECK_EQ(x, PACER_POS_MAX);
+    CHECK_EQ(y, 0);
+}
+
+// Stats are all zero until the first second's done, then hold that second's counts while the next one runs
+static void TestStatsWindow()
+{
+    Pacer pacer;
+    pacer.predict = true;
+    Run(pacer, 1000000, 1000, true);
+    CHECK_EQ(pacer.stats.reports, 0);
+    CHECK_EQ(pacer.stats.dropped, 0);
+
+    Pacer full;
+    full.predict = true;
+    Run_t run = Run(full, 1000000 + PACER_SLOT, 1000, true);
+    printf("first second: %u reports, %u dropped, sample age %uus mean, %uus worst\n", full.stats.reports,
+           full.stats.dropped, full.stats.ageAvg, full.stats.ageMax);
+    // everything but the report in the slot that rolled the window over
+    CHECK_EQ(full.stats.reports, run.reports.size() - 1);
+    CHECK_EQ(full.stats.dropped, 0);
+    // a report's sample is never older than a frame & the latency, give or take a slot
+    CHECK(full.stats.ageMax <= frame + latency + PACER_SLOT);
+    CHECK(full.stats.ageAvg > latency);
+    CHECK(full.stats.ageAvg < full.stats.ageMax);
+
+    // the second after, sat still with nothing new, comes out empty
+    Pacer still;
+    Run(still, 2000000 + PACER_SLOT, 1000, false);
+    CHECK_EQ(still.stats.reports, 0);
+
+    // Reset() clears them
+    full.Reset();
+    CHECK_EQ(full.stats.reports, 0);
+    CHECK_EQ(full.stats.ageMax, 0);
+}
+
+int main()
+{
+    TestOnePerSlot();
+    TestNoChange();
+    TestDropped();
+    TestStall();
+    TestPredictCap();
+    TestStatsWindow();
+    return HOSTTEST_RESULT();
+}
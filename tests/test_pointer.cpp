@@ -0,0 +1,200 @@
+// The relative mouse & digitizer report descriptors walked item by item: each has to parse to its exact length,
+// close every collection, and describe POINTER_REPORT_LEN bytes after the report ID with the X/Y ranges the
+// firmware fills them with. Then RelativeAxis is swept slowly back & forth to check no count's lost or drifts, and
+// pushed past what one report holds to check the clamped part comes out on later steps.
+#include <stdint.h>
+#include <stddef.h>
+#include <initializer_list>
+#include "HostTest.h"
+#include "TinyUSB_Pointer.h"
+
+// as TinyUSB has it
+#define HID_REPORT_ID(x) 0x85, x,
+
+static const uint8_t relMouse[] = { TUD_HID_REPORT_DESC_RELMOUSE5(HID_REPORT_ID(2)) };
+static const uint8_t digitizer[] = { TUD_HID_REPORT_DESC_DIGITIZER(HID_REPORT_ID(3)) };
+
+typedef struct Walk_s {
+    bool parsed;                // every item fit, and the collections balanced
+    size_t length;              // bytes walked
+    int reportId;
+    unsigned int inputBits;     // size of the input report after the ID
+    int32_t xyMin, xyMax;       // logical range of the last input item, the X/Y one
+    unsigned int xySize;
+} Walk_t;
+
+static int32_t Signed(const uint8_t *data, unsigned int size)
+{
+    uint32_t v = 0;
+    for(unsigned int i = 0; i < size; i++) {
+        v |= (uint32_t)data[i] << (i * 8);
+    }
+    if(size == 1) return (int8_t)v;
+    if(size == 2) return (int16_t)v;
+    return (int32_t)v;
+}
+
+static Walk_t Walk(const uint8_t *desc, size_t len)
+{
+    Walk_t walk = {false, 0, -1, 0, 0, 0, 0};
+    unsigned int reportSize = 0, reportCount = 0, depth = 0;
+    int32_t logicalMin = 0, logicalMax = 0;
+    // logical maximum's read unsigned when the minimum's not negative, as hosts read it
+    uint32_t rawMax = 0;
+    size_t i = 0;
+    while(i < len) {
+        uint8_t prefix = desc[i];
+        unsigned int size = prefix & 0x03 ? 1 << ((prefix & 0x03) - 1) : 0;
+        if(i + 1 + size > len) {
+            return walk;
+        }
+        const uint8_t *data = &desc[i + 1];
+        switch(prefix & 0xFC) {
+        case 0x74: reportSize = Signed(data, size); break;
+        case 0x94: reportCount = Signed(data, size); break;
+        case 0x84: walk.reportId = data[0]; break;
+        case 0x14: logicalMin = Signed(data, size); break;
+        case 0x24:
+            logicalMax = Signed(data, size);
+            rawMax = 0;
+            for(unsigned int b = 0; b < size; b++) {
+                rawMax |= (uint32_t)data[b] << (b * 8);
+            }
+            break;
+        case 0xA0: depth++; break;
+        case 0xC0:
+            if(!depth) {
+                return walk;
+            }
+            depth--;
+            break;
+        case 0x80:
+            walk.inputBits += reportSize * reportCount;
+            walk.xyMin = logicalMin;
+            walk.xyMax = logicalMin >= 0 ? (int32_t)rawMax : logicalMax;
+            walk.xySize = reportSize;
+            break;
+        }
+        i += 1 + size;
+    }
+    walk.length = i;
+    walk.parsed = depth == 0;
+    return walk;
+}
+
+static void TestDescriptors()
+{
+    Walk_t rel = Walk(relMouse, sizeof(relMouse));
+    Walk_t pen = Walk(digitizer, sizeof(digitizer));
+    printf("relative mouse descriptor %zu bytes, %u bit report; digitizer %zu bytes, %u bit report\n",
+           sizeof(relMouse), rel.inputBits, sizeof(digitizer), pen.inputBits);
+
+    // the lengths that go in the HID descriptor, with the two byte report ID item in each
+    CHECK_EQ(sizeof(relMouse), 54);
+    CHECK_EQ(sizeof(digitizer), 64);
+    for(const Walk_t &w : {rel, pen}) {
+        CHECK(w.parsed);
+        CHECK_EQ(w.inputBits, POINTER_REPORT_LEN * 8);
+        CHECK_EQ(w.xySize, 16);
+    }
+    CHECK_EQ(rel.length, sizeof(relMouse));
+    CHECK_EQ(pen.length, sizeof(digitizer));
+    CHECK_EQ(rel.reportId, 2);
+    CHECK_EQ(pen.reportId, 3);
+
+    // RelativeAxis never gives more than the descriptor allows either way
+    CHECK_EQ(rel.xyMin, -32767);
+    CHECK_EQ(rel.xyMax, 32767);
+    // and report() stretches 0-32767 to exactly this
+    CHECK_EQ(pen.xyMin, 0);
+    CHECK_EQ(pen.xyMax, 65535);
+    uint16_t top = 32767;
+    CHECK_EQ((uint16_t)((top << 1) | (top >> 14)), pen.xyMax);
+}
+
+// Crawling one position at a time, far less than a count per step, still moves the whole range's worth
+static void TestSlowSweep()
+{
+    for(uint16_t range : {1920, 1000, 4095, 32767}) {
+        RelativeAxis axis;
+        axis.setRange(range);
+        CHECK_EQ(axis.step(0), 0);
+        int32_t total = 0, worstLag = 0;
+        for(int sweep = 0; sweep < 4; sweep++) {
+            bool up = !(sweep & 1);
+            for(int i = 1; i <= 32767; i++) {
+                total += axis.step(up ? i : 32767 - i);
+                // never more than a count behind where the exact sum would be
+                int64_t exact = (int64_t)(up ? i : 32767 - i) * range / 32767;
+                int32_t lag = (int32_t)(exact - total);
+                lag = lag < 0 ? -lag : lag;
+                worstLag = lag > worstLag ? lag : worstLag;
+            }
+            CHECK_EQ(total, up ? range : 0);
+        }
+        printf("range %u: four full sweeps a count at a time, back at 0 with at most %d count behind\n", range,
+               worstLag);
+        CHECK(worstLag <= 1);
+    }
+}
+
+// A jump bigger than one report can carry is clamped, and the rest comes out on the steps after
+static void TestClampedResidue()
+{
+    RelativeAxis axis;
+    axis.setRange(65535);
+    axis.step(0);
+    CHECK_EQ(axis.step(32767), 32767);
+    CHECK_EQ(axis.step(32767), 32767);
+    CHECK_EQ(axis.step(32767), 1);
+    CHECK_EQ(axis.step(32767), 0);
+    CHECK_EQ(axis.step(0), -32767);
+    CHECK_EQ(axis.step(0), -32767);
+    CHECK_EQ(axis.step(0), -1);
+    CHECK_EQ(axis.step(0), 0);
+
+    // reset() forgets the residue along with the position
+    axis.step(32767);
+    axis.reset();
+    CHECK_EQ(axis.step(100), 0);
+    CHECK_EQ(axis.step(100), 0);
+}
+
+// Steps taken before a report() add onto what's pending, saturating, and what didn't fit isn't lost
+static void TestStepInto()
+{
+    RelativeAxis axis;
+    axis.setRange(32767);
+    int16_t pending = 0;
+    axis.stepInto(pending, 1000);
+    CHECK_EQ(pending, 0);
+    axis.stepInto(pending, 21000);
+    axis.stepInto(pending, 31000);
+    CHECK_EQ(pending, 30000);
+    axis.stepInto(pending, 10000);
+    CHECK_EQ(pending, 9000);
+
+    pending = 30000;
+    axis.stepInto(pending, 15000);
+    CHECK_EQ(pending, 32767);
+    // the report goes out, then the 2233 held back follow
+    pending = 0;
+    axis.stepInto(pending, 15000);
+    CHECK_EQ(pending, 2233);
+
+    pending = -32000;
+    axis.stepInto(pending, 13000);
+    CHECK_EQ(pending, -32767);
+    pending = 0;
+    axis.stepInto(pending, 13000);
+    CHECK_EQ(pending, -1233);
+}
+
+int main()
+{
+    TestDescriptors();
+    TestSlowSweep();
+    TestClampedResidue();
+    TestStepInto();
+    return HOSTTEST_RESULT();
+}
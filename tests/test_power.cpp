@@ -0,0 +1,227 @@
+// PowerSaver driven the way the run mode loop drives it on battery, through a two minute activity trace:
+// LEDs in & out of view, a couple of button taps, and long stretches of nothing. The camera's read at whatever
+// rate it's set to, the first frame seeing an LED pokes it, and held buttons poke it every millisecond.
+// Checks each step down happens on time, the rates while idle & dozing, and that any activity brings back the
+// full rate by the very next frame.
+#include <stdint.h>
+#include <vector>
+#include <initializer_list>
+#include "HostTest.h"
+#include "OpenFIREPower.h"
+
+static const unsigned int fullRate = 209;
+
+typedef struct Span_s {
+    uint32_t from, to;          // ms
+} Span_t;
+
+static bool In(const std::vector<Span_t> &spans, uint32_t ms)
+{
+    for(const Span_t &s : spans) {
+        if(ms >= s.from && ms < s.to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct Change_s {
+    uint32_t at;                // ms
+    uint8_t level;
+} Change_t;
+
+typedef struct Trace_s {
+    std::vector<Change_t> changes;
+    std::vector<uint32_t> frames;   // when each camera frame was read, in us
+    uint32_t worstWake;         // longest from activity while asleep to the next full rate frame, in us
+} Trace_t;
+
+// 100us per loop pass, as PowerStep() & the camera timer have it in the sketch
+static Trace_t Run(PowerSaver &power, uint32_t ms, const std::vector<Span_t> &seen, const std::vector<Span_t> &held)
+{
+    Trace_t trace = {{}, {}, 0};
+    unsigned int rate = fullRate;
+    uint32_t nextFrame = 0, wokeAt = 0;
+    bool waking = false;
+    power.Reset(0);
+
+    for(uint32_t us = 0; us < ms * 1000; us += 100) {
+        uint32_t now = us / 1000;
+        // buttons, on the other core every millisecond
+        if(us % 1000 == 0 && In(held, now)) {
+            power.Poke();
+        }
+        if(us >= nextFrame) {
+            nextFrame = us + 1000000 / rate;
+            trace.frames.push_back(us);
+            if(In(seen, now)) {
+                power.Poke();
+            }
+            if(waking && rate == fullRate) {
+                uint32_t took = us - wokeAt;
+                trace.worstWake = took > trace.worstWake ? took : trace.worstWake;
+                waking = false;
+            }
+        }
+        if(!waking && power.Asleep() && (In(seen, now) || In(held, now))) {
+            waking = true;
+            wokeAt = us;
+        }
+        if(power.Update(now)) {
+            trace.changes.push_back({now, power.Level()});
+            rate = power.Rate(fullRate);
+            nextFrame = us + 1000000 / rate;
+            if(!power.Asleep()) {
+                // don't wait out what's left of a slow frame
+                nextFrame = us + 100;
+            }
+        }
+    }
+    return trace;
+}
+
+// Frames read between two times, in ms
+static uint32_t Frames(const Trace_t &trace, uint32_t from, uint32_t to)
+{
+    uint32_t n = 0;
+    for(uint32_t us : trace.frames) {
+        n += us >= from * 1000 && us < to * 1000;
+    }
+    return n;
+}
+
+static void TestTrace()
+{
+    PowerSaver power;
+    // playing for 5s; a tap at 20s while idle; an LED back in view at 60s, and a tap at 100s, while dozing
+    const std::vector<Span_t> seen = {{0, 5000}, {60000, 61000}};
+    const std::vector<Span_t> held = {{20000, 20080}, {100000, 100001}};
+    Trace_t trace = Run(power, 140000, seen, held);
+
+    const Change_t expect[] = {
+        {5000 + POWER_IDLE_DELAY, PowerSaver::Level_Idle},
+        {20000, PowerSaver::Level_Active},
+        {20080 + POWER_IDLE_DELAY, PowerSaver::Level_Idle},
+        {20080 + POWER_DOZE_DELAY, PowerSaver::Level_Doze},
+        {60000, PowerSaver::Level_Active},
+        {61000 + POWER_IDLE_DELAY, PowerSaver::Level_Idle},
+        {61000 + POWER_DOZE_DELAY, PowerSaver::Level_Doze},
+        {100000, PowerSaver::Level_Active},
+        {100001 + POWER_IDLE_DELAY, PowerSaver::Level_Idle},
+        {100001 + POWER_DOZE_DELAY, PowerSaver::Level_Doze},
+    };
+    const size_t count = sizeof(expect) / sizeof(expect[0]);
+    for(const Change_t &c : trace.changes) {
+        printf("%6ums: %s\n", c.at, c.level == PowerSaver::Level_Active ? "active" :
+               c.level == PowerSaver::Level_Idle ? "idle" : "doze");
+    }
+    CHECK_EQ(trace.changes.size(), count);
+    for(size_t i = 0; i < count && i < trace.changes.size(); i++) {
+        CHECK_EQ(trace.changes[i].level, expect[i].level);
+        // an LED's only seen on a frame, and the doze frames are 100ms apart
+        CHECK_NEAR(trace.changes[i].at, expect[i].at, 1000 / POWER_DOZE_RATE);
+    }
+
+    // the camera's read at each level's rate, give or take a frame
+    printf("frames a second: active %u, idle %u, dozing %u; back to full rate within %uus of any activity\n",
+           Frames(trace, 0, 5000) / 5, Frames(trace, 10000, 20000) / 10, Frames(trace, 51000, 59000) / 8,
+           trace.worstWake);
+    CHECK_NEAR(Frames(trace, 0, 5000), fullRate * 5, 5);
+    CHECK_NEAR(Frames(trace, 10000, 20000), POWER_IDLE_RATE * 10, 1);
+    CHECK_NEAR(Frames(trace, 51000, 59000), POWER_DOZE_RATE * 8, 1);
+
+    // the first frame after any activity is already at the full rate: a button's next pass, an LED's next frame
+    CHECK(trace.worstWake <= 1000000 / POWER_DOZE_RATE + 1000);
+    for(uint32_t wake : {20000u, 60000u, 100000u}) {
+        uint32_t first = 0;
+        for(size_t i = 0; i + 2 < trace.frames.size(); i++) {
+            if(trace.frames[i] >= wake * 1000) {
+                first = i;
+                break;
+            }
+        }
+        // the camera frame after the one that catches it
+        CHECK(trace.frames[first + 1] - trace.frames[first] <= 1000000 / fullRate + 100);
+        CHECK(trace.frames[first + 2] - trace.frames[first + 1] <= 1000000 / fullRate + 100);
+    }
+    // a button never waits on a slow frame
+    CHECK(trace.frames[Frames(trace, 0, 100000)] - 100000 * 1000 <= 200);
+}
+
+static void TestSteps()
+{
+    PowerSaver power;
+    power.Reset(1000);
+    CHECK(!power.Update(1000));
+    CHECK(!power.Update(1000 + POWER_IDLE_DELAY - 1));
+    CHECK_EQ(power.Level(), PowerSaver::Level_Active);
+    CHECK_EQ(power.Rate(fullRate), fullRate);
+    CHECK(!power.Asleep());
+
+    CHECK(power.Update(1000 + POWER_IDLE_DELAY));
+    CHECK_EQ(power.Level(), PowerSaver::Level_Idle);
+    CHECK_EQ(power.Rate(fullRate), POWER_IDLE_RATE);
+    CHECK(power.Asleep());
+    // only says so when it changes
+    CHECK(!power.Update(1000 + POWER_IDLE_DELAY + 1));
+
+    CHECK(power.Update(1000 + POWER_DOZE_DELAY));
+    CHECK_EQ(power.Level(), PowerSaver::Level_Doze);
+    CHECK_EQ(power.Rate(fullRate), POWER_DOZE_RATE);
+
+    // a poke's taken on the next pass, and counts from then
+    power.Poke();
+    CHECK(power.Update(50000));
+    CHECK_EQ(power.Level(), PowerSaver::Level_Active);
+    CHECK(!power.Update(50000 + POWER_IDLE_DELAY - 1));
+    CHECK(power.Update(50000 + POWER_IDLE_DELAY));
+
+    // a poke while already active doesn't count as a change
+    power.Reset(60000);
+    power.Poke();
+    CHECK(!power.Update(60001));
+
+    // Reset() drops a poke from before it, and is back to full rate whatever the level was
+    power.Update(60001 + POWER_DOZE_DELAY);
+    power.Poke();
+    power.Reset(100000);
+    CHECK_EQ(power.Level(), PowerSaver::Level_Active);
+    CHECK(!power.Update(100000 + POWER_IDLE_DELAY - 1));
+
+    // millis() wrapping around doesn't wake or sleep it early
+    power.Reset(0xFFFFFFFF - 500);
+    CHECK(!power.Update(0xFFFFFFFF));
+    CHECK(!power.Update(POWER_IDLE_DELAY - 502));
+    CHECK(power.Update(POWER_IDLE_DELAY - 501));
+}
+
+static void TestBattery()
+{
+    PowerSaver power;
+    CHECK_EQ(power.battery, 0);
+    // first reading straight away, then once an interval
+    CHECK(power.BatteryDue(5));
+    CHECK(!power.BatteryDue(5 + POWER_BATTERY_INTERVAL - 1));
+    CHECK(power.BatteryDue(5 + POWER_BATTERY_INTERVAL));
+
+    // the first reading's taken as it is, later ones eased towards
+    power.BatterySample(3700);
+    CHECK_EQ(power.battery, 3700);
+    power.BatterySample(3600);
+    CHECK(power.battery < 3700 && power.battery > 3600);
+    // a dip under solenoid load barely moves it
+    power.BatterySample(3000);
+    CHECK(power.battery > 3550);
+    for(int i = 0; i < 60; i++) {
+        power.BatterySample(3600);
+    }
+    CHECK_NEAR(power.battery, 3600, 4);
+}
+
+int main()
+{
+    TestSteps();
+    TestTrace();
+    TestBattery();
+    return HOSTTEST_RESULT();
+}
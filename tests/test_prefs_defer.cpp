@@ -0,0 +1,160 @@
+// Drives PrefsDefer the way SavePreferencesStep() does, once after every camera frame, with scripted button
+// traces, and checks a staged save only reaches the flash while no button's held (or once it's waited too long).
+#include <stdint.h>
+#include <string.h>
+#include "HostTest.h"
+#include "FlashSim.h"
+#include "OpenFIREPrefsLog.h"
+
+// Camera frame interval at 209Hz, in microseconds
+static const uint32_t frameMicros = 1000000 / 209;
+
+// Steps frame by frame until the save's due, or `limit` ms have gone by; returns when it went, in ms, or -1
+static int32_t RunUntilDue(PrefsDefer &defer, uint32_t &micros, uint32_t limit, bool (*held)(uint32_t ms))
+{
+    uint32_t start = micros / 1000;
+    while(micros / 1000 - start < limit) {
+        micros += frameMicros;
+        uint32_t ms = micros / 1000;
+        if(defer.Due(ms, held(ms))) {
+            return ms;
+        }
+    }
+    return -1;
+}
+
+static bool Never(uint32_t) { return false; }
+static bool Always(uint32_t) { return true; }
+static bool UntilHalfSecond(uint32_t ms) { return ms < 500; }
+
+static void TestBasics()
+{
+    PrefsDefer defer;
+    uint32_t micros = 0;
+    CHECK(!defer.Pending());
+    CHECK_EQ(RunUntilDue(defer, micros, 5000, Never), -1);
+
+    // nothing held: it goes on the very next frame
+    micros = 0;
+    defer.Request(0);
+    CHECK(defer.Pending());
+    CHECK_EQ(RunUntilDue(defer, micros, 5000, Never), frameMicros / 1000);
+    CHECK(!defer.Pending());
+
+    // held for a while: it goes on the first frame after the release
+    micros = 0;
+    defer.Request(0);
+    int32_t at = RunUntilDue(defer, micros, 5000, UntilHalfSecond);
+    CHECK(at >= 500);
+    CHECK(at < 500 + (int32_t)frameMicros / 1000 + 1);
+
+    // held the whole time: it goes once it's waited PREFS_MAX_DEFER
+    micros = 0;
+    defer.Request(0);
+    at = RunUntilDue(defer, micros, 5000, Always);
+    CHECK(at >= PREFS_MAX_DEFER);
+    CHECK(at < PREFS_MAX_DEFER + (int32_t)frameMicros / 1000 + 1);
+
+    // another request while one's waiting doesn't push it back
+    micros = 0;
+    defer.Request(0);
+    CHECK_EQ(RunUntilDue(defer, micros, 1500, Always), -1);
+    defer.Request(micros / 1000);
+    at = RunUntilDue(defer, micros, 5000, Always);
+    CHECK(at >= PREFS_MAX_DEFER);
+    CHECK(at < PREFS_MAX_DEFER + (int32_t)frameMicros / 1000 + 1);
+
+    // clearing the preferences drops it
+    micros = 0;
+    defer.Request(0);
+    defer.Cancel();
+    CHECK_EQ(RunUntilDue(defer, micros, 5000, Never), -1);
+
+    // millis() wrapping while it waits
+    defer.Request(0xFFFFFF00u);
+    CHECK(!defer.Due(0xFFFFFFF0u, true));
+    CHECK(!defer.Due(100, true));
+    CHECK(defer.Due(0xFFFFFF00u + PREFS_MAX_DEFER, true));
+}
+
+// A minute of play: trigger bursts & held buttons, and saves asked for now and then;
+// every write to flash is checked against what the buttons were doing right then.
+static void TestGameplayTrace()
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    PrefsDefer defer;
+
+    uint8_t settings[24] = {};
+    uint32_t seed = 1;
+    auto rnd = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7FFF; };
+
+    uint32_t heldUntil = 0, nextPress = 0;
+    uint32_t requests = 0, commits = 0, whileHeld = 0, forced = 0, waitMax = 0;
+    uint32_t requestStamp = 0;
+    bool waiting = false;
+    uint8_t committed = 0;
+
+    for(uint32_t micros = 0; micros < 60000000; micros += frameMicros) {
+        uint32_t ms = micros / 1000;
+        // trigger pulls of 50-250ms, every now and then a long hold (a pedal, or a held reload)
+        if(ms >= nextPress && ms >= heldUntil) {
+            heldUntil = ms + ((rnd() % 20) ? 50 + rnd() % 200 : 2500 + rnd() % 2000);
+            nextPress = heldUntil + 20 + rnd() % 400;
+        }
+        bool held = ms < heldUntil;
+
+        // a save asked for about every 3 seconds, from the pause menu or the App
+        if(rnd() % 627 == 0) {
+            settings[0]++;
+            log.Stage(5, 1, settings, sizeof(settings));
+            defer.Request(ms);
+            requests++;
+            if(!waiting) {
+                requestStamp = ms;
+                waiting = true;
+            }
+        }
+
+        uint32_t work = flash.work;
+        if(defer.Due(ms, held)) {
+            CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+            commits++;
+            committed = settings[0];
+            uint32_t waited = ms - requestStamp;
+            waiting = false;
+            if(waited > waitMax) {
+                waitMax = waited;
+            }
+            if(held) {
+                whileHeld++;
+                forced += waited >= PREFS_MAX_DEFER;
+            }
+        } else {
+            // nothing touches the flash unless it's due
+            CHECK_EQ(flash.work, work);
+        }
+    }
+
+    printf("%u saves asked for, %u commits; %u while a button was held (%u after the max wait), longest wait %ums\n",
+           requests, commits, whileHeld, forced, waitMax);
+    CHECK(requests > 10);
+    CHECK(commits > 0);
+    CHECK(commits <= requests);
+    // the only writes with a button down are the ones that had waited long enough
+    CHECK_EQ(whileHeld, forced);
+    CHECK(waitMax < PREFS_MAX_DEFER + frameMicros / 1000 + 1);
+
+    // what's stored is the last save, after the last commit
+    uint8_t stored[24];
+    CHECK_EQ(log.Read(5, 1, stored, sizeof(stored)), PrefsLog::Result_Ok);
+    CHECK_EQ(stored[0], committed);
+}
+
+int main()
+{
+    TestBasics();
+    TestGameplayTrace();
+    return HOSTTEST_RESULT();
+}
@@ -0,0 +1,334 @@
+// Runs the preferences log against a simulated flash: reading back, appending vs. compacting, how evenly
+// the sectors wear, and cutting the power at every byte of a save to check a reboot always finds
+// either the old or the new copy of each group, never a mix or garbage. Also where the sketch may put the log.
+#include <stdint.h>
+#include <string.h>
+#include "HostTest.h"
+#include "FlashSim.h"
+#include "OpenFIREPrefsLog.h"
+
+// Groups shaped roughly like the real ones: profiles, selected profile, toggles, settings & calibration
+struct Prefs {
+    uint8_t profiles[228];
+    uint8_t selected[1];
+    uint8_t toggles[9];
+    uint8_t settings[24];
+    uint8_t calibration[148];
+};
+
+enum { Type_Profiles = 1, Type_Selected = 2, Type_Toggles = 3, Type_Settings = 5, Type_Calibration = 7 };
+
+static void Fill(uint8_t *p, size_t n, uint32_t seed)
+{
+    for(size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        p[i] = seed >> 16;
+    }
+}
+
+static Prefs Make(uint32_t seed)
+{
+    Prefs p;
+    Fill(p.profiles, sizeof(p.profiles), seed);
+    Fill(p.selected, sizeof(p.selected), seed + 1);
+    Fill(p.toggles, sizeof(p.toggles), seed + 2);
+    Fill(p.settings, sizeof(p.settings), seed + 3);
+    Fill(p.calibration, sizeof(p.calibration), seed + 4);
+    return p;
+}
+
+static void StageAll(PrefsLog &log, const Prefs &p)
+{
+    log.Stage(Type_Profiles, 1, p.profiles, sizeof(p.profiles));
+    log.Stage(Type_Selected, 1, p.selected, sizeof(p.selected));
+    log.Stage(Type_Toggles, 1, p.toggles, sizeof(p.toggles));
+    log.Stage(Type_Settings, 1, p.settings, sizeof(p.settings));
+    log.Stage(Type_Calibration, 1, p.calibration, sizeof(p.calibration));
+}
+
+static bool ReadAll(const PrefsLog &log, Prefs &p)
+{
+    return log.Read(Type_Profiles, 1, p.profiles, sizeof(p.profiles)) == PrefsLog::Result_Ok &&
+           log.Read(Type_Selected, 1, p.selected, sizeof(p.selected)) == PrefsLog::Result_Ok &&
+           log.Read(Type_Toggles, 1, p.toggles, sizeof(p.toggles)) == PrefsLog::Result_Ok &&
+           log.Read(Type_Settings, 1, p.settings, sizeof(p.settings)) == PrefsLog::Result_Ok &&
+           log.Read(Type_Calibration, 1, p.calibration, sizeof(p.calibration)) == PrefsLog::Result_Ok;
+}
+
+// What a fresh boot finds
+static bool Boot(FlashSim &flash, Prefs &p)
+{
+    PrefsLog log(flash);
+    log.Begin();
+    return ReadAll(log, p);
+}
+
+static void TestFirstSave()
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    CHECK(log.Empty());
+    uint8_t settings[24] = {};
+    CHECK_EQ(log.Read(Type_Settings, 1, settings, sizeof(settings)), PrefsLog::Result_NoData);
+
+    Prefs a = Make(1);
+    StageAll(log, a);
+    CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+    CHECK_EQ(log.Active(), 0);
+    CHECK_EQ(log.Generation(), 1);
+    CHECK_EQ(log.Sequence(), 5);
+    CHECK_EQ(flash.erases[0], 1);
+    CHECK_EQ(flash.erases[1], 0);
+
+    Prefs b;
+    CHECK(Boot(flash, b));
+    CHECK(!memcmp(&a, &b, sizeof(a)));
+
+    // a different layout version isn't handed back
+    memset(settings, 0x5A, sizeof(settings));
+    CHECK_EQ(log.Read(Type_Settings, 2, settings, sizeof(settings)), PrefsLog::Result_Mismatch);
+    CHECK_EQ(log.Read(Type_Settings, 1, settings, sizeof(settings) - 1), PrefsLog::Result_Mismatch);
+    CHECK_EQ(settings[0], 0x5A);
+    CHECK_EQ(flash.faults, 0);
+}
+
+static void TestAppendOnlyChanges()
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    Prefs a = Make(2);
+    StageAll(log, a);
+    log.Commit();
+
+    // nothing changed, nothing written
+    uint32_t programs = flash.programs;
+    StageAll(log, a);
+    CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+    CHECK_EQ(flash.programs, programs);
+
+    // only the changed group's appended, and nothing's erased
+    uint16_t free = log.Free();
+    a.settings[3] ^= 0xFF;
+    StageAll(log, a);
+    CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+    CHECK_EQ(free - log.Free(), (int)(sizeof(PrefsLog::RecordHeader_t) + sizeof(a.settings)));
+    CHECK(flash.programs - programs <= 2);
+    CHECK_EQ(flash.erases[0] + flash.erases[1], 1);
+
+    Prefs b;
+    CHECK(Boot(flash, b));
+    CHECK(!memcmp(&a, &b, sizeof(a)));
+}
+
+// Lots of saves, as a player fiddling with settings over a long time would
+static void TestWear()
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    Prefs a = Make(3);
+    const uint32_t saves = 5000;
+    uint32_t bytes = 0;
+    for(uint32_t i = 0; i < saves; i++) {
+        a.settings[i % sizeof(a.settings)]++;
+        bytes += sizeof(PrefsLog::RecordHeader_t) + sizeof(a.settings);
+        if(i % 10 == 0) {
+            a.profiles[i % sizeof(a.profiles)]++;
+            bytes += sizeof(PrefsLog::RecordHeader_t) + sizeof(a.profiles);
+        }
+        StageAll(log, a);
+        CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+        if(i % 250 == 0) {
+            Prefs b;
+            CHECK(Boot(flash, b));
+            CHECK(!memcmp(&a, &b, sizeof(a)));
+        }
+    }
+    Prefs b;
+    CHECK(Boot(flash, b));
+    CHECK(!memcmp(&a, &b, sizeof(a)));
+
+    // each sector's erased only when the log moves over to it, and they take turns
+    uint32_t erases = flash.erases[0] + flash.erases[1];
+    printf("%u saves, %u bytes of records: %u + %u erases\n", saves, bytes, flash.erases[0], flash.erases[1]);
+    CHECK(flash.erases[0] - flash.erases[1] + 1 <= 2);
+    // a compaction leaves room for at least (sector - full set) bytes of records before the next one
+    const uint32_t fullSet = sizeof(PrefsLog::SectorHeader_t) + sizeof(PrefsLog::RecordHeader_t) * 5 + sizeof(Prefs);
+    CHECK(erases <= bytes / (PREFS_SECTOR_SIZE - fullSet) + 2);
+    // whereas a fixed layout would've erased once per save
+    CHECK(erases * 5 < saves / 10);
+    CHECK_EQ(flash.faults, 0);
+}
+
+// Sets up a log with `a` saved, and enough saved before it that the next save of two groups does (or doesn't) compact
+static FlashSim Prepare(const Prefs &a, bool full)
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    Prefs p = Make(100);
+    StageAll(log, p);
+    log.Commit();
+    const uint16_t next = sizeof(PrefsLog::RecordHeader_t) * 2 + sizeof(p.settings) + sizeof(p.profiles);
+    const uint16_t all = sizeof(PrefsLog::RecordHeader_t) * 5 + sizeof(Prefs);
+    const uint16_t small = sizeof(PrefsLog::RecordHeader_t) + sizeof(p.settings);
+    // small saves until saving `a` leaves just over (or under) room for the next one
+    while(log.Free() >= all + next + small) {
+        p.settings[0]++;
+        StageAll(log, p);
+        log.Commit();
+    }
+    if(full) {
+        p.settings[0]++;
+        StageAll(log, p);
+        log.Commit();
+    }
+    StageAll(log, a);
+    log.Commit();
+    CHECK_EQ(full, log.Free() < next);
+    return flash;
+}
+
+static bool Is(const Prefs &p, const Prefs &old, const Prefs &neu)
+{
+    return !memcmp(&p, &old, sizeof(p)) || !memcmp(&p, &neu, sizeof(p));
+}
+
+// Cuts the power at every byte of a save that changes two groups
+static void TestPowerCut(bool compacting)
+{
+    const Prefs a = Make(7);
+    Prefs b = a;
+    Fill(b.settings, sizeof(b.settings), 77);
+    Fill(b.profiles, sizeof(b.profiles), 78);
+    Prefs c = Make(9);
+
+    const FlashSim base = Prepare(a, compacting);
+    uint32_t erasesBefore = base.erases[0] + base.erases[1];
+
+    // how much work the save takes uninterrupted
+    FlashSim whole = base;
+    {
+        PrefsLog log(whole);
+        log.Begin();
+        uint32_t work = whole.work;
+        StageAll(log, b);
+        CHECK_EQ(log.Commit(), PrefsLog::Result_Ok);
+        work = whole.work - work;
+        CHECK_EQ(whole.erases[0] + whole.erases[1] - erasesBefore, compacting ? 1 : 0);
+        printf("%s save: %u bytes of work\n", compacting ? "compacting" : "appending", work);
+
+        uint32_t sawOld = 0, sawNew = 0, torn = 0;
+        for(uint32_t cut = 0; cut <= work; cut++) {
+            FlashSim flash = base;
+            {
+                PrefsLog cutLog(flash);
+                cutLog.Begin();
+                flash.CutAfter(cut);
+                StageAll(cutLog, b);
+                cutLog.Commit();
+                flash.Restore();
+            }
+
+            // either copy is fine, as long as it's a whole one; each group's checked by Is() as one struct,
+            // so the two changed groups can't come from different saves
+            Prefs p;
+            if(!Boot(flash, p) || !Is(p, a, b)) {
+                torn++;
+                continue;
+            }
+            sawOld += !memcmp(&p, &a, sizeof(p));
+            sawNew += !memcmp(&p, &b, sizeof(p));
+
+            // and the log carries on from there
+            {
+                PrefsLog log2(flash);
+                log2.Begin();
+                StageAll(log2, c);
+                if(log2.Commit() != PrefsLog::Result_Ok) {
+                    torn++;
+                    continue;
+                }
+            }
+            if(!Boot(flash, p) || memcmp(&p, &c, sizeof(p))) {
+                torn++;
+            }
+        }
+        printf("  cut at every byte: %u old, %u new, %u bad\n", sawOld, sawNew, torn);
+        CHECK_EQ(torn, 0);
+        CHECK(sawOld > 0);
+        CHECK(sawNew > 0);
+    }
+}
+
+// The newest copy of a group going bad falls back to the one before
+static void TestBitRot()
+{
+    FlashSim flash;
+    PrefsLog log(flash);
+    log.Begin();
+    Prefs a = Make(11);
+    StageAll(log, a);
+    log.Commit();
+    Prefs b = a;
+    b.toggles[0] ^= 1;
+    StageAll(log, b);
+    log.Commit();
+
+    // flip a bit in the last record's payload (the toggles, appended last)
+    uint32_t end = log.Active() * PREFS_SECTOR_SIZE + PREFS_SECTOR_SIZE - log.Free();
+    flash.mem[end - 1] &= 0xFE;
+    if(flash.mem[end - 1] == b.toggles[sizeof(b.toggles) - 1]) {
+        flash.mem[end - 1] &= 0xFD;
+    }
+    Prefs p;
+    CHECK(Boot(flash, p));
+    CHECK(!memcmp(&p, &a, sizeof(p)));
+
+    // the next save can't go after the bad record, so it moves to the other sector
+    PrefsLog log2(flash);
+    log2.Begin();
+    StageAll(log2, b);
+    CHECK_EQ(log2.Commit(), PrefsLog::Result_Ok);
+    CHECK_EQ(log2.Active(), 1);
+    CHECK(Boot(flash, p));
+    CHECK(!memcmp(&p, &b, sizeof(p)));
+}
+
+// Where the sketch puts the log: the top 8KB of the filesystem space, which has to be there & clear of the rest
+static void TestPlaced()
+{
+    const uintptr_t flashTop = 0x10200000, eeprom = flashTop - 4096;
+    const uintptr_t log = eeprom - PREFS_LOG_SECTORS * PREFS_SECTOR_SIZE;
+    // a 64KB filesystem space under the EEPROM sector, sketch well below it
+    CHECK(PrefsLog::Placed(log, eeprom - 65536, eeprom, 0x10080000, 0, 0));
+    // "no FS": the space is empty
+    CHECK(!PrefsLog::Placed(eeprom - PREFS_LOG_SECTORS * PREFS_SECTOR_SIZE, eeprom, eeprom, 0x10080000, 0, 0));
+    // a space too small for both sectors
+    CHECK(!PrefsLog::Placed(eeprom - PREFS_LOG_SECTORS * PREFS_SECTOR_SIZE, eeprom - PREFS_SECTOR_SIZE, eeprom,
+                            0x10080000, 0, 0));
+    // the sketch running into it
+    CHECK(!PrefsLog::Placed(log, eeprom - 65536, eeprom, log + 1, 0, 0));
+    CHECK(PrefsLog::Placed(log, eeprom - 65536, eeprom, log, 0, 0));
+    // Bluetooth pairings just under the filesystem space, right at its top, or overlapping by a sector
+    CHECK(PrefsLog::Placed(log, eeprom - 65536, eeprom, 0x10080000, eeprom - 65536 - 8192, eeprom - 65536));
+    CHECK(!PrefsLog::Placed(log, eeprom - 65536, eeprom, 0x10080000, log, log + 8192));
+    CHECK(!PrefsLog::Placed(log, eeprom - 65536, eeprom, 0x10080000, log - 4096, log + 4096));
+    CHECK(PrefsLog::Placed(log, eeprom - 65536, eeprom, 0x10080000, eeprom, flashTop));
+    // not on a sector boundary
+    CHECK(!PrefsLog::Placed(log - 256, eeprom - 65536, eeprom, 0x10080000, 0, 0));
+}
+
+int main()
+{
+    TestPlaced();
+    TestFirstSave();
+    TestAppendOnlyChanges();
+    TestWear();
+    TestPowerCut(false);
+    TestPowerCut(true);
+    TestBitRot();
+    return HOSTTEST_RESULT();
+}
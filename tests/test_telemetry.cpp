@@ -0,0 +1,184 @@
+// Round-trips FrameSample_t records through Telemetry::Send() and the reference decoder,
+// checks it recovers from drops & corruption, and measures what the stream costs.
+#include <Arduino.h>
+#include <chrono>
+#include "HostTest.h"
+#include "OpenFIRETelemetry.h"
+#include "TelemetryDecoder.h"
+
+// camera frame rate in run mode, and what a full-speed CDC bulk endpoint can move at best (19 x 64 byte packets per ms)
+#define CAMERA_HZ 209
+#define CDC_BYTES_PER_SEC (19 * 64 * 1000)
+
+static FrameSample_t MakeFrame(uint32_t n)
+{
+    FrameSample_t f = {};
+    f.timestamp = n * 4785;
+    for(int i = 0; i < 4; i++) {
+        f.rawX[i] = (n * 7 + i * 250) % 1024;
+        f.rawY[i] = (n * 3 + i * 190) % 768;
+        f.cornerX[i] = -200 + (int)(n % 97) * 40 + i;
+        f.cornerY[i] = 3000 - (int)(n % 89) * 30 - i;
+    }
+    f.seen = n & 0x0F;
+    f.layout = n & 1;
+    f.warpX = -150 + (int)(n % 1000);
+    f.warpY = 900 - (int)(n % 800);
+    f.filteredX = f.warpX + 1;
+    f.filteredY = f.warpY - 1;
+    f.timeCam = 600 + n % 50;
+    f.timeSolve = 40 + n % 7;
+    f.timeWarp = 20 + n % 5;
+    f.timeFilter = 5 + n % 3;
+    return f;
+}
+
+static void CheckMatches(const TelemetryRecord_t &r, uint32_t n)
+{
+    FrameSample_t f = MakeFrame(n);
+    CHECK_EQ(r.seq, n);
+    CHECK_EQ(r.timestamp, f.timestamp);
+    for(int i = 0; i < 4; i++) {
+        CHECK_EQ(r.rawX[i], f.rawX[i]);
+        CHECK_EQ(r.rawY[i], f.rawY[i]);
+        CHECK_EQ(r.cornerX[i], f.cornerX[i]);
+        CHECK_EQ(r.cornerY[i], f.cornerY[i]);
+    }
+    CHECK_EQ(r.seen, f.seen);
+    CHECK_EQ(r.layout, f.layout);
+    CHECK_EQ(r.warpX, f.warpX);
+    CHECK_EQ(r.warpY, f.warpY);
+    CHECK_EQ(r.filteredX, f.filteredX);
+    CHECK_EQ(r.filteredY, f.filteredY);
+    CHECK_EQ(r.buttons, (uint16_t)(n * 13));
+    CHECK_EQ(r.timeCam, f.timeCam);
+    CHECK_EQ(r.timeSolve, f.timeSolve);
+    CHECK_EQ(r.timeWarp, f.timeWarp);
+    CHECK_EQ(r.timeFilter, f.timeFilter);
+    CHECK_EQ(r.runMode, n % 3);
+}
+
+static void TestRoundTrip()
+{
+    Telemetry t;
+    t.Reset();
+    Serial.out.clear();
+    Serial.room = 1 << 30;
+    for(uint32_t n = 0; n < 1000; n++) {
+        CHECK(t.Send(MakeFrame(n), n * 13, n % 3));
+    }
+    CHECK_EQ(Serial.out.size(), 1000 * sizeof(TelemetryRecord_t));
+
+    TelemetryDecoder d;
+    uint32_t n = 0;
+    for(uint8_t b : Serial.out) {
+        if(d.Feed(b)) {
+            CheckMatches(d.record, n++);
+        }
+    }
+    CHECK_EQ(d.decoded, 1000);
+    CHECK_EQ(d.missing, 0);
+    CHECK_EQ(d.corrupt, 0);
+    CHECK_EQ(d.skipped, 0);
+}
+
+static void TestDropsShowAsGaps()
+{
+    Telemetry t;
+    t.Reset();
+    Serial.out.clear();
+    for(uint32_t n = 0; n < 100; n++) {
+        // the host stops reading for a while: the buffer's too full for a whole record
+        Serial.room = (n >= 40 && n < 55) ? (int)sizeof(TelemetryRecord_t) - 1 : 4096;
+        t.Send(MakeFrame(n), n * 13, n % 3);
+    }
+    CHECK_EQ(t.dropped, 15);
+    CHECK_EQ(t.seq, 100);
+
+    TelemetryDecoder d;
+    for(uint8_t b : Serial.out) {
+        if(d.Feed(b)) {
+            CheckMatches(d.record, d.record.seq);
+        }
+    }
+    CHECK_EQ(d.decoded, 85);
+    CHECK_EQ(d.missing, t.dropped);
+}
+
+static void TestResync()
+{
+    Telemetry t;
+    t.Reset();
+    Serial.out.clear();
+    Serial.room = 4096;
+    const size_t len = sizeof(TelemetryRecord_t);
+    for(uint32_t n = 0; n < 10; n++) {
+        t.Send(MakeFrame(n), n * 13, n % 3);
+    }
+    std::vector<uint8_t> s = Serial.out;
+    // record 2: a flipped bit in the payload; record 5: cut short by a lost run of bytes;
+    // plus line noise (including a stray sync pair) ahead of record 7
+    s[2 * len + 20] ^= 0x10;
+    std::vector<uint8_t> noisy(s.begin(), s.begin() + 5 * len + 30);
+    noisy.insert(noisy.end(), s.begin() + 6 * len, s.begin() + 7 * len);
+    const uint8_t junk[] = { 0x00, 0xA5, 0x5A, 0x07, 0xA5, 0xFF };
+    noisy.insert(noisy.end(), junk, junk + sizeof(junk));
+    noisy.insert(noisy.end(), s.begin() + 7 * len, s.end());
+
+    TelemetryDecoder d;
+    std::vector<uint32_t> got;
+    for(uint8_t b : noisy) {
+        if(d.Feed(b)) {
+            CheckMatches(d.record, d.record.seq);
+            got.push_back(d.record.seq);
+        }
+    }
+    const std::vector<uint32_t> expect = { 0, 1, 3, 4, 6, 7, 8, 9 };
+    CHECK(got == expect);
+    CHECK_EQ(d.missing, 2);
+    CHECK(d.corrupt >= 1);
+}
+
+static void TestThroughput()
+{
+    const size_t len = sizeof(TelemetryRecord_t);
+    const unsigned int bytesPerSec = len * CAMERA_HZ;
+    printf("record: %zu bytes; %u bytes/s at %u Hz = %.1f%% of full-speed CDC\n",
+           len, bytesPerSec, CAMERA_HZ, bytesPerSec * 100.0 / CDC_BYTES_PER_SEC);
+    // leaves room for the serial command channel & the text output alongside it
+    CHECK(bytesPerSec * 10 < CDC_BYTES_PER_SEC);
+    // the length is sent as one byte
+    CHECK(len < 256);
+
+    Telemetry t;
+    t.Reset();
+    Serial.out.clear();
+    Serial.room = 1 << 30;
+    const uint32_t count = 200000;
+    auto t0 = std::chrono::steady_clock::now();
+    for(uint32_t n = 0; n < count; n++) {
+        t.Send(MakeFrame(n), n * 13, n % 3);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    TelemetryDecoder d;
+    for(uint8_t b : Serial.out) {
+        d.Feed(b);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    CHECK_EQ(d.decoded, count);
+    double sendNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / count;
+    double decodeSec = std::chrono::duration<double>(t2 - t1).count();
+    printf("host: Send() %.0f ns/record; decoder %.1f MB/s (%.0fx the stream)\n",
+           sendNs, Serial.out.size() / decodeSec / 1e6, Serial.out.size() / decodeSec / bytesPerSec);
+    // the App has to keep up with the gun with plenty to spare
+    CHECK(Serial.out.size() / decodeSec > bytesPerSec * 100.0);
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestDropsShowAsGaps();
+    TestResync();
+    TestThroughput();
+    return HOSTTEST_RESULT();
+}